@@ -0,0 +1,223 @@
+/**
+ * @file
+ * @brief Replays a passenger call trace, or generated traffic, against the FSM and a simulated elevator in simulated
+ *        time, and prints passenger and controller KPIs as a JSON report. See simulation.h for how the passengers
+ *        behave.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "simulation.h"
+#include "simulator/sim_elevator.h"
+#include "statistics.h"
+#include "trace.h"
+#include "traffic.h"
+
+#ifndef BENCHMARK_QUEUE_NAME
+#define BENCHMARK_QUEUE_NAME "unknown"
+#endif
+
+/**
+ * @brief Default period of the FSM loop in milliseconds.
+ */
+#define BENCHMARK_DEFAULT_TICK_MS 10
+
+/**
+ * @brief Default number of seconds to keep running after the last call, for the remaining passengers to arrive.
+ */
+#define BENCHMARK_DEFAULT_DRAIN_TIME 600.0
+
+/**
+ * @brief Default number of passengers arriving per minute with generated traffic.
+ */
+#define BENCHMARK_DEFAULT_TRAFFIC_RATE 4.0
+
+/**
+ * @brief Default number of seconds of generated traffic.
+ */
+#define BENCHMARK_DEFAULT_TRAFFIC_DURATION 3600.0
+
+/**
+ * @brief Prints @p summary as a JSON object member.
+ *
+ * @param[in] name Name of the member.
+ * @param[in] summary The summary.
+ */
+static void benchmark_print_summary(const char* name, const StatisticsSummary summary) {
+    printf("  \"%s\": {\"mean\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"max\": %.3f},\n",
+           name,
+           summary.mean,
+           summary.p95,
+           summary.p99,
+           summary.max);
+}
+
+/**
+ * @brief Entry point of the benchmark.
+ *
+ * @param argc Argument count passed to the binary.
+ * @param argv Argument values passed to the binary.
+ *
+ * @return Exit status.
+ */
+int main(const int argc, const char** argv) {
+    const char* trace_path = NULL;
+    const char* write_trace_path = NULL;
+    unsigned int tick_period_ms = BENCHMARK_DEFAULT_TICK_MS;
+    double drain_time = BENCHMARK_DEFAULT_DRAIN_TIME;
+    double travel_time = SIM_ELEVATOR_DEFAULT_TRAVEL_TIME;
+    double start_position = 0.0;
+    unsigned int capacity = 0;
+    int number_of_floors = HARDWARE_DEFAULT_NUMBER_OF_FLOORS;
+
+    const char* traffic_pattern_name = NULL;
+    TrafficPattern traffic_pattern = TRAFFIC_PATTERN_INTER_FLOOR;
+    double traffic_rate_per_minute = BENCHMARK_DEFAULT_TRAFFIC_RATE;
+    double traffic_duration = BENCHMARK_DEFAULT_TRAFFIC_DURATION;
+    double traffic_from_lobby_fraction = -1.0;
+    double traffic_to_lobby_fraction = -1.0;
+    uint64_t traffic_seed = 1;
+
+    bool arguments_are_valid = true;
+
+    for (int i = 1; i < argc && arguments_are_valid; i++) {
+        if (strcmp(argv[i], "--tick-ms") == 0 && i + 1 < argc) {
+            tick_period_ms = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--drain-time") == 0 && i + 1 < argc) {
+            drain_time = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--travel-time") == 0 && i + 1 < argc) {
+            travel_time = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--position") == 0 && i + 1 < argc) {
+            start_position = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--floors") == 0 && i + 1 < argc) {
+            number_of_floors = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--capacity") == 0 && i + 1 < argc) {
+            capacity = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--traffic") == 0 && i + 1 < argc) {
+            traffic_pattern_name = argv[++i];
+            arguments_are_valid = traffic_pattern_from_name(traffic_pattern_name, &traffic_pattern) == 0;
+        } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            traffic_rate_per_minute = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            traffic_duration = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--from-lobby") == 0 && i + 1 < argc) {
+            traffic_from_lobby_fraction = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--to-lobby") == 0 && i + 1 < argc) {
+            traffic_to_lobby_fraction = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            traffic_seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--write-trace") == 0 && i + 1 < argc) {
+            write_trace_path = argv[++i];
+        } else if (!trace_path && argv[i][0] != '-') {
+            trace_path = argv[i];
+        } else {
+            arguments_are_valid = false;
+        }
+    }
+
+    // Either a trace or generated traffic
+    if (!arguments_are_valid || !trace_path == !traffic_pattern_name || tick_period_ms == 0) {
+        fprintf(stderr,
+                "Usage: %s [--tick-ms <period>] [--drain-time <seconds>] [--travel-time <seconds>] [--position <floor>]\n"
+                "          [--floors <floors>] [--capacity <passengers>] [--write-trace <path>] <trace>\n"
+                "       %s [options] --traffic up-peak|inter-floor|down-peak [--rate <passengers per minute>]\n"
+                "          [--duration <seconds>] [--from-lobby <fraction>] [--to-lobby <fraction>] [--seed <seed>]\n",
+                argv[0],
+                argv[0]);
+        return 1;
+    }
+
+    if (number_of_floors < 2 || number_of_floors > HARDWARE_MAX_NUMBER_OF_FLOORS) {
+        fprintf(stderr, "Number of floors must be between 2 and %i\n", HARDWARE_MAX_NUMBER_OF_FLOORS);
+        return 1;
+    }
+
+    Trace trace;
+    TrafficParameters traffic_parameters;
+
+    if (trace_path) {
+        if (trace_load(trace_path, number_of_floors, &trace) != 0) {
+            return 1;
+        }
+    } else {
+        traffic_parameters = traffic_parameters_for_pattern(traffic_pattern,
+                                                            traffic_rate_per_minute,
+                                                            traffic_duration,
+                                                            traffic_seed);
+        if (traffic_from_lobby_fraction >= 0.0) {
+            traffic_parameters.from_lobby_fraction = traffic_from_lobby_fraction;
+        }
+        if (traffic_to_lobby_fraction >= 0.0) {
+            traffic_parameters.to_lobby_fraction = traffic_to_lobby_fraction;
+        }
+
+        traffic_generate(&traffic_parameters, number_of_floors, &trace);
+    }
+
+    if (write_trace_path) {
+        FILE* p_file = fopen(write_trace_path, "w");
+        if (!p_file) {
+            fprintf(stderr, "Unable to write trace %s\n", write_trace_path);
+            trace_free(&trace);
+            return 1;
+        }
+        trace_write(&trace, p_file);
+        fclose(p_file);
+    }
+
+    const SimulationParameters simulation_parameters = {
+        .number_of_floors = number_of_floors,
+        .tick_period_ms = tick_period_ms,
+        .drain_time = drain_time,
+        .travel_time = travel_time,
+        .start_position = start_position,
+        .number_of_cars = 1,
+        .capacity = capacity,
+        .measure_controller_cpu_time = true,
+    };
+
+    SimulationResult result;
+    simulation_run(&simulation_parameters, &trace, &result);
+
+    printf("{\n");
+    if (trace_path) {
+        printf("  \"trace\": \"%s\",\n", trace_path);
+    } else {
+        printf("  \"traffic\": {\"pattern\": \"%s\", \"rate_per_minute\": %.3f, \"duration_s\": %.3f, "
+               "\"from_lobby\": %.3f, \"to_lobby\": %.3f, \"seed\": %llu},\n",
+               traffic_pattern_name,
+               traffic_parameters.rate_per_minute,
+               traffic_parameters.duration,
+               traffic_parameters.from_lobby_fraction,
+               traffic_parameters.to_lobby_fraction,
+               (unsigned long long)traffic_parameters.seed);
+    }
+    printf("  \"queue\": \"%s\",\n", BENCHMARK_QUEUE_NAME);
+    printf("  \"floors\": %i,\n", number_of_floors);
+    printf("  \"tick_ms\": %u,\n", tick_period_ms);
+    printf("  \"capacity\": %u,\n", capacity);
+    printf("  \"passengers\": %zu,\n", trace.number_of_calls);
+    printf("  \"passengers_arrived\": %zu,\n", result.number_of_arrived);
+    printf("  \"simulated_time_s\": %.3f,\n", result.simulated_time);
+    benchmark_print_summary("wait_time_s", statistics_summarize(result.p_wait_times, result.number_of_arrived));
+    benchmark_print_summary("journey_time_s", statistics_summarize(result.p_journey_times, result.number_of_arrived));
+    benchmark_print_summary("stops_per_trip", statistics_summarize(result.p_stops_per_trip, result.number_of_arrived));
+    printf("  \"stops\": %lu,\n", result.number_of_stops);
+    printf("  \"direction_reversals\": %lu,\n", result.number_of_direction_reversals);
+    printf("  \"controller_cpu_per_tick_us\": {\"ticks\": %lu, \"mean\": %.3f, \"max\": %.3f}\n",
+           result.number_of_ticks,
+           result.number_of_ticks > 0 ? result.controller_cpu_time_ns / result.number_of_ticks / 1000.0 : 0.0,
+           result.controller_max_tick_cpu_time_ns / 1000.0);
+    printf("}\n");
+
+    const bool all_arrived = result.number_of_arrived == trace.number_of_calls;
+
+    simulation_result_free(&result);
+    trace_free(&trace);
+
+    return all_arrived ? 0 : 2;
+}
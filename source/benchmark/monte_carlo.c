@@ -0,0 +1,447 @@
+/**
+ * @file
+ * @brief Runs many simulated days of generated traffic against the FSM, spread over all cores, and prints the
+ *        distribution of the KPIs of the days as a JSON report. See simulation.h for how the passengers behave.
+ *
+ * Every day gets its own seed, derived from the seed of the batch and the number of the day, and the KPIs are
+ * aggregated in the order of the days once all have run. The report is therefore the same whatever the number of
+ * threads, and two builds with different queues given the same seed are compared on the very same days.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dispatcher.h"
+#include "simulation.h"
+#include "simulator/sim_elevator.h"
+#include "statistics.h"
+#include "thread_pool.h"
+#include "trace.h"
+#include "traffic.h"
+
+#ifndef BENCHMARK_QUEUE_NAME
+#define BENCHMARK_QUEUE_NAME "unknown"
+#endif
+
+/**
+ * @brief Default period of the FSM loop in milliseconds.
+ */
+#define MONTE_CARLO_DEFAULT_TICK_MS 10
+
+/**
+ * @brief Default number of seconds to keep running after the last call, for the remaining passengers to arrive.
+ */
+#define MONTE_CARLO_DEFAULT_DRAIN_TIME 600.0
+
+/**
+ * @brief Default number of passengers arriving per minute.
+ */
+#define MONTE_CARLO_DEFAULT_TRAFFIC_RATE 4.0
+
+/**
+ * @brief Default number of seconds of traffic per day.
+ */
+#define MONTE_CARLO_DEFAULT_TRAFFIC_DURATION 3600.0
+
+/**
+ * @brief Default number of days.
+ */
+#define MONTE_CARLO_DEFAULT_NUMBER_OF_RUNS 100
+
+/**
+ * @brief The KPIs of a day.
+ */
+typedef enum {
+    MONTE_CARLO_KPI_MEAN_WAIT_TIME,
+    MONTE_CARLO_KPI_P95_WAIT_TIME,
+    MONTE_CARLO_KPI_MEAN_JOURNEY_TIME,
+    MONTE_CARLO_KPI_P95_JOURNEY_TIME,
+    MONTE_CARLO_KPI_MEAN_STOPS_PER_TRIP,
+    MONTE_CARLO_KPI_STOPS,
+    MONTE_CARLO_KPI_DIRECTION_REVERSALS,
+    MONTE_CARLO_KPI_PASSENGERS,
+    MONTE_CARLO_KPI_ARRIVED_FRACTION,
+    MONTE_CARLO_NUMBER_OF_KPIS
+} MonteCarloKpi;
+
+/**
+ * @brief Names of the KPIs in the report, indexed by #MonteCarloKpi.
+ */
+static const char* m_monte_carlo_kpi_names[MONTE_CARLO_NUMBER_OF_KPIS] = {
+    "mean_wait_time_s",
+    "p95_wait_time_s",
+    "mean_journey_time_s",
+    "p95_journey_time_s",
+    "mean_stops_per_trip",
+    "stops",
+    "direction_reversals",
+    "passengers",
+    "arrived_fraction",
+};
+
+/**
+ * @brief The KPIs of one day.
+ */
+typedef struct {
+    double kpis[MONTE_CARLO_NUMBER_OF_KPIS];
+} MonteCarloRun;
+
+/**
+ * @brief The days run by one batch, shared by the tasks of the thread pool.
+ */
+typedef struct {
+    const SimulationParameters* p_simulation_parameters;
+
+    /**
+     * @brief The traffic of every day. The seed is the seed of the batch, each day uses its own seed derived from it.
+     */
+    const TrafficParameters* p_traffic_parameters;
+
+    /**
+     * @brief The KPIs of every day, indexed by the number of the day.
+     */
+    MonteCarloRun* p_runs;
+} MonteCarloBatch;
+
+/**
+ * @brief Derives the seed of a day with the SplitMix64 finalizer, so that the days of neighbouring batch seeds do
+ *        not share traffic.
+ *
+ * @param[in] batch_seed The seed of the batch.
+ * @param[in] run_index The number of the day.
+ *
+ * @return The seed of the day.
+ */
+static uint64_t monte_carlo_run_seed(const uint64_t batch_seed, const size_t run_index) {
+    uint64_t seed = batch_seed + (run_index + 1) * 0x9E3779B97F4A7C15ULL;
+
+    seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+
+    return seed ^ (seed >> 31);
+}
+
+/**
+ * @brief Gets the mean of @p p_samples without reordering them.
+ *
+ * @param[in] p_samples The samples.
+ * @param[in] number_of_samples Number of samples.
+ *
+ * @return The mean, 0 if there are no samples.
+ */
+static double monte_carlo_mean(const double* p_samples, const size_t number_of_samples) {
+    double sum = 0.0;
+    for (size_t i = 0; i < number_of_samples; i++) {
+        sum += p_samples[i];
+    }
+
+    return number_of_samples > 0 ? sum / number_of_samples : 0.0;
+}
+
+/**
+ * @brief Simulates one day of the batch at @p p_context, a task of the thread pool.
+ *
+ * @param[in, out] p_context The batch.
+ * @param[in] task_index The number of the day.
+ */
+static void monte_carlo_run_day(void* p_context, const size_t task_index) {
+    const MonteCarloBatch* p_batch = p_context;
+
+    TrafficParameters traffic_parameters = *p_batch->p_traffic_parameters;
+    traffic_parameters.seed = monte_carlo_run_seed(p_batch->p_traffic_parameters->seed, task_index);
+
+    Trace trace;
+    traffic_generate(&traffic_parameters, p_batch->p_simulation_parameters->number_of_floors, &trace);
+
+    SimulationResult result;
+    simulation_run(p_batch->p_simulation_parameters, &trace, &result);
+
+    double* kpis = p_batch->p_runs[task_index].kpis;
+    kpis[MONTE_CARLO_KPI_MEAN_WAIT_TIME] = monte_carlo_mean(result.p_wait_times, result.number_of_arrived);
+    kpis[MONTE_CARLO_KPI_MEAN_JOURNEY_TIME] = monte_carlo_mean(result.p_journey_times, result.number_of_arrived);
+    kpis[MONTE_CARLO_KPI_MEAN_STOPS_PER_TRIP] = monte_carlo_mean(result.p_stops_per_trip, result.number_of_arrived);
+    kpis[MONTE_CARLO_KPI_P95_WAIT_TIME] = statistics_summarize(result.p_wait_times, result.number_of_arrived).p95;
+    kpis[MONTE_CARLO_KPI_P95_JOURNEY_TIME] = statistics_summarize(result.p_journey_times, result.number_of_arrived).p95;
+    kpis[MONTE_CARLO_KPI_STOPS] = result.number_of_stops;
+    kpis[MONTE_CARLO_KPI_DIRECTION_REVERSALS] = result.number_of_direction_reversals;
+    kpis[MONTE_CARLO_KPI_PASSENGERS] = trace.number_of_calls;
+    kpis[MONTE_CARLO_KPI_ARRIVED_FRACTION] =
+        trace.number_of_calls > 0 ? (double)result.number_of_arrived / trace.number_of_calls : 1.0;
+
+    simulation_result_free(&result);
+    trace_free(&trace);
+}
+
+/**
+ * @brief Gets the wall clock time.
+ *
+ * @return The time in seconds.
+ */
+static double monte_carlo_wall_time() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Runs every day of @p p_batch on @p number_of_threads threads.
+ *
+ * @param[in, out] p_batch The batch.
+ * @param[in] number_of_runs Number of days.
+ * @param[in] number_of_threads Number of threads.
+ * @param[out] p_statistics What the threads did.
+ *
+ * @return Seconds of wall clock time taken.
+ */
+static double monte_carlo_run_batch(MonteCarloBatch* p_batch,
+                                    const size_t number_of_runs,
+                                    const unsigned int number_of_threads,
+                                    ThreadPoolStatistics* p_statistics) {
+    // Cleared first, so that a day which was not run shows up when comparing batches
+    memset(p_batch->p_runs, 0, number_of_runs * sizeof(MonteCarloRun));
+
+    const double start_time = monte_carlo_wall_time();
+    thread_pool_run(number_of_threads, number_of_runs, monte_carlo_run_day, p_batch, p_statistics);
+
+    return monte_carlo_wall_time() - start_time;
+}
+
+/**
+ * @brief Prints the distribution of every KPI over the days in @p p_runs as a JSON object member.
+ *
+ * @param[in] p_runs The days.
+ * @param[in] number_of_runs Number of days.
+ */
+static void monte_carlo_print_kpis(const MonteCarloRun* p_runs, const size_t number_of_runs) {
+    double* p_samples = malloc((number_of_runs + 1) * sizeof(double));
+
+    printf("  \"kpis\": {\n");
+    for (int kpi = 0; kpi < MONTE_CARLO_NUMBER_OF_KPIS; kpi++) {
+        for (size_t run = 0; run < number_of_runs; run++) {
+            p_samples[run] = p_runs[run].kpis[kpi];
+        }
+
+        const StatisticsDistribution distribution = statistics_distribution(p_samples, number_of_runs);
+        printf("    \"%s\": {\"mean\": %.3f, \"stddev\": %.3f, \"ci95\": %.3f, \"p5\": %.3f, \"p50\": %.3f, "
+               "\"p95\": %.3f, \"min\": %.3f, \"max\": %.3f}%s\n",
+               m_monte_carlo_kpi_names[kpi],
+               distribution.mean,
+               distribution.stddev,
+               distribution.ci95,
+               distribution.p5,
+               distribution.p50,
+               distribution.p95,
+               distribution.min,
+               distribution.max,
+               kpi + 1 < MONTE_CARLO_NUMBER_OF_KPIS ? "," : "");
+    }
+    printf("  },\n");
+
+    free(p_samples);
+}
+
+/**
+ * @brief Entry point of the Monte Carlo runner.
+ *
+ * @param argc Argument count passed to the binary.
+ * @param argv Argument values passed to the binary.
+ *
+ * @return Exit status.
+ */
+int main(const int argc, const char** argv) {
+    unsigned int tick_period_ms = MONTE_CARLO_DEFAULT_TICK_MS;
+    double drain_time = MONTE_CARLO_DEFAULT_DRAIN_TIME;
+    double travel_time = SIM_ELEVATOR_DEFAULT_TRAVEL_TIME;
+    unsigned int capacity = 0;
+    int number_of_floors = HARDWARE_DEFAULT_NUMBER_OF_FLOORS;
+    int number_of_cars = 1;
+
+    const char* traffic_pattern_name = "inter-floor";
+    TrafficPattern traffic_pattern = TRAFFIC_PATTERN_INTER_FLOOR;
+    double traffic_rate_per_minute = MONTE_CARLO_DEFAULT_TRAFFIC_RATE;
+    double traffic_duration = MONTE_CARLO_DEFAULT_TRAFFIC_DURATION;
+    double traffic_from_lobby_fraction = -1.0;
+    double traffic_to_lobby_fraction = -1.0;
+    uint64_t seed = 1;
+
+    size_t number_of_runs = MONTE_CARLO_DEFAULT_NUMBER_OF_RUNS;
+    unsigned int number_of_threads = thread_pool_number_of_cores();
+    bool should_measure_scaling = false;
+
+    bool arguments_are_valid = true;
+
+    for (int i = 1; i < argc && arguments_are_valid; i++) {
+        if (strcmp(argv[i], "--tick-ms") == 0 && i + 1 < argc) {
+            tick_period_ms = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--drain-time") == 0 && i + 1 < argc) {
+            drain_time = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--travel-time") == 0 && i + 1 < argc) {
+            travel_time = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--floors") == 0 && i + 1 < argc) {
+            number_of_floors = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--cars") == 0 && i + 1 < argc) {
+            number_of_cars = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--capacity") == 0 && i + 1 < argc) {
+            capacity = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--traffic") == 0 && i + 1 < argc) {
+            traffic_pattern_name = argv[++i];
+            arguments_are_valid = traffic_pattern_from_name(traffic_pattern_name, &traffic_pattern) == 0;
+        } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            traffic_rate_per_minute = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            traffic_duration = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--from-lobby") == 0 && i + 1 < argc) {
+            traffic_from_lobby_fraction = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--to-lobby") == 0 && i + 1 < argc) {
+            traffic_to_lobby_fraction = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            number_of_runs = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            number_of_threads = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--scaling") == 0) {
+            should_measure_scaling = true;
+        } else {
+            arguments_are_valid = false;
+        }
+    }
+
+    if (!arguments_are_valid || tick_period_ms == 0 || number_of_runs == 0 || number_of_threads == 0 ||
+        number_of_threads > THREAD_POOL_MAX_NUMBER_OF_THREADS) {
+        fprintf(stderr,
+                "Usage: %s [--runs <days>] [--threads <threads>] [--scaling] [--seed <seed>]\n"
+                "          [--traffic up-peak|inter-floor|down-peak] [--rate <passengers per minute>]\n"
+                "          [--duration <seconds>] [--from-lobby <fraction>] [--to-lobby <fraction>]\n"
+                "          [--tick-ms <period>] [--drain-time <seconds>] [--travel-time <seconds>]\n"
+                "          [--floors <floors>] [--cars <cars>] [--capacity <passengers>]\n",
+                argv[0]);
+        return 1;
+    }
+
+    if (number_of_floors < 2 || number_of_floors > HARDWARE_MAX_NUMBER_OF_FLOORS) {
+        fprintf(stderr, "Number of floors must be between 2 and %i\n", HARDWARE_MAX_NUMBER_OF_FLOORS);
+        return 1;
+    }
+
+    if (number_of_cars < 1 || number_of_cars > DISPATCHER_MAX_NUMBER_OF_CARS) {
+        fprintf(stderr, "Number of cars must be between 1 and %i\n", DISPATCHER_MAX_NUMBER_OF_CARS);
+        return 1;
+    }
+
+    const SimulationParameters simulation_parameters = {
+        .number_of_floors = number_of_floors,
+        .tick_period_ms = tick_period_ms,
+        .drain_time = drain_time,
+        .travel_time = travel_time,
+        .start_position = 0.0,
+        .number_of_cars = number_of_cars,
+        .capacity = capacity,
+        .measure_controller_cpu_time = false,
+    };
+
+    TrafficParameters traffic_parameters =
+        traffic_parameters_for_pattern(traffic_pattern, traffic_rate_per_minute, traffic_duration, seed);
+    if (traffic_from_lobby_fraction >= 0.0) {
+        traffic_parameters.from_lobby_fraction = traffic_from_lobby_fraction;
+    }
+    if (traffic_to_lobby_fraction >= 0.0) {
+        traffic_parameters.to_lobby_fraction = traffic_to_lobby_fraction;
+    }
+
+    MonteCarloRun* p_runs = calloc(number_of_runs, sizeof(MonteCarloRun));
+    MonteCarloBatch batch = {&simulation_parameters, &traffic_parameters, p_runs};
+
+    // With --scaling the batch is first run on 1, 2, 4, ... threads, each run giving the same days
+    MonteCarloRun* p_reference_runs = NULL;
+    bool is_deterministic = true;
+    double single_thread_wall_time = 0.0;
+
+    printf("{\n");
+    printf("  \"traffic\": {\"pattern\": \"%s\", \"rate_per_minute\": %.3f, \"duration_s\": %.3f, "
+           "\"from_lobby\": %.3f, \"to_lobby\": %.3f, \"seed\": %llu},\n",
+           traffic_pattern_name,
+           traffic_parameters.rate_per_minute,
+           traffic_parameters.duration,
+           traffic_parameters.from_lobby_fraction,
+           traffic_parameters.to_lobby_fraction,
+           (unsigned long long)traffic_parameters.seed);
+    printf("  \"queue\": \"%s\",\n", BENCHMARK_QUEUE_NAME);
+    printf("  \"floors\": %i,\n", number_of_floors);
+    printf("  \"cars\": %i,\n", number_of_cars);
+    printf("  \"tick_ms\": %u,\n", tick_period_ms);
+    printf("  \"capacity\": %u,\n", capacity);
+    printf("  \"runs\": %zu,\n", number_of_runs);
+
+    if (should_measure_scaling) {
+        printf("  \"scaling\": [\n");
+
+        for (unsigned int threads = 1; threads < number_of_threads; threads *= 2) {
+            ThreadPoolStatistics statistics;
+            const double wall_time = monte_carlo_run_batch(&batch, number_of_runs, threads, &statistics);
+
+            if (threads == 1) {
+                single_thread_wall_time = wall_time;
+                p_reference_runs = malloc(number_of_runs * sizeof(MonteCarloRun));
+                memcpy(p_reference_runs, p_runs, number_of_runs * sizeof(MonteCarloRun));
+            } else {
+                is_deterministic &= memcmp(p_reference_runs, p_runs, number_of_runs * sizeof(MonteCarloRun)) == 0;
+            }
+
+            printf("    {\"threads\": %u, \"wall_time_s\": %.3f, \"runs_per_s\": %.3f, \"speedup\": %.3f, "
+                   "\"efficiency\": %.3f, \"steals\": %lu},\n",
+                   threads,
+                   wall_time,
+                   number_of_runs / wall_time,
+                   single_thread_wall_time / wall_time,
+                   single_thread_wall_time / wall_time / threads,
+                   statistics.number_of_steals);
+        }
+    }
+
+    ThreadPoolStatistics statistics;
+    const double wall_time = monte_carlo_run_batch(&batch, number_of_runs, number_of_threads, &statistics);
+
+    if (should_measure_scaling) {
+        if (p_reference_runs) {
+            is_deterministic &= memcmp(p_reference_runs, p_runs, number_of_runs * sizeof(MonteCarloRun)) == 0;
+        } else {
+            single_thread_wall_time = wall_time;
+        }
+
+        printf("    {\"threads\": %u, \"wall_time_s\": %.3f, \"runs_per_s\": %.3f, \"speedup\": %.3f, "
+               "\"efficiency\": %.3f, \"steals\": %lu}\n",
+               number_of_threads,
+               wall_time,
+               number_of_runs / wall_time,
+               single_thread_wall_time / wall_time,
+               single_thread_wall_time / wall_time / number_of_threads,
+               statistics.number_of_steals);
+        printf("  ],\n");
+        printf("  \"deterministic\": %s,\n", is_deterministic ? "true" : "false");
+    }
+
+    monte_carlo_print_kpis(p_runs, number_of_runs);
+
+    printf("  \"throughput\": {\"threads\": %u, \"wall_time_s\": %.3f, \"runs_per_s\": %.3f, "
+           "\"simulated_hours_per_s\": %.3f, \"steals\": %lu, \"min_runs_per_thread\": %zu, "
+           "\"max_runs_per_thread\": %zu}\n",
+           number_of_threads,
+           wall_time,
+           number_of_runs / wall_time,
+           number_of_runs * traffic_parameters.duration / 3600.0 / wall_time,
+           statistics.number_of_steals,
+           statistics.min_tasks_per_thread,
+           statistics.max_tasks_per_thread);
+    printf("}\n");
+
+    free(p_reference_runs);
+    free(p_runs);
+
+    return is_deterministic ? 0 : 2;
+}
@@ -0,0 +1,267 @@
+/**
+ * @file
+ * @brief Replays a recording made with @c ./elevator @c --record against the FSM, with no hardware and as fast as the
+ *        CPU allows. Checks that the FSM issues the recorded commands again, and prints how long the steps took as a
+ *        JSON report. Exits with 1 at the first command which differs from the recording.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "fsm.h"
+#include "hardware_backend.h"
+#include "recording.h"
+
+#ifndef BENCHMARK_QUEUE_NAME
+#define BENCHMARK_QUEUE_NAME "unknown"
+#endif
+
+/**
+ * @brief Checks the commands of the FSM against a recording.
+ */
+typedef struct {
+    const Recording* p_recording;
+
+    /**
+     * @brief Index of the next command expected.
+     */
+    size_t next_command;
+
+    /**
+     * @brief Index of the first command after the commands of the current step.
+     */
+    size_t end_command;
+
+    /**
+     * @brief Index of the current step, the number of steps during #fsm_deinit.
+     */
+    size_t step;
+
+    /**
+     * @brief Whether a command differed from the recording.
+     */
+    bool has_mismatch;
+} ReplayChecker;
+
+/**
+ * @brief Checks a command of the FSM against the next command of the recording, and reports the first difference.
+ *
+ * @param[in, out] p_checker The checker.
+ * @param[in] p_command The command of the FSM, NULL if the FSM issued no more commands in the step.
+ */
+static void replay_check_command(ReplayChecker* p_checker, const RecordingCommand* p_command) {
+    const RecordingCommand* p_expected = p_checker->next_command < p_checker->end_command
+                                             ? &p_checker->p_recording->p_commands[p_checker->next_command]
+                                             : NULL;
+    if (!p_command && !p_expected) {
+        return;
+    }
+
+    if (p_command && p_expected && p_command->type == p_expected->type &&
+        p_command->order_type == p_expected->order_type && p_command->value == p_expected->value &&
+        p_command->floor == p_expected->floor) {
+        p_checker->next_command++;
+        return;
+    }
+
+    if (!p_checker->has_mismatch) {
+        const RecordingStep* p_steps = p_checker->p_recording->p_steps;
+        if (p_checker->step < p_checker->p_recording->number_of_steps) {
+            fprintf(stderr,
+                    "Step %zu at %llu ms: expected ",
+                    p_checker->step,
+                    (unsigned long long)p_steps[p_checker->step].now_ms);
+        } else {
+            fprintf(stderr, "Deinit: expected ");
+        }
+
+        if (p_expected) {
+            recording_print_command(p_expected, stderr);
+        } else {
+            fprintf(stderr, "no command");
+        }
+        fprintf(stderr, ", got ");
+        if (p_command) {
+            recording_print_command(p_command, stderr);
+        } else {
+            fprintf(stderr, "no command");
+        }
+        fprintf(stderr, "\n");
+    }
+
+    p_checker->has_mismatch = true;
+}
+
+static void replay_command_movement(void* p_context, const HardwareMovement movement) {
+    const RecordingCommand command = {.type = RECORDING_COMMAND_MOVEMENT, .value = (uint8_t)movement};
+    replay_check_command(p_context, &command);
+}
+
+static void replay_command_order_light(void* p_context,
+                                       const int floor,
+                                       const HardwareOrder order_type,
+                                       const bool on) {
+    const RecordingCommand command = {
+        .type = RECORDING_COMMAND_ORDER_LIGHT,
+        .order_type = (uint8_t)order_type,
+        .value = on,
+        .floor = floor,
+    };
+    replay_check_command(p_context, &command);
+}
+
+static void replay_command_floor_indicator_on(void* p_context, const int floor) {
+    const RecordingCommand command = {.type = RECORDING_COMMAND_FLOOR_INDICATOR_ON, .floor = floor};
+    replay_check_command(p_context, &command);
+}
+
+static void replay_command_door_open(void* p_context, const bool door_open) {
+    const RecordingCommand command = {.type = RECORDING_COMMAND_DOOR_OPEN, .value = door_open};
+    replay_check_command(p_context, &command);
+}
+
+static void replay_command_stop_light(void* p_context, const bool on) {
+    const RecordingCommand command = {.type = RECORDING_COMMAND_STOP_LIGHT, .value = on};
+    replay_check_command(p_context, &command);
+}
+
+/**
+ * @brief The commands of the replay backend, checked against the recording.
+ */
+static const HardwareBackendOperations m_replay_operations = {
+    .command_movement = replay_command_movement,
+    .command_order_light = replay_command_order_light,
+    .command_floor_indicator_on = replay_command_floor_indicator_on,
+    .command_door_open = replay_command_door_open,
+    .command_stop_light = replay_command_stop_light,
+};
+
+/**
+ * @brief Gets the current wall time.
+ *
+ * @return Seconds on the monotonic clock.
+ */
+static double replay_wall_time() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Steps a fresh elevator through @p p_recording, checking its commands, until the end or the first difference.
+ *
+ * @param[in] p_recording The recording.
+ *
+ * @return true if every command matched the recording.
+ */
+static bool replay_run(const Recording* p_recording) {
+    ReplayChecker checker = {.p_recording = p_recording};
+    const HardwareBackend hardware = {
+        .p_operations = &m_replay_operations,
+        .p_context = &checker,
+        .number_of_floors = p_recording->number_of_floors,
+    };
+
+    Elevator elevator;
+    fsm_init(&elevator, &hardware);
+
+    for (size_t step = 0; step < p_recording->number_of_steps && !checker.has_mismatch; step++) {
+        const RecordingStep* p_step = &p_recording->p_steps[step];
+
+        checker.step = step;
+        checker.end_command = step + 1 < p_recording->number_of_steps ? p_recording->p_steps[step + 1].first_command
+                                                                      : p_recording->first_deinit_command;
+
+        fsm_step(&elevator, &p_step->inputs, p_step->now_ms);
+        replay_check_command(&checker, NULL);
+    }
+
+    if (p_recording->has_deinit && !checker.has_mismatch) {
+        checker.step = p_recording->number_of_steps;
+        checker.end_command = p_recording->number_of_commands;
+
+        fsm_deinit(&elevator);
+        replay_check_command(&checker, NULL);
+    } else {
+        // A recording cut short has no commands of fsm_deinit to compare with, so only the queue is released
+        elevator.p_priority_queue = priority_queue_clear(elevator.p_priority_queue);
+    }
+
+    return !checker.has_mismatch;
+}
+
+/**
+ * @brief Entry point of the replay.
+ *
+ * @param argc Argument count passed to the binary.
+ * @param argv Argument values passed to the binary.
+ *
+ * @return Exit status.
+ */
+int main(const int argc, const char** argv) {
+    const char* recording_path = NULL;
+    unsigned int number_of_repeats = 1;
+
+    bool arguments_are_valid = true;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            number_of_repeats = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (argv[i][0] != '-' && !recording_path) {
+            recording_path = argv[i];
+        } else {
+            arguments_are_valid = false;
+        }
+    }
+
+    if (!arguments_are_valid || !recording_path || number_of_repeats == 0) {
+        fprintf(stderr, "Usage: %s <recording> [--repeat <times>]\n", argv[0]);
+        return 1;
+    }
+
+    Recording recording;
+    if (recording_load(recording_path, &recording) != 0) {
+        return 1;
+    }
+
+    bool commands_match = true;
+    unsigned int number_of_runs = 0;
+    double best_time = 0.0;
+    double total_time = 0.0;
+
+    for (; number_of_runs < number_of_repeats && commands_match; number_of_runs++) {
+        const double start_time = replay_wall_time();
+        commands_match = replay_run(&recording);
+        const double time = replay_wall_time() - start_time;
+
+        total_time += time;
+        if (number_of_runs == 0 || time < best_time) {
+            best_time = time;
+        }
+    }
+
+    const double number_of_steps = (double)recording.number_of_steps;
+
+    printf("{\n");
+    printf("  \"recording\": \"%s\",\n", recording_path);
+    printf("  \"queue\": \"%s\",\n", BENCHMARK_QUEUE_NAME);
+    printf("  \"floors\": %i,\n", recording.number_of_floors);
+    printf("  \"steps\": %zu,\n", recording.number_of_steps);
+    printf("  \"commands\": %zu,\n", recording.number_of_commands);
+    printf("  \"complete\": %s,\n", recording.has_deinit ? "true" : "false");
+    printf("  \"commands_match\": %s,\n", commands_match ? "true" : "false");
+    printf("  \"repeats\": %u,\n", number_of_runs);
+    printf("  \"best_time_s\": %.6f,\n", best_time);
+    printf("  \"mean_time_s\": %.6f,\n", total_time / number_of_runs);
+    printf("  \"ns_per_step\": %.1f,\n", number_of_steps > 0 ? best_time * 1e9 / number_of_steps : 0.0);
+    printf("  \"steps_per_s\": %.0f\n", best_time > 0.0 ? number_of_steps / best_time : 0.0);
+    printf("}\n");
+
+    recording_free(&recording);
+
+    return commands_match ? 0 : 1;
+}
@@ -0,0 +1,312 @@
+/**
+ * @file
+ * @brief Implementation of the simulation.
+ */
+
+#include "simulation.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "door.h"
+#include "fsm.h"
+#include "group.h"
+#include "simulator/sim_elevator.h"
+
+/**
+ * @brief The states a passenger goes through.
+ */
+typedef enum { PASSENGER_STATE_WAITING, PASSENGER_STATE_RIDING, PASSENGER_STATE_ARRIVED } PassengerState;
+
+/**
+ * @brief A passenger of the trace.
+ */
+typedef struct {
+    const TraceCall* p_call;
+    PassengerState state;
+
+    /**
+     * @brief The car the passenger boarded.
+     */
+    int car;
+
+    /**
+     * @brief Seconds from the start of the trace when the passenger boarded.
+     */
+    double board_time;
+
+    /**
+     * @brief Seconds from the start of the trace when the passenger arrived at their destination.
+     */
+    double arrival_time;
+
+    /**
+     * @brief Number of stops their car had made when the passenger boarded.
+     */
+    unsigned long stops_when_boarded;
+
+    /**
+     * @brief Number of stops their car had made when the passenger arrived.
+     */
+    unsigned long stops_when_arrived;
+} Passenger;
+
+/**
+ * @brief Presses the button of @p order_type at @p floor again if the passenger is waiting for it, but its light is
+ *        off and it is not already pressed.
+ *
+ * @param[in, out] p_elevator The elevator.
+ * @param[in] floor Floor of the button.
+ * @param[in] order_type Type of the button.
+ */
+static void simulation_press_if_unlit(SimElevator* p_elevator, const int floor, const HardwareOrder order_type) {
+    if (!p_elevator->order_lights[floor][order_type] && !sim_elevator_button_is_pressed(p_elevator, floor, order_type)) {
+        sim_elevator_press_button(p_elevator, floor, order_type);
+    }
+}
+
+/**
+ * @brief Moves @p p_passenger along when the door of a car is open at their floor, and presses their button again if
+ *        needed. The hall buttons are shared by the cars, so a passenger waiting for a car presses the hall button on
+ *        the panel of the first car.
+ *
+ * @param[in, out] p_passenger The passenger.
+ * @param[in, out] p_elevators The cars.
+ * @param[in] number_of_cars Number of cars.
+ * @param[in] time Seconds from the start of the trace.
+ * @param[in] p_number_of_stops Number of stops each car has made.
+ * @param[in] capacity Maximum number of passengers in a car, 0 for no limit.
+ * @param[in, out] p_number_of_riders Number of passengers in each car.
+ */
+static void simulation_update_passenger(Passenger* p_passenger,
+                                        SimElevator* p_elevators,
+                                        const int number_of_cars,
+                                        const double time,
+                                        const unsigned long* p_number_of_stops,
+                                        const unsigned int capacity,
+                                        unsigned int* p_number_of_riders) {
+    const TraceCall* p_call = p_passenger->p_call;
+
+    switch (p_passenger->state) {
+        case PASSENGER_STATE_WAITING: {
+            bool is_car_at_floor = false;
+            for (int car = 0; car < number_of_cars; car++) {
+                SimElevator* p_elevator = &p_elevators[car];
+                const int floor = sim_elevator_floor_sensor(p_elevator);
+
+                if (floor == p_call->floor && p_elevator->door_open &&
+                    (capacity == 0 || p_number_of_riders[car] < capacity)) {
+                    p_number_of_riders[car]++;
+                    p_passenger->state = PASSENGER_STATE_RIDING;
+                    p_passenger->car = car;
+                    p_passenger->board_time = time;
+                    p_passenger->stops_when_boarded = p_number_of_stops[car];
+                    sim_elevator_press_button(p_elevator, p_call->destination, HARDWARE_ORDER_INSIDE);
+                    return;
+                }
+                is_car_at_floor = is_car_at_floor || floor == p_call->floor;
+            }
+
+            if (!is_car_at_floor) {
+                // Left behind by a full car, call again once it has left
+                simulation_press_if_unlit(&p_elevators[0], p_call->floor, p_call->direction);
+            }
+            break;
+        }
+
+        case PASSENGER_STATE_RIDING: {
+            SimElevator* p_elevator = &p_elevators[p_passenger->car];
+
+            if (p_elevator->door_open && sim_elevator_floor_sensor(p_elevator) == p_call->destination) {
+                p_number_of_riders[p_passenger->car]--;
+                p_passenger->state = PASSENGER_STATE_ARRIVED;
+                p_passenger->arrival_time = time;
+                p_passenger->stops_when_arrived = p_number_of_stops[p_passenger->car];
+            } else {
+                simulation_press_if_unlit(p_elevator, p_call->destination, HARDWARE_ORDER_INSIDE);
+            }
+            break;
+        }
+
+        case PASSENGER_STATE_ARRIVED:
+            break;
+    }
+}
+
+/**
+ * @brief Gets the CPU time used by the calling thread.
+ *
+ * @return CPU time in nanoseconds.
+ */
+static double simulation_thread_cpu_time_ns() {
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+
+    return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+}
+
+void simulation_run(const SimulationParameters* p_parameters, const Trace* p_trace, SimulationResult* p_result) {
+    const unsigned int tick_period_ms = p_parameters->tick_period_ms;
+    const unsigned int capacity = p_parameters->capacity;
+
+    Passenger* p_passengers = calloc(p_trace->number_of_calls, sizeof(Passenger));
+    for (size_t i = 0; i < p_trace->number_of_calls; i++) {
+        p_passengers[i].p_call = &p_trace->p_calls[i];
+    }
+
+    const int number_of_cars = p_parameters->number_of_cars;
+    SimElevator sim_elevators[DISPATCHER_MAX_NUMBER_OF_CARS];
+    HardwareBackend hardware[DISPATCHER_MAX_NUMBER_OF_CARS];
+    for (int car = 0; car < number_of_cars; car++) {
+        sim_elevator_init(&sim_elevators[car], p_parameters->number_of_floors, p_parameters->start_position);
+        sim_elevators[car].travel_time = p_parameters->travel_time;
+        hardware[car] = sim_elevator_backend(&sim_elevators[car]);
+    }
+
+    // One car is driven by its FSM alone, several by a group sharing the hall calls between them
+    Elevator elevator;
+    Group* p_group = NULL;
+    if (number_of_cars == 1) {
+        fsm_init(&elevator, &hardware[0]);
+    } else {
+        p_group = malloc(sizeof(Group));
+        group_init(p_group, hardware, number_of_cars, p_parameters->travel_time, DOOR_OPEN_TIME_INTERVAL);
+    }
+
+    const double end_of_calls =
+        p_trace->number_of_calls > 0 ? p_trace->p_calls[p_trace->number_of_calls - 1].time : 0.0;
+    const double tick_period = tick_period_ms / 1000.0;
+
+    // Passengers who have called but not arrived, so each tick only visits those
+    Passenger** pp_active_passengers = malloc((p_trace->number_of_calls + 1) * sizeof(Passenger*));
+    size_t number_of_active_passengers = 0;
+
+    size_t number_of_called = 0;
+    size_t number_of_arrived = 0;
+    unsigned int number_of_riders[DISPATCHER_MAX_NUMBER_OF_CARS] = {0};
+    unsigned long number_of_ticks = 0;
+    unsigned long number_of_stops[DISPATCHER_MAX_NUMBER_OF_CARS] = {0};
+    unsigned long number_of_reversals = 0;
+    bool door_was_open[DISPATCHER_MAX_NUMBER_OF_CARS] = {false};
+    HardwareMovement last_direction[DISPATCHER_MAX_NUMBER_OF_CARS] = {HARDWARE_MOVEMENT_STOP};
+    double controller_cpu_time_ns = 0.0;
+    double controller_max_tick_cpu_time_ns = 0.0;
+    double time = 0.0;
+
+    while (number_of_arrived < p_trace->number_of_calls && time <= end_of_calls + p_parameters->drain_time) {
+        time = number_of_ticks * tick_period;
+
+        while (number_of_called < p_trace->number_of_calls && p_trace->p_calls[number_of_called].time <= time) {
+            pp_active_passengers[number_of_active_passengers++] = &p_passengers[number_of_called];
+
+            const TraceCall* p_call = &p_trace->p_calls[number_of_called++];
+            sim_elevator_press_button(&sim_elevators[0], p_call->floor, p_call->direction);
+        }
+
+        const double cpu_time_before_ns =
+            p_parameters->measure_controller_cpu_time ? simulation_thread_cpu_time_ns() : 0.0;
+        HardwareSnapshot snapshots[DISPATCHER_MAX_NUMBER_OF_CARS];
+        for (int car = 0; car < number_of_cars; car++) {
+            sim_elevator_read_snapshot(&sim_elevators[car], &snapshots[car]);
+        }
+        if (p_group) {
+            group_step(p_group, snapshots, (uint64_t)number_of_ticks * tick_period_ms);
+        } else {
+            fsm_step(&elevator, &snapshots[0], (uint64_t)number_of_ticks * tick_period_ms);
+        }
+
+        if (p_parameters->measure_controller_cpu_time) {
+            const double tick_cpu_time_ns = simulation_thread_cpu_time_ns() - cpu_time_before_ns;
+
+            controller_cpu_time_ns += tick_cpu_time_ns;
+            if (tick_cpu_time_ns > controller_max_tick_cpu_time_ns) {
+                controller_max_tick_cpu_time_ns = tick_cpu_time_ns;
+            }
+        }
+
+        for (int car = 0; car < number_of_cars; car++) {
+            const SimElevator* p_elevator = &sim_elevators[car];
+
+            if (p_elevator->door_open && !door_was_open[car]) {
+                number_of_stops[car]++;
+            }
+            door_was_open[car] = p_elevator->door_open;
+
+            if (p_elevator->movement != HARDWARE_MOVEMENT_STOP) {
+                if (last_direction[car] != HARDWARE_MOVEMENT_STOP && p_elevator->movement != last_direction[car]) {
+                    number_of_reversals++;
+                }
+                last_direction[car] = p_elevator->movement;
+            }
+        }
+
+        for (size_t i = 0; i < number_of_active_passengers;) {
+            simulation_update_passenger(pp_active_passengers[i],
+                                        sim_elevators,
+                                        number_of_cars,
+                                        time,
+                                        number_of_stops,
+                                        capacity,
+                                        number_of_riders);
+
+            if (pp_active_passengers[i]->state == PASSENGER_STATE_ARRIVED) {
+                pp_active_passengers[i] = pp_active_passengers[--number_of_active_passengers];
+                number_of_arrived++;
+            } else {
+                i++;
+            }
+        }
+
+        for (int car = 0; car < number_of_cars; car++) {
+            sim_elevator_step(&sim_elevators[car], tick_period);
+        }
+        number_of_ticks++;
+    }
+
+    if (p_group) {
+        group_deinit(p_group);
+        free(p_group);
+    } else {
+        fsm_deinit(&elevator);
+    }
+    free(pp_active_passengers);
+
+    p_result->p_wait_times = malloc((number_of_arrived + 1) * sizeof(double));
+    p_result->p_journey_times = malloc((number_of_arrived + 1) * sizeof(double));
+    p_result->p_stops_per_trip = malloc((number_of_arrived + 1) * sizeof(double));
+    p_result->number_of_arrived = 0;
+
+    for (size_t i = 0; i < p_trace->number_of_calls; i++) {
+        const Passenger* p_passenger = &p_passengers[i];
+        if (p_passenger->state == PASSENGER_STATE_ARRIVED) {
+            const size_t sample = p_result->number_of_arrived++;
+
+            p_result->p_wait_times[sample] = p_passenger->board_time - p_passenger->p_call->time;
+            p_result->p_journey_times[sample] = p_passenger->arrival_time - p_passenger->p_call->time;
+            p_result->p_stops_per_trip[sample] = p_passenger->stops_when_arrived - p_passenger->stops_when_boarded;
+        }
+    }
+
+    p_result->simulated_time = time;
+    p_result->number_of_ticks = number_of_ticks;
+    p_result->number_of_stops = 0;
+    for (int car = 0; car < number_of_cars; car++) {
+        p_result->number_of_stops += number_of_stops[car];
+    }
+    p_result->number_of_direction_reversals = number_of_reversals;
+    p_result->controller_cpu_time_ns = controller_cpu_time_ns;
+    p_result->controller_max_tick_cpu_time_ns = controller_max_tick_cpu_time_ns;
+
+    free(p_passengers);
+}
+
+void simulation_result_free(SimulationResult* p_result) {
+    free(p_result->p_wait_times);
+    free(p_result->p_journey_times);
+    free(p_result->p_stops_per_trip);
+
+    p_result->p_wait_times = NULL;
+    p_result->p_journey_times = NULL;
+    p_result->p_stops_per_trip = NULL;
+}
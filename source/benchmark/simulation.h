@@ -0,0 +1,134 @@
+/**
+ * @file
+ * @brief Runs the FSM of one elevator, or a #Group of several, against simulated cars and the passengers of a trace,
+ *        and collects their KPIs. A simulation only touches its own state, so several can run at once on different
+ *        threads.
+ *
+ * Passengers press their hall button at the time of their call and board the first car whose door opens at their
+ * floor with room in the car, where they press their destination in the cab. They leave the first time the door of
+ * their car opens at their destination. A passenger presses their button again if its light is off while they are
+ * still waiting for it, e.g. because it was pressed while the elevator was starting up.
+ */
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "trace.h"
+
+/**
+ * @brief Settings of a simulation.
+ */
+typedef struct {
+    /**
+     * @brief Number of floors of the building.
+     */
+    int number_of_floors;
+
+    /**
+     * @brief Period of the FSM loop in milliseconds.
+     */
+    unsigned int tick_period_ms;
+
+    /**
+     * @brief Seconds to keep running after the last call, for the remaining passengers to arrive.
+     */
+    double drain_time;
+
+    /**
+     * @brief Seconds the car takes to travel from one floor to the next.
+     */
+    double travel_time;
+
+    /**
+     * @brief Start position of every car in floors.
+     */
+    double start_position;
+
+    /**
+     * @brief Number of cars, from 1 to #DISPATCHER_MAX_NUMBER_OF_CARS. Several cars are run as a #Group.
+     */
+    int number_of_cars;
+
+    /**
+     * @brief Maximum number of passengers in each car, 0 for no limit.
+     */
+    unsigned int capacity;
+
+    /**
+     * @brief Whether to measure the CPU time of the controller. Costs two system calls per tick.
+     */
+    bool measure_controller_cpu_time;
+} SimulationParameters;
+
+/**
+ * @brief What happened in a simulation.
+ */
+typedef struct {
+    /**
+     * @brief Number of passengers who arrived at their destination.
+     */
+    size_t number_of_arrived;
+
+    /**
+     * @brief Seconds from their call until they boarded, for every passenger who arrived.
+     */
+    double* p_wait_times;
+
+    /**
+     * @brief Seconds from their call until they arrived, for every passenger who arrived.
+     */
+    double* p_journey_times;
+
+    /**
+     * @brief Number of stops made while they rode, for every passenger who arrived.
+     */
+    double* p_stops_per_trip;
+
+    /**
+     * @brief Seconds simulated.
+     */
+    double simulated_time;
+
+    unsigned long number_of_ticks;
+
+    /**
+     * @brief Number of stops made by all the cars.
+     */
+    unsigned long number_of_stops;
+
+    /**
+     * @brief Number of direction reversals made by all the cars.
+     */
+    unsigned long number_of_direction_reversals;
+
+    /**
+     * @brief CPU time spent in the controller, 0 unless measured.
+     */
+    double controller_cpu_time_ns;
+
+    /**
+     * @brief The most CPU time spent in the controller in one tick, 0 unless measured.
+     */
+    double controller_max_tick_cpu_time_ns;
+} SimulationResult;
+
+/**
+ * @brief Runs @p p_trace until every passenger has arrived, or until @c drain_time has passed since the last call.
+ *
+ * @param[in] p_parameters Settings of the simulation.
+ * @param[in] p_trace The calls of the passengers. Their floors must be within @c number_of_floors.
+ * @param[out] p_result What happened, to be released with #simulation_result_free.
+ */
+void simulation_run(const SimulationParameters* p_parameters, const Trace* p_trace, SimulationResult* p_result);
+
+/**
+ * @brief Releases the samples of @p p_result.
+ *
+ * @param[in, out] p_result The result.
+ */
+void simulation_result_free(SimulationResult* p_result);
+
+#endif
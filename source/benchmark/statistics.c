@@ -0,0 +1,101 @@
+/**
+ * @file
+ * @brief Implementation of the sample summaries.
+ */
+
+#include "statistics.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+/**
+ * @brief Comparison of doubles for qsort.
+ *
+ * @param[in] p_first The first double.
+ * @param[in] p_second The second double.
+ *
+ * @return Negative, zero or positive like strcmp.
+ */
+static int statistics_compare_doubles(const void* p_first, const void* p_second) {
+    const double first = *(const double*)p_first;
+    const double second = *(const double*)p_second;
+
+    return (first > second) - (first < second);
+}
+
+/**
+ * @brief Gets the nearest rank percentile of sorted samples.
+ *
+ * @param[in] p_sorted_samples The samples, sorted in increasing order.
+ * @param[in] number_of_samples Number of samples, at least one.
+ * @param[in] fraction The percentile as a fraction, in (0, 1].
+ *
+ * @return The percentile.
+ */
+static double statistics_percentile(const double* p_sorted_samples,
+                                    const size_t number_of_samples,
+                                    const double fraction) {
+    return p_sorted_samples[(size_t)ceil(fraction * number_of_samples) - 1];
+}
+
+/**
+ * @brief Gets the mean of samples.
+ *
+ * @param[in] p_samples The samples.
+ * @param[in] number_of_samples Number of samples, at least one.
+ *
+ * @return The mean.
+ */
+static double statistics_mean(const double* p_samples, const size_t number_of_samples) {
+    double sum = 0.0;
+    for (size_t i = 0; i < number_of_samples; i++) {
+        sum += p_samples[i];
+    }
+
+    return sum / number_of_samples;
+}
+
+StatisticsSummary statistics_summarize(double* p_samples, const size_t number_of_samples) {
+    StatisticsSummary summary = {0};
+    if (number_of_samples == 0) {
+        return summary;
+    }
+
+    qsort(p_samples, number_of_samples, sizeof(double), statistics_compare_doubles);
+
+    summary.mean = statistics_mean(p_samples, number_of_samples);
+    summary.p95 = statistics_percentile(p_samples, number_of_samples, 0.95);
+    summary.p99 = statistics_percentile(p_samples, number_of_samples, 0.99);
+    summary.max = p_samples[number_of_samples - 1];
+
+    return summary;
+}
+
+StatisticsDistribution statistics_distribution(double* p_samples, const size_t number_of_samples) {
+    StatisticsDistribution distribution = {0};
+    if (number_of_samples == 0) {
+        return distribution;
+    }
+
+    qsort(p_samples, number_of_samples, sizeof(double), statistics_compare_doubles);
+
+    distribution.mean = statistics_mean(p_samples, number_of_samples);
+
+    if (number_of_samples > 1) {
+        double sum_of_squares = 0.0;
+        for (size_t i = 0; i < number_of_samples; i++) {
+            sum_of_squares += (p_samples[i] - distribution.mean) * (p_samples[i] - distribution.mean);
+        }
+
+        distribution.stddev = sqrt(sum_of_squares / (number_of_samples - 1));
+        distribution.ci95 = 1.96 * distribution.stddev / sqrt((double)number_of_samples);
+    }
+
+    distribution.p5 = statistics_percentile(p_samples, number_of_samples, 0.05);
+    distribution.p50 = statistics_percentile(p_samples, number_of_samples, 0.50);
+    distribution.p95 = statistics_percentile(p_samples, number_of_samples, 0.95);
+    distribution.min = p_samples[0];
+    distribution.max = p_samples[number_of_samples - 1];
+
+    return distribution;
+}
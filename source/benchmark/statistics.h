@@ -0,0 +1,64 @@
+/**
+ * @file
+ * @brief Summaries of samples, for the KPIs reported by the benchmarks.
+ */
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <stddef.h>
+
+/**
+ * @brief Summary of a set of samples, for the tail of a distribution.
+ */
+typedef struct {
+    double mean;
+    double p95;
+    double p99;
+    double max;
+} StatisticsSummary;
+
+/**
+ * @brief Distribution of a set of samples, for comparing the KPIs of many runs.
+ */
+typedef struct {
+    double mean;
+
+    /**
+     * @brief Sample standard deviation, 0 for less than two samples.
+     */
+    double stddev;
+
+    /**
+     * @brief Half width of the 95 % confidence interval of the mean, from the normal approximation.
+     */
+    double ci95;
+
+    double p5;
+    double p50;
+    double p95;
+    double min;
+    double max;
+} StatisticsDistribution;
+
+/**
+ * @brief Summarizes @p p_samples. Sorts the samples.
+ *
+ * @param[in, out] p_samples The samples.
+ * @param[in] number_of_samples Number of samples.
+ *
+ * @return The summary, all zero if there are no samples.
+ */
+StatisticsSummary statistics_summarize(double* p_samples, const size_t number_of_samples);
+
+/**
+ * @brief Gets the distribution of @p p_samples. Sorts the samples.
+ *
+ * @param[in, out] p_samples The samples.
+ * @param[in] number_of_samples Number of samples.
+ *
+ * @return The distribution, all zero if there are no samples.
+ */
+StatisticsDistribution statistics_distribution(double* p_samples, const size_t number_of_samples);
+
+#endif
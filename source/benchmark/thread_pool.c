@@ -0,0 +1,228 @@
+/**
+ * @file
+ * @brief Implementation of the work-stealing thread pool.
+ *
+ * The tasks of a worker are a range of task numbers behind a mutex. The tasks are coarse, a whole simulation each, so
+ * a worker only takes its lock once per task, and the locks are next to never contended.
+ */
+
+#include "thread_pool.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Size of a cache line, the workers are aligned to it so that they do not share lines.
+ */
+#define THREAD_POOL_CACHE_LINE_SIZE 64
+
+struct ThreadPool;
+
+/**
+ * @brief A worker and the tasks it has left.
+ */
+typedef struct {
+    /**
+     * @brief Protects @c next_task and @c end_task.
+     */
+    _Alignas(THREAD_POOL_CACHE_LINE_SIZE) pthread_mutex_t mutex;
+
+    /**
+     * @brief The next task of the worker.
+     */
+    size_t next_task;
+
+    /**
+     * @brief One past the last task of the worker.
+     */
+    size_t end_task;
+
+    /**
+     * @brief Number of tasks the worker has run.
+     */
+    size_t number_of_tasks_run;
+
+    /**
+     * @brief Number of times the worker has stolen tasks.
+     */
+    unsigned long number_of_steals;
+
+    /**
+     * @brief Index of the worker in the pool.
+     */
+    unsigned int index;
+
+    /**
+     * @brief The pool of the worker.
+     */
+    struct ThreadPool* p_pool;
+} ThreadPoolWorker;
+
+/**
+ * @brief The workers running the tasks of one #thread_pool_run.
+ */
+typedef struct ThreadPool {
+    ThreadPoolWorker workers[THREAD_POOL_MAX_NUMBER_OF_THREADS];
+    unsigned int number_of_threads;
+    ThreadPoolTask task;
+    void* p_context;
+} ThreadPool;
+
+/**
+ * @brief Takes the next task of @p p_worker.
+ *
+ * @param[in, out] p_worker The worker.
+ * @param[out] p_task_index The task.
+ *
+ * @return false if the worker has no tasks left.
+ */
+static bool thread_pool_take(ThreadPoolWorker* p_worker, size_t* p_task_index) {
+    bool has_task = false;
+
+    pthread_mutex_lock(&p_worker->mutex);
+    if (p_worker->next_task < p_worker->end_task) {
+        *p_task_index = p_worker->next_task++;
+        has_task = true;
+    }
+    pthread_mutex_unlock(&p_worker->mutex);
+
+    return has_task;
+}
+
+/**
+ * @brief Moves the upper half of the tasks left of another worker to @p p_thief, which must have none left. The other
+ *        workers are tried in turn, starting with the one after @p p_thief.
+ *
+ * @param[in, out] p_thief The worker stealing.
+ *
+ * @return false if no other worker has tasks left, so all tasks have been started.
+ */
+static bool thread_pool_steal(ThreadPoolWorker* p_thief) {
+    ThreadPool* p_pool = p_thief->p_pool;
+
+    for (unsigned int offset = 1; offset < p_pool->number_of_threads; offset++) {
+        ThreadPoolWorker* p_victim = &p_pool->workers[(p_thief->index + offset) % p_pool->number_of_threads];
+
+        pthread_mutex_lock(&p_victim->mutex);
+        const size_t number_of_tasks_left = p_victim->end_task - p_victim->next_task;
+        const size_t number_of_tasks_stolen = (number_of_tasks_left + 1) / 2;
+        const size_t first_stolen_task = p_victim->end_task - number_of_tasks_stolen;
+        p_victim->end_task = first_stolen_task;
+        pthread_mutex_unlock(&p_victim->mutex);
+
+        if (number_of_tasks_stolen > 0) {
+            pthread_mutex_lock(&p_thief->mutex);
+            p_thief->next_task = first_stolen_task;
+            p_thief->end_task = first_stolen_task + number_of_tasks_stolen;
+            pthread_mutex_unlock(&p_thief->mutex);
+
+            p_thief->number_of_steals++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Runs tasks until there are none left to take or steal.
+ *
+ * @param[in, out] p_argument The worker.
+ *
+ * @return NULL.
+ */
+static void* thread_pool_work(void* p_argument) {
+    ThreadPoolWorker* p_worker = p_argument;
+    ThreadPool* p_pool = p_worker->p_pool;
+
+    // Tasks are never added, so once nothing can be stolen every task has been started by some worker
+    do {
+        size_t task_index;
+        while (thread_pool_take(p_worker, &task_index)) {
+            p_pool->task(p_pool->p_context, task_index);
+            p_worker->number_of_tasks_run++;
+        }
+    } while (thread_pool_steal(p_worker));
+
+    return NULL;
+}
+
+void thread_pool_run(const unsigned int number_of_threads,
+                     const size_t number_of_tasks,
+                     const ThreadPoolTask task,
+                     void* p_context,
+                     ThreadPoolStatistics* p_statistics) {
+    ThreadPool* p_pool = aligned_alloc(THREAD_POOL_CACHE_LINE_SIZE, sizeof(ThreadPool));
+    memset(p_pool, 0, sizeof(ThreadPool));
+
+    p_pool->number_of_threads = number_of_threads;
+    p_pool->task = task;
+    p_pool->p_context = p_context;
+
+    for (unsigned int i = 0; i < number_of_threads; i++) {
+        ThreadPoolWorker* p_worker = &p_pool->workers[i];
+
+        pthread_mutex_init(&p_worker->mutex, NULL);
+        p_worker->next_task = number_of_tasks * i / number_of_threads;
+        p_worker->end_task = number_of_tasks * (i + 1) / number_of_threads;
+        p_worker->index = i;
+        p_worker->p_pool = p_pool;
+    }
+
+    pthread_t threads[THREAD_POOL_MAX_NUMBER_OF_THREADS];
+    bool thread_is_started[THREAD_POOL_MAX_NUMBER_OF_THREADS] = {false};
+
+    for (unsigned int i = 1; i < number_of_threads; i++) {
+        thread_is_started[i] = pthread_create(&threads[i], NULL, thread_pool_work, &p_pool->workers[i]) == 0;
+    }
+
+    thread_pool_work(&p_pool->workers[0]);
+
+    for (unsigned int i = 1; i < number_of_threads; i++) {
+        if (thread_is_started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+
+    if (p_statistics) {
+        *p_statistics = (ThreadPoolStatistics){0, 0, number_of_tasks};
+
+        for (unsigned int i = 0; i < number_of_threads; i++) {
+            const ThreadPoolWorker* p_worker = &p_pool->workers[i];
+
+            p_statistics->number_of_steals += p_worker->number_of_steals;
+            if (p_worker->number_of_tasks_run > p_statistics->max_tasks_per_thread) {
+                p_statistics->max_tasks_per_thread = p_worker->number_of_tasks_run;
+            }
+            if (p_worker->number_of_tasks_run < p_statistics->min_tasks_per_thread) {
+                p_statistics->min_tasks_per_thread = p_worker->number_of_tasks_run;
+            }
+        }
+    }
+
+    for (unsigned int i = 0; i < number_of_threads; i++) {
+        pthread_mutex_destroy(&p_pool->workers[i].mutex);
+    }
+
+    free(p_pool);
+}
+
+unsigned int thread_pool_number_of_cores() {
+    cpu_set_t cpu_set;
+    unsigned int number_of_cores = 1;
+
+    if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+        number_of_cores = CPU_COUNT(&cpu_set);
+    }
+
+    if (number_of_cores < 1) {
+        number_of_cores = 1;
+    } else if (number_of_cores > THREAD_POOL_MAX_NUMBER_OF_THREADS) {
+        number_of_cores = THREAD_POOL_MAX_NUMBER_OF_THREADS;
+    }
+
+    return number_of_cores;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file
+ * @brief Work-stealing thread pool for running many independent tasks on all cores.
+ *
+ * The tasks are numbered, and every worker starts with an even share of the numbers. A worker runs its own tasks in
+ * increasing order, and once it runs out it steals the upper half of the remaining tasks of another worker, so
+ * workers whose tasks finish early keep busy until the last task has started.
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stddef.h>
+
+/**
+ * @brief Highest number of threads of a pool.
+ */
+#define THREAD_POOL_MAX_NUMBER_OF_THREADS 256
+
+/**
+ * @brief Runs one task.
+ *
+ * @param[in] p_context The context given to #thread_pool_run.
+ * @param[in] task_index Number of the task.
+ *
+ * @note Called from several threads at once, with a different @p task_index each time.
+ */
+typedef void (*ThreadPoolTask)(void* p_context, const size_t task_index);
+
+/**
+ * @brief What the workers of #thread_pool_run did.
+ */
+typedef struct {
+    /**
+     * @brief Number of times a worker took tasks from another worker.
+     */
+    unsigned long number_of_steals;
+
+    /**
+     * @brief Number of tasks run by the busiest worker.
+     */
+    size_t max_tasks_per_thread;
+
+    /**
+     * @brief Number of tasks run by the least busy worker.
+     */
+    size_t min_tasks_per_thread;
+} ThreadPoolStatistics;
+
+/**
+ * @brief Runs @p task for every number below @p number_of_tasks on @p number_of_threads threads, and waits for all
+ *        of them to finish.
+ *
+ * @param[in] number_of_threads Number of threads, at least 1 and at most #THREAD_POOL_MAX_NUMBER_OF_THREADS.
+ * @param[in] number_of_tasks Number of tasks.
+ * @param[in] task Runs one task.
+ * @param[in] p_context Passed to @p task.
+ * @param[out] p_statistics What the workers did, may be NULL.
+ *
+ * @note The calling thread is one of the workers. If another thread can not be started, its tasks are stolen by the
+ *       workers which did start.
+ */
+void thread_pool_run(const unsigned int number_of_threads,
+                     const size_t number_of_tasks,
+                     const ThreadPoolTask task,
+                     void* p_context,
+                     ThreadPoolStatistics* p_statistics);
+
+/**
+ * @brief Gets the number of cores the process may run on.
+ *
+ * @return The number of cores, at least 1 and at most #THREAD_POOL_MAX_NUMBER_OF_THREADS.
+ */
+unsigned int thread_pool_number_of_cores();
+
+#endif
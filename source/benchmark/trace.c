@@ -0,0 +1,116 @@
+/**
+ * @file
+ * @brief Implementation of the trace loader.
+ */
+
+#include "trace.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Parses one line of a trace.
+ *
+ * @param[in] line The line.
+ * @param[in] number_of_floors Number of floors of the elevator.
+ * @param[out] p_call The call on the line.
+ *
+ * @return true if the line holds a valid call.
+ */
+static bool trace_parse_call(const char* line, const int number_of_floors, TraceCall* p_call) {
+    char direction[8];
+
+    if (sscanf(line, "%lf %i %7s %i", &p_call->time, &p_call->floor, direction, &p_call->destination) != 4) {
+        return false;
+    }
+
+    if (strcmp(direction, "up") == 0) {
+        p_call->direction = HARDWARE_ORDER_UP;
+    } else if (strcmp(direction, "down") == 0) {
+        p_call->direction = HARDWARE_ORDER_DOWN;
+    } else {
+        return false;
+    }
+
+    if (p_call->time < 0.0 || p_call->floor < 0 || p_call->floor >= number_of_floors || p_call->destination < 0 ||
+        p_call->destination >= number_of_floors) {
+        return false;
+    }
+
+    // The hall button has to point towards the destination
+    if (p_call->direction == HARDWARE_ORDER_UP) {
+        return p_call->destination > p_call->floor;
+    }
+
+    return p_call->destination < p_call->floor;
+}
+
+int trace_load(const char* path, const int number_of_floors, Trace* p_trace) {
+    FILE* p_file = fopen(path, "r");
+    if (!p_file) {
+        fprintf(stderr, "Unable to open trace %s\n", path);
+        return 1;
+    }
+
+    size_t capacity = 64;
+    p_trace->p_calls = malloc(capacity * sizeof(TraceCall));
+    p_trace->number_of_calls = 0;
+
+    char line[256];
+    int line_number = 0;
+    int error = 0;
+
+    while (!error && fgets(line, sizeof(line), p_file)) {
+        line_number++;
+
+        const char* p_start = line + strspn(line, " \t");
+        if (*p_start == '#' || *p_start == '\n' || *p_start == '\0') {
+            continue;
+        }
+
+        TraceCall call;
+        if (!trace_parse_call(p_start, number_of_floors, &call)) {
+            fprintf(stderr, "%s:%i: invalid call\n", path, line_number);
+            error = 1;
+        } else if (p_trace->number_of_calls > 0 && call.time < p_trace->p_calls[p_trace->number_of_calls - 1].time) {
+            fprintf(stderr, "%s:%i: calls are not sorted by time\n", path, line_number);
+            error = 1;
+        } else {
+            if (p_trace->number_of_calls == capacity) {
+                capacity *= 2;
+                p_trace->p_calls = realloc(p_trace->p_calls, capacity * sizeof(TraceCall));
+            }
+            p_trace->p_calls[p_trace->number_of_calls++] = call;
+        }
+    }
+
+    fclose(p_file);
+
+    if (error) {
+        trace_free(p_trace);
+    }
+
+    return error;
+}
+
+void trace_write(const Trace* p_trace, FILE* p_file) {
+    fprintf(p_file, "# <seconds> <floor> up|down <destination>\n");
+
+    for (size_t i = 0; i < p_trace->number_of_calls; i++) {
+        const TraceCall* p_call = &p_trace->p_calls[i];
+        fprintf(p_file,
+                "%.3f %i %s %i\n",
+                p_call->time,
+                p_call->floor,
+                p_call->direction == HARDWARE_ORDER_UP ? "up" : "down",
+                p_call->destination);
+    }
+}
+
+void trace_free(Trace* p_trace) {
+    free(p_trace->p_calls);
+    p_trace->p_calls = NULL;
+    p_trace->number_of_calls = 0;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file
+ * @brief Passenger call traces for the benchmark. A trace is a text file with one call per line:
+ *
+ *        @c <seconds> @c <floor> @c up|down @c <destination>
+ *
+ *        where @c seconds is when the passenger presses the hall button at @c floor, and @c destination is the floor
+ *        they press in the cab once on board. Calls must be sorted by time. Empty lines and lines starting with @c #
+ *        are skipped.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "hardware.h"
+
+/**
+ * @brief One passenger call.
+ */
+typedef struct {
+    /**
+     * @brief Seconds from the start of the trace when the hall button is pressed.
+     */
+    double time;
+
+    /**
+     * @brief Floor of the hall button.
+     */
+    int floor;
+
+    /**
+     * @brief Direction of the hall button, #HARDWARE_ORDER_UP or #HARDWARE_ORDER_DOWN.
+     */
+    HardwareOrder direction;
+
+    /**
+     * @brief Floor pressed in the cab.
+     */
+    int destination;
+} TraceCall;
+
+/**
+ * @brief A loaded trace.
+ */
+typedef struct {
+    TraceCall* p_calls;
+    size_t number_of_calls;
+} Trace;
+
+/**
+ * @brief Loads the trace at @p path.
+ *
+ * @param[in] path Path of the trace file.
+ * @param[in] number_of_floors Number of floors of the elevator, calls outside them are rejected.
+ * @param[out] p_trace The loaded trace, must be freed with #trace_free.
+ *
+ * @return 0 on success, non-zero if the file could not be read or has an invalid line, which is reported on stderr.
+ */
+int trace_load(const char* path, const int number_of_floors, Trace* p_trace);
+
+/**
+ * @brief Writes @p p_trace in the format read by #trace_load.
+ *
+ * @param[in] p_trace The trace.
+ * @param[in] p_file The file to write to.
+ */
+void trace_write(const Trace* p_trace, FILE* p_file);
+
+/**
+ * @brief Frees the calls of @p p_trace.
+ *
+ * @param[in, out] p_trace The trace.
+ */
+void trace_free(Trace* p_trace);
+
+#endif
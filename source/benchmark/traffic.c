@@ -0,0 +1,148 @@
+/**
+ * @file
+ * @brief Implementation of the traffic generator.
+ */
+
+#include "traffic.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Names of the patterns, indexed by #TrafficPattern.
+ */
+static const char* m_traffic_pattern_names[] = {"up-peak", "inter-floor", "down-peak"};
+
+/**
+ * @brief Gets the next random number of a xorshift64* generator.
+ *
+ * @param[in, out] p_state State of the generator, must not be 0.
+ *
+ * @return The random number.
+ */
+static uint64_t traffic_random_next(uint64_t* p_state) {
+    *p_state ^= *p_state >> 12;
+    *p_state ^= *p_state << 25;
+    *p_state ^= *p_state >> 27;
+
+    return *p_state * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * @brief Draws a uniform random number in [0, 1).
+ *
+ * @param[in, out] p_state State of the generator.
+ *
+ * @return The random number.
+ */
+static double traffic_random_uniform(uint64_t* p_state) {
+    return (traffic_random_next(p_state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief Draws a uniform random integer in [@p low, @p high].
+ *
+ * @param[in, out] p_state State of the generator.
+ * @param[in] low The lowest value.
+ * @param[in] high The highest value.
+ *
+ * @return The random integer.
+ */
+static int traffic_random_integer(uint64_t* p_state, const int low, const int high) {
+    return low + (int)(traffic_random_uniform(p_state) * (high - low + 1));
+}
+
+TrafficParameters traffic_parameters_for_pattern(const TrafficPattern pattern,
+                                                 const double rate_per_minute,
+                                                 const double duration,
+                                                 const uint64_t seed) {
+    TrafficParameters parameters = {
+        .rate_per_minute = rate_per_minute,
+        .duration = duration,
+        .seed = seed,
+    };
+
+    switch (pattern) {
+        case TRAFFIC_PATTERN_UP_PEAK:
+            parameters.from_lobby_fraction = 0.85;
+            parameters.to_lobby_fraction = 0.05;
+            break;
+
+        case TRAFFIC_PATTERN_INTER_FLOOR:
+            parameters.from_lobby_fraction = 0.0;
+            parameters.to_lobby_fraction = 0.0;
+            break;
+
+        case TRAFFIC_PATTERN_DOWN_PEAK:
+            parameters.from_lobby_fraction = 0.05;
+            parameters.to_lobby_fraction = 0.85;
+            break;
+    }
+
+    return parameters;
+}
+
+int traffic_pattern_from_name(const char* name, TrafficPattern* p_pattern) {
+    for (unsigned int i = 0; i < sizeof(m_traffic_pattern_names) / sizeof(m_traffic_pattern_names[0]); i++) {
+        if (strcmp(name, m_traffic_pattern_names[i]) == 0) {
+            *p_pattern = (TrafficPattern)i;
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+void traffic_generate(const TrafficParameters* p_parameters, const int number_of_floors, Trace* p_trace) {
+    // The state of xorshift must not be 0, so the seed is mixed with a constant
+    uint64_t state = p_parameters->seed ^ 0x9E3779B97F4A7C15ULL;
+    if (state == 0) {
+        state = 1;
+    }
+
+    size_t capacity = 64;
+    p_trace->p_calls = malloc(capacity * sizeof(TraceCall));
+    p_trace->number_of_calls = 0;
+
+    const double rate_per_second = p_parameters->rate_per_minute / 60.0;
+    if (rate_per_second <= 0.0) {
+        return;
+    }
+
+    double time = 0.0;
+
+    while (true) {
+        // Exponential time between arrivals gives a Poisson process
+        time += -log(1.0 - traffic_random_uniform(&state)) / rate_per_second;
+        if (time >= p_parameters->duration) {
+            break;
+        }
+
+        TraceCall call = {.time = time};
+        const double draw = traffic_random_uniform(&state);
+
+        if (draw < p_parameters->from_lobby_fraction) {
+            call.floor = 0;
+            call.destination = traffic_random_integer(&state, 1, number_of_floors - 1);
+        } else if (draw < p_parameters->from_lobby_fraction + p_parameters->to_lobby_fraction) {
+            call.floor = traffic_random_integer(&state, 1, number_of_floors - 1);
+            call.destination = 0;
+        } else {
+            call.floor = traffic_random_integer(&state, 0, number_of_floors - 1);
+            call.destination = traffic_random_integer(&state, 0, number_of_floors - 2);
+            if (call.destination >= call.floor) {
+                call.destination++;
+            }
+        }
+
+        call.direction = call.destination > call.floor ? HARDWARE_ORDER_UP : HARDWARE_ORDER_DOWN;
+
+        if (p_trace->number_of_calls == capacity) {
+            capacity *= 2;
+            p_trace->p_calls = realloc(p_trace->p_calls, capacity * sizeof(TraceCall));
+        }
+        p_trace->p_calls[p_trace->number_of_calls++] = call;
+    }
+}
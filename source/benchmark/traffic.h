@@ -0,0 +1,102 @@
+/**
+ * @file
+ * @brief Synthetic passenger traffic for the benchmark. Passengers arrive as a Poisson process, and their floors are
+ *        drawn from the distribution of a traffic pattern.
+ *
+ * Each passenger travels from the lobby (floor 0) to a uniformly drawn upper floor with probability
+ * #TrafficParameters.from_lobby_fraction, from a uniformly drawn upper floor to the lobby with probability
+ * #TrafficParameters.to_lobby_fraction, and otherwise between two uniformly drawn distinct floors.
+ */
+
+#ifndef TRAFFIC_H
+#define TRAFFIC_H
+
+#include <stdint.h>
+
+#include "trace.h"
+
+/**
+ * @brief The traffic patterns of a working day.
+ */
+typedef enum {
+    /**
+     * @brief Morning, most passengers travel up from the lobby.
+     */
+    TRAFFIC_PATTERN_UP_PEAK,
+
+    /**
+     * @brief Lunch, passengers travel between any floors.
+     */
+    TRAFFIC_PATTERN_INTER_FLOOR,
+
+    /**
+     * @brief Evening, most passengers travel down to the lobby.
+     */
+    TRAFFIC_PATTERN_DOWN_PEAK
+} TrafficPattern;
+
+/**
+ * @brief Parameters of the generated traffic.
+ */
+typedef struct {
+    /**
+     * @brief Mean number of passengers arriving per minute.
+     */
+    double rate_per_minute;
+
+    /**
+     * @brief Seconds of traffic to generate.
+     */
+    double duration;
+
+    /**
+     * @brief Probability of a passenger travelling from the lobby.
+     */
+    double from_lobby_fraction;
+
+    /**
+     * @brief Probability of a passenger travelling to the lobby.
+     */
+    double to_lobby_fraction;
+
+    /**
+     * @brief Seed of the random numbers. The same parameters and seed always give the same traffic.
+     */
+    uint64_t seed;
+} TrafficParameters;
+
+/**
+ * @brief Gets the parameters of @p pattern with the lobby fractions of the pattern.
+ *
+ * @param[in] pattern The pattern.
+ * @param[in] rate_per_minute Mean number of passengers arriving per minute.
+ * @param[in] duration Seconds of traffic to generate.
+ * @param[in] seed Seed of the random numbers.
+ *
+ * @return The parameters.
+ */
+TrafficParameters traffic_parameters_for_pattern(const TrafficPattern pattern,
+                                                 const double rate_per_minute,
+                                                 const double duration,
+                                                 const uint64_t seed);
+
+/**
+ * @brief Parses the name of a pattern: @c up-peak, @c inter-floor or @c down-peak.
+ *
+ * @param[in] name The name.
+ * @param[out] p_pattern The pattern.
+ *
+ * @return 0 on success, non-zero if @p name is not a pattern.
+ */
+int traffic_pattern_from_name(const char* name, TrafficPattern* p_pattern);
+
+/**
+ * @brief Generates passenger calls.
+ *
+ * @param[in] p_parameters The parameters of the traffic.
+ * @param[in] number_of_floors Number of floors of the elevator, at least 2.
+ * @param[out] p_trace The generated calls sorted by time, must be freed with #trace_free.
+ */
+void traffic_generate(const TrafficParameters* p_parameters, const int number_of_floors, Trace* p_trace);
+
+#endif
@@ -0,0 +1,51 @@
+/**
+ * @file
+ * @brief Implementation of Clock.
+ */
+
+#include "clock.h"
+
+#include <time.h>
+
+/**
+ * @brief The source of the clock. Thread local, like the time of the virtual clock, so that several simulations can
+ *        run side by side.
+ */
+static _Thread_local ClockSource m_clock_source = CLOCK_SOURCE_REAL;
+
+/**
+ * @brief The time of the virtual clock in milliseconds.
+ */
+static _Thread_local uint64_t m_clock_virtual_time_ms = 0;
+
+/**
+ * @brief Reads the real monotonic clock.
+ *
+ * @return Milliseconds since an arbitrary point in the past.
+ */
+static uint64_t clock_read_monotonic_ms() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+}
+
+void clock_set_source(const ClockSource source) {
+    if (source == CLOCK_SOURCE_VIRTUAL && m_clock_source != CLOCK_SOURCE_VIRTUAL) {
+        m_clock_virtual_time_ms = clock_read_monotonic_ms();
+    }
+
+    m_clock_source = source;
+}
+
+ClockSource clock_get_source() { return m_clock_source; }
+
+uint64_t clock_now_ms() {
+    if (m_clock_source == CLOCK_SOURCE_VIRTUAL) {
+        return m_clock_virtual_time_ms;
+    }
+
+    return clock_read_monotonic_ms();
+}
+
+void clock_advance_ms(const uint64_t milliseconds) { m_clock_virtual_time_ms += milliseconds; }
@@ -0,0 +1,47 @@
+/**
+ * @file
+ * @brief Clock used by the timed logic of the elevator. Reads either the real monotonic clock, or a virtual clock which
+ *        only moves when told to, so that tests and simulations can run faster than real time.
+ */
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stdint.h>
+
+/**
+ * @brief The sources the clock can read from.
+ */
+typedef enum { CLOCK_SOURCE_REAL, CLOCK_SOURCE_VIRTUAL } ClockSource;
+
+/**
+ * @brief Selects the source of the clock for the calling thread. The real source is used until this is called.
+ *
+ * @param[in] source The source to use.
+ *
+ * @note The virtual clock starts at the current time when selected, so timers which are running keep their deadlines.
+ */
+void clock_set_source(const ClockSource source);
+
+/**
+ * @brief Gets the source of the clock for the calling thread.
+ *
+ * @return The source.
+ */
+ClockSource clock_get_source();
+
+/**
+ * @brief Gets the current time.
+ *
+ * @return Milliseconds since an arbitrary point in the past. Never decreases as long as the source is not changed.
+ */
+uint64_t clock_now_ms();
+
+/**
+ * @brief Moves the virtual clock forward by @p milliseconds. Has no effect on the real clock.
+ *
+ * @param[in] milliseconds How far to move the clock.
+ */
+void clock_advance_ms(const uint64_t milliseconds);
+
+#endif
@@ -0,0 +1,369 @@
+/**
+ * @file
+ * @brief Implementation of the controller.
+ */
+
+#include "controller.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "clock.h"
+#include "event_log.h"
+#include "fsm.h"
+#include "hardware.h"
+#include "hardware_backend.h"
+#include "hardware_thread.h"
+#include "metrics.h"
+#include "recording.h"
+
+/**
+ * @brief Handles signal interrupt from the command line.
+ * 
+ * @param[in] sig The signal.
+ */
+static void controller_sigint_handler(int sig);
+
+/**
+ * @brief Handles the signal asking for the metrics to be printed.
+ *
+ * @param[in] sig The signal.
+ */
+static void controller_sigusr1_handler(int sig);
+
+/**
+ * @brief Handles the signal asking for the event log to be written to its file.
+ *
+ * @param[in] sig The signal.
+ */
+static void controller_sigusr2_handler(int sig);
+
+/**
+ * @brief Writes the event log to @p path, and reports a failure.
+ *
+ * @param[in] path The file.
+ */
+static void controller_flush_event_log(const char* path);
+
+/**
+ * @brief Starts the thread writing the event log to @p path when asked to, so that the writes never hold up the
+ *        control loop.
+ *
+ * @param[in] path The file, which must outlive the thread.
+ *
+ * @return 0 on success, non-zero if the thread could not be started.
+ */
+static int controller_start_event_log_writer(const char* path);
+
+/**
+ * @brief Stops the thread started by #controller_start_event_log_writer, after it has finished any write in
+ *        progress.
+ */
+static void controller_stop_event_log_writer(void);
+
+/**
+ * @brief Writes the event log each time it is asked to, until stopped.
+ *
+ * @param[in] p_argument The file.
+ *
+ * @return NULL.
+ */
+static void* controller_run_event_log_writer(void* p_argument);
+
+/**
+ * @brief Reads the inputs of the elevator, from the I/O thread if the driver runs on one.
+ *
+ * @param[in] p_options How the controller runs.
+ * @param[out] p_snapshot Snapshot to fill.
+ */
+static void controller_read_snapshot(const ControllerOptions* p_options, HardwareSnapshot* p_snapshot);
+
+/**
+ * @brief Writes the commands of the iteration to the hardware, or hands them over to the I/O thread if the driver
+ *        runs on one.
+ *
+ * @param[in] p_options How the controller runs.
+ */
+static void controller_flush(const ControllerOptions* p_options);
+
+/**
+ * @brief Determines if the controller should continue running.
+ */
+static volatile sig_atomic_t m_controller_should_abort = false;
+
+/**
+ * @brief Determines if the controller should print its metrics after the current iteration.
+ */
+static volatile sig_atomic_t m_controller_should_print_metrics = false;
+
+/**
+ * @brief Posted to ask the event log writer for a write, from the signal handler or to stop it.
+ */
+static sem_t m_controller_event_log_requests;
+
+/**
+ * @brief The thread writing the event log.
+ */
+static pthread_t m_controller_event_log_writer;
+
+/**
+ * @brief Determines if the event log writer should return at its next request.
+ */
+static atomic_bool m_controller_should_stop_event_log_writer;
+
+/**
+ * @brief The elevator controlled through the hardware driver.
+ */
+static Elevator m_controller_elevator;
+
+/**
+ * @brief The latency metrics of the loop.
+ */
+static Metrics m_controller_metrics;
+
+/**
+ * @brief The event log of the elevator, only used if it has a file.
+ */
+static EventLog m_controller_event_log;
+
+/**
+ * @brief Records the inputs and the commands of the elevator, only used if it has a file.
+ */
+static RecordingWriter m_controller_recording;
+
+void controller_run(const ControllerOptions* p_options) {
+    int error = hardware_init();
+    if (error != 0) {
+        fprintf(stderr, "Unable to initialize hardware\n");
+        exit(1);
+    }
+
+    hardware_set_command_buffering(true);
+
+    if (p_options->should_acquire_inputs &&
+        hardware_start_input_acquisition(p_options->acquisition_period_us) != 0) {
+        fprintf(stderr, "Unable to start input acquisition, polling the inputs instead\n");
+    }
+
+    if (p_options->should_use_io_thread && hardware_thread_start(p_options->io_poll_period_us) != 0) {
+        fprintf(stderr, "Unable to start the I/O thread\n");
+        exit(1);
+    }
+
+    error = scheduler_init(p_options->scheduler_mode,
+                           p_options->tick_period_ms,
+                           p_options->should_use_io_thread ? hardware_thread_event_fd() : hardware_event_fd());
+    if (error != 0) {
+        fprintf(stderr, "Unable to initialize scheduler\n");
+        exit(1);
+    }
+
+    // Set up before the handler which posts to it
+    if (sem_init(&m_controller_event_log_requests, 0, 0) != 0) {
+        fprintf(stderr, "Unable to initialize the event log requests\n");
+        exit(1);
+    }
+
+    signal(SIGINT, controller_sigint_handler);
+    signal(SIGUSR1, controller_sigusr1_handler);
+    signal(SIGUSR2, controller_sigusr2_handler);
+
+    HardwareBackend hardware = p_options->should_use_io_thread ? hardware_thread_backend() : hardware_backend_driver();
+    if (p_options->recording_path) {
+        if (recording_writer_open(&m_controller_recording, p_options->recording_path, &hardware) != 0) {
+            fprintf(stderr, "Unable to create recording %s\n", p_options->recording_path);
+            exit(1);
+        }
+        hardware = recording_writer_backend(&m_controller_recording);
+    }
+
+    if (p_options->event_log_path) {
+        event_log_init(&m_controller_event_log);
+        hardware.p_event_log = &m_controller_event_log;
+
+        if (controller_start_event_log_writer(p_options->event_log_path) != 0) {
+            fprintf(stderr, "Unable to start the event log writer\n");
+            exit(1);
+        }
+    }
+
+    fsm_init(&m_controller_elevator, &hardware);
+    metrics_init(&m_controller_metrics, &m_controller_elevator, metrics_now_ns());
+
+    while (!m_controller_should_abort) {
+        scheduler_wait(fsm_next_deadline_ms(&m_controller_elevator));
+
+        const uint64_t iteration_start_ns = metrics_now_ns();
+        metrics_record_iteration_start(&m_controller_metrics, iteration_start_ns);
+
+        HardwareSnapshot snapshot;
+        controller_read_snapshot(p_options, &snapshot);
+        const uint64_t read_end_ns = metrics_now_ns();
+        metrics_record_hardware_call(&m_controller_metrics,
+                                     METRICS_HARDWARE_CALL_READ_SNAPSHOT,
+                                     iteration_start_ns,
+                                     read_end_ns);
+
+        const uint64_t now_ms = clock_now_ms();
+        if (p_options->recording_path) {
+            recording_writer_step(&m_controller_recording, &snapshot, now_ms);
+        }
+        fsm_step(&m_controller_elevator, &snapshot, now_ms);
+
+        const uint64_t flush_start_ns = metrics_now_ns();
+        controller_flush(p_options);
+        const uint64_t iteration_end_ns = metrics_now_ns();
+        metrics_record_hardware_call(&m_controller_metrics,
+                                     METRICS_HARDWARE_CALL_FLUSH,
+                                     flush_start_ns,
+                                     iteration_end_ns);
+        metrics_record_iteration_end(&m_controller_metrics, &m_controller_elevator, iteration_end_ns);
+
+        if (m_controller_should_print_metrics) {
+            m_controller_should_print_metrics = false;
+            metrics_print(&m_controller_metrics, stdout);
+        }
+    }
+
+    printf("Terminating elevator\n");
+    scheduler_report();
+    scheduler_deinit();
+
+    if (p_options->should_print_metrics) {
+        metrics_print(&m_controller_metrics, stdout);
+    }
+
+    if (p_options->recording_path) {
+        recording_writer_deinit(&m_controller_recording);
+    }
+
+    fsm_deinit(&m_controller_elevator);
+
+    // The I/O thread owns the driver and its output statistics until it has applied the last commands
+    if (p_options->should_use_io_thread) {
+        hardware_thread_stop();
+    }
+
+    HardwareOutputStatistics output_statistics;
+    hardware_get_output_statistics(&output_statistics);
+    printf("Hardware: %lu output writes issued, %lu suppressed as unchanged\n",
+           output_statistics.writes_issued,
+           output_statistics.writes_suppressed);
+
+    if (p_options->recording_path && recording_writer_close(&m_controller_recording) != 0) {
+        fprintf(stderr, "Unable to write recording %s\n", p_options->recording_path);
+    }
+
+    if (p_options->event_log_path) {
+        controller_stop_event_log_writer();
+        controller_flush_event_log(p_options->event_log_path);
+    }
+
+    signal(SIGUSR2, SIG_DFL);
+    sem_destroy(&m_controller_event_log_requests);
+
+    hardware_set_command_buffering(false);
+}
+
+/**
+ * #################################################################################################################
+ * #####                                       HARDWARE                                                        #####
+ * #################################################################################################################
+ */
+
+static void controller_read_snapshot(const ControllerOptions* p_options, HardwareSnapshot* p_snapshot) {
+    if (p_options->should_use_io_thread) {
+        hardware_thread_read_snapshot(p_snapshot);
+    } else {
+        hardware_read_snapshot(p_snapshot);
+    }
+}
+
+static void controller_flush(const ControllerOptions* p_options) {
+    if (p_options->should_use_io_thread) {
+        hardware_thread_flush();
+    } else {
+        hardware_flush();
+    }
+}
+
+/**
+ * #################################################################################################################
+ * #####                                       INTERRUPTS                                                      #####
+ * #################################################################################################################
+ */
+
+static void controller_sigint_handler(int sig) {
+    (void)(sig);
+    m_controller_should_abort = true;
+}
+
+static void controller_sigusr1_handler(int sig) {
+    (void)(sig);
+    m_controller_should_print_metrics = true;
+}
+
+static void controller_sigusr2_handler(int sig) {
+    (void)(sig);
+    // Unlike a flag for the loop, the post wakes the writer right away. Ignored if no writer runs.
+    sem_post(&m_controller_event_log_requests);
+}
+
+/**
+ * #################################################################################################################
+ * #####                                       EVENT LOG                                                       #####
+ * #################################################################################################################
+ */
+
+static void controller_flush_event_log(const char* path) {
+    if (event_log_flush(&m_controller_event_log, path) != 0) {
+        fprintf(stderr, "Unable to write the event log to %s\n", path);
+    }
+}
+
+static int controller_start_event_log_writer(const char* path) {
+    atomic_store(&m_controller_should_stop_event_log_writer, false);
+
+    // Signals are left to the control loop, so that they interrupt its wait. The new thread inherits the mask.
+    sigset_t all_signals;
+    sigset_t previous_signals;
+    sigfillset(&all_signals);
+    pthread_sigmask(SIG_BLOCK, &all_signals, &previous_signals);
+
+    const int error =
+        pthread_create(&m_controller_event_log_writer, NULL, controller_run_event_log_writer, (void*)path);
+    pthread_sigmask(SIG_SETMASK, &previous_signals, NULL);
+
+    return error;
+}
+
+static void controller_stop_event_log_writer(void) {
+    atomic_store(&m_controller_should_stop_event_log_writer, true);
+    sem_post(&m_controller_event_log_requests);
+    pthread_join(m_controller_event_log_writer, NULL);
+}
+
+static void* controller_run_event_log_writer(void* p_argument) {
+    const char* path = p_argument;
+
+    while (true) {
+        if (sem_wait(&m_controller_event_log_requests) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return NULL;
+        }
+
+        if (atomic_load(&m_controller_should_stop_event_log_writer)) {
+            return NULL;
+        }
+
+        controller_flush_event_log(path);
+    }
+}
@@ -0,0 +1,74 @@
+/**
+ * @file
+ * @brief Runs the FSM of a single elevator on the linked hardware driver, paced by the scheduler. The latency metrics
+ *        of the loop are always recorded, and printed when the process gets SIGUSR1. The event log of the elevator is
+ *        written to its file when the process gets SIGUSR2.
+ */
+
+#ifndef CONTROLLER_H
+#define CONTROLLER_H
+
+#include <stdbool.h>
+
+#include "scheduler.h"
+
+/**
+ * @brief How the controller runs.
+ */
+typedef struct {
+    /**
+     * @brief How the loop of the FSM is paced.
+     */
+    SchedulerMode scheduler_mode;
+
+    /**
+     * @brief Period of the loop in milliseconds when @c scheduler_mode is #SCHEDULER_MODE_EVENT.
+     */
+    unsigned int tick_period_ms;
+
+    /**
+     * @brief Whether to also print the metrics of the loop when terminating.
+     */
+    bool should_print_metrics;
+
+    /**
+     * @brief File the event log is written to when terminating, NULL to not keep an event log.
+     */
+    const char* event_log_path;
+
+    /**
+     * @brief File every input and command of the elevator is recorded to, for replaying offline. NULL to not record.
+     */
+    const char* recording_path;
+
+    /**
+     * @brief Whether the driver runs on a dedicated I/O thread, see hardware_thread.h.
+     */
+    bool should_use_io_thread;
+
+    /**
+     * @brief How long the I/O thread waits between two reads of the inputs, in microseconds. 0 to read them back to
+     *        back.
+     */
+    unsigned int io_poll_period_us;
+
+    /**
+     * @brief Whether the hardware should deliver its inputs asynchronously, waking the scheduler when they change,
+     *        see #hardware_start_input_acquisition.
+     */
+    bool should_acquire_inputs;
+
+    /**
+     * @brief Period of the hardware-timed scan of the inputs in microseconds, 0 to be woken on every change of state.
+     */
+    unsigned int acquisition_period_us;
+} ControllerOptions;
+
+/**
+ * @brief Starts the elevator, and steps it until interrupted by SIGINT.
+ *
+ * @param[in] p_options How to run.
+ */
+void controller_run(const ControllerOptions* p_options);
+
+#endif
@@ -0,0 +1,271 @@
+/**
+ * @file
+ * @brief Implementation of the group dispatcher.
+ */
+
+#include "dispatcher.h"
+
+#include <math.h>
+
+/**
+ * @brief Maximum number of times a car is followed turning when estimating the cost of a call. A call is always
+ *        reached within two turns.
+ */
+#define DISPATCHER_MAX_NUMBER_OF_LEGS 3
+
+/**
+ * @brief The directions of the hall calls.
+ */
+static const HardwareOrder m_dispatcher_hall_directions[] = {HARDWARE_ORDER_UP, HARDWARE_ORDER_DOWN};
+
+/**
+ * @brief Converts a position to a floor, halfway between two floors when the car is between them.
+ *
+ * @param[in] position The position.
+ *
+ * @return The floor.
+ */
+static double dispatcher_position_to_floor(const Position position) {
+    switch (position.offset) {
+        case OFFSET_BELOW:
+            return position.floor - 0.5;
+        case OFFSET_ABOVE:
+            return position.floor + 0.5;
+        default:
+            return position.floor;
+    }
+}
+
+/**
+ * @brief Checks if @p car has committed to stopping at @p floor, for a call from its cab or a hall call assigned to
+ *        it.
+ *
+ * @param[in] p_dispatcher The dispatcher.
+ * @param[in] car The car.
+ * @param[in] floor The floor.
+ *
+ * @return true if the car stops at the floor.
+ */
+static bool dispatcher_car_stops_at(const Dispatcher* p_dispatcher, const int car, const int floor) {
+    return p_dispatcher->cars[car].cab_calls[floor] ||
+           p_dispatcher->hall_call_cars[floor][HARDWARE_ORDER_UP] == car ||
+           p_dispatcher->hall_call_cars[floor][HARDWARE_ORDER_DOWN] == car;
+}
+
+/**
+ * @brief Checks if @p floor is ahead of a car at @p position travelling in @p step.
+ *
+ * @param[in] floor The floor.
+ * @param[in] position The floor of the car, see #dispatcher_position_to_floor.
+ * @param[in] step 1 when travelling up, -1 when travelling down.
+ * @param[in] include_position If the car can still stop at @p position.
+ *
+ * @return true if the floor is ahead.
+ */
+static bool dispatcher_floor_is_ahead(const int floor,
+                                      const double position,
+                                      const int step,
+                                      const bool include_position) {
+    const double distance = (floor - position) * step;
+    return distance > 0.0 || (include_position && distance == 0.0);
+}
+
+void dispatcher_init(Dispatcher* p_dispatcher,
+                     const int number_of_floors,
+                     const int number_of_cars,
+                     const double travel_time,
+                     const double stop_time) {
+    *p_dispatcher = (Dispatcher){0};
+
+    p_dispatcher->number_of_floors = number_of_floors;
+    p_dispatcher->number_of_cars = number_of_cars;
+    if (p_dispatcher->number_of_cars > DISPATCHER_MAX_NUMBER_OF_CARS) {
+        p_dispatcher->number_of_cars = DISPATCHER_MAX_NUMBER_OF_CARS;
+    }
+    p_dispatcher->travel_time = travel_time;
+    p_dispatcher->stop_time = stop_time;
+
+    for (int car = 0; car < p_dispatcher->number_of_cars; car++) {
+        p_dispatcher->cars[car].position = (Position){.floor = -1, .offset = OFFSET_UNDEFINED};
+        p_dispatcher->cars[car].direction = HARDWARE_MOVEMENT_STOP;
+        p_dispatcher->cars[car].is_in_service = true;
+    }
+
+    for (int floor = 0; floor < p_dispatcher->number_of_floors; floor++) {
+        for (int order_type = 0; order_type < HARDWARE_NUMBER_OF_BUTTONS; order_type++) {
+            p_dispatcher->hall_call_cars[floor][order_type] = DISPATCHER_NO_CAR;
+        }
+    }
+}
+
+void dispatcher_update_car(Dispatcher* p_dispatcher,
+                           const int car,
+                           const Position position,
+                           const HardwareMovement direction) {
+    p_dispatcher->cars[car].position = position;
+    p_dispatcher->cars[car].direction = direction;
+}
+
+double dispatcher_estimate_cost(const Dispatcher* p_dispatcher,
+                                const int car,
+                                const int floor,
+                                const HardwareOrder direction) {
+    const DispatcherCar* p_car = &p_dispatcher->cars[car];
+    if (!p_car->is_in_service || p_car->position.floor < 0 || p_car->position.offset == OFFSET_UNDEFINED) {
+        return -1.0;
+    }
+
+    bool is_served[HARDWARE_MAX_NUMBER_OF_FLOORS];
+    int number_of_stops = 0;
+    for (int stop = 0; stop < p_dispatcher->number_of_floors; stop++) {
+        is_served[stop] = !dispatcher_car_stops_at(p_dispatcher, car, stop);
+        number_of_stops += !is_served[stop];
+    }
+
+    const double committed_stops_cost = DISPATCHER_COMMITTED_STOP_WEIGHT * p_dispatcher->stop_time * number_of_stops;
+    const int call_step = direction == HARDWARE_ORDER_UP ? 1 : -1;
+    double position = dispatcher_position_to_floor(p_car->position);
+    bool include_position = p_car->position.offset == OFFSET_AT_FLOOR;
+
+    // An idle car heads for its nearest stop, or for the call if it has none
+    int step = 0;
+    if (p_car->direction == HARDWARE_MOVEMENT_UP) {
+        step = 1;
+    } else if (p_car->direction == HARDWARE_MOVEMENT_DOWN) {
+        step = -1;
+    } else {
+        double nearest_distance = fabs(floor - position);
+        step = floor > position ? 1 : (floor < position ? -1 : 0);
+        for (int stop = 0; stop < p_dispatcher->number_of_floors; stop++) {
+            if (!is_served[stop] && fabs(stop - position) < nearest_distance) {
+                nearest_distance = fabs(stop - position);
+                step = stop > position ? 1 : -1;
+            }
+        }
+    }
+
+    if (step == 0) {
+        return committed_stops_cost;
+    }
+
+    double time = 0.0;
+    for (int leg = 0; leg < DISPATCHER_MAX_NUMBER_OF_LEGS; leg++) {
+        int last_stop = -1;
+        for (int stop = 0; stop < p_dispatcher->number_of_floors; stop++) {
+            if (!is_served[stop] && dispatcher_floor_is_ahead(stop, position, step, include_position) &&
+                (last_stop < 0 || (stop - last_stop) * step > 0)) {
+                last_stop = stop;
+            }
+        }
+
+        // The call is picked up on the way if it goes the same way, or where the car turns
+        if (dispatcher_floor_is_ahead(floor, position, step, include_position) &&
+            (call_step == step || last_stop < 0 || (floor - last_stop) * step >= 0)) {
+            for (int stop = 0; stop < p_dispatcher->number_of_floors; stop++) {
+                if (!is_served[stop] && dispatcher_floor_is_ahead(stop, position, step, include_position) &&
+                    (floor - stop) * step > 0) {
+                    time += p_dispatcher->stop_time;
+                }
+            }
+
+            return time + fabs(floor - position) * p_dispatcher->travel_time + committed_stops_cost;
+        }
+
+        if (last_stop >= 0) {
+            for (int stop = 0; stop < p_dispatcher->number_of_floors; stop++) {
+                if (!is_served[stop] && dispatcher_floor_is_ahead(stop, position, step, include_position) &&
+                    (last_stop - stop) * step >= 0) {
+                    is_served[stop] = true;
+                    time += p_dispatcher->stop_time;
+                }
+            }
+
+            time += fabs(last_stop - position) * p_dispatcher->travel_time;
+            position = last_stop;
+        }
+
+        include_position = false;
+        step = -step;
+    }
+
+    return time + fabs(floor - position) * p_dispatcher->travel_time + committed_stops_cost;
+}
+
+int dispatcher_assign_hall_call(Dispatcher* p_dispatcher, const int floor, const HardwareOrder direction) {
+    if (p_dispatcher->hall_call_cars[floor][direction] >= 0) {
+        return p_dispatcher->hall_call_cars[floor][direction];
+    }
+
+    int best_car = DISPATCHER_NO_CAR;
+    double best_cost = 0.0;
+
+    for (int car = 0; car < p_dispatcher->number_of_cars; car++) {
+        const double cost = dispatcher_estimate_cost(p_dispatcher, car, floor, direction);
+        if (cost >= 0.0 && (best_car == DISPATCHER_NO_CAR || cost < best_cost)) {
+            best_car = car;
+            best_cost = cost;
+        }
+    }
+
+    p_dispatcher->hall_call_cars[floor][direction] = best_car != DISPATCHER_NO_CAR ? best_car
+                                                                                   : DISPATCHER_UNASSIGNED_CAR;
+    return best_car;
+}
+
+void dispatcher_assign_unassigned_hall_calls(Dispatcher* p_dispatcher) {
+    for (int floor = 0; floor < p_dispatcher->number_of_floors; floor++) {
+        for (int i = 0; i < 2; i++) {
+            const HardwareOrder direction = m_dispatcher_hall_directions[i];
+            if (p_dispatcher->hall_call_cars[floor][direction] == DISPATCHER_UNASSIGNED_CAR) {
+                dispatcher_assign_hall_call(p_dispatcher, floor, direction);
+            }
+        }
+    }
+}
+
+void dispatcher_set_car_in_service(Dispatcher* p_dispatcher, const int car, const bool is_in_service) {
+    p_dispatcher->cars[car].is_in_service = is_in_service;
+    if (is_in_service) {
+        return;
+    }
+
+    for (int floor = 0; floor < p_dispatcher->number_of_floors; floor++) {
+        p_dispatcher->cars[car].cab_calls[floor] = false;
+
+        for (int i = 0; i < 2; i++) {
+            const HardwareOrder direction = m_dispatcher_hall_directions[i];
+            if (p_dispatcher->hall_call_cars[floor][direction] == car) {
+                p_dispatcher->hall_call_cars[floor][direction] = DISPATCHER_UNASSIGNED_CAR;
+            }
+        }
+    }
+}
+
+void dispatcher_add_cab_call(Dispatcher* p_dispatcher, const int car, const int floor) {
+    p_dispatcher->cars[car].cab_calls[floor] = true;
+}
+
+void dispatcher_remove_cab_call(Dispatcher* p_dispatcher, const int car, const int floor) {
+    p_dispatcher->cars[car].cab_calls[floor] = false;
+}
+
+void dispatcher_car_served_floor(Dispatcher* p_dispatcher, const int car, const int floor) {
+    p_dispatcher->cars[car].cab_calls[floor] = false;
+
+    if (p_dispatcher->hall_call_cars[floor][HARDWARE_ORDER_UP] == car) {
+        p_dispatcher->hall_call_cars[floor][HARDWARE_ORDER_UP] = DISPATCHER_NO_CAR;
+    }
+
+    if (p_dispatcher->hall_call_cars[floor][HARDWARE_ORDER_DOWN] == car) {
+        p_dispatcher->hall_call_cars[floor][HARDWARE_ORDER_DOWN] = DISPATCHER_NO_CAR;
+    }
+}
+
+int dispatcher_get_hall_call_car(const Dispatcher* p_dispatcher, const int floor, const HardwareOrder direction) {
+    const int car = p_dispatcher->hall_call_cars[floor][direction];
+    return car >= 0 ? car : DISPATCHER_NO_CAR;
+}
+
+bool dispatcher_hall_light_is_on(const Dispatcher* p_dispatcher, const int floor, const HardwareOrder direction) {
+    return p_dispatcher->hall_call_cars[floor][direction] != DISPATCHER_NO_CAR;
+}
@@ -0,0 +1,218 @@
+/**
+ * @file
+ * @brief Group dispatcher for several cars in one building. Assigns every hall call to the car with the lowest
+ *        estimated cost, keeps cab calls with the car they were made in, and keeps one set of hall lights shared by
+ *        all the cars.
+ *
+ * The estimated cost of a call for a car is the time until the car would arrive at it, found by following the car
+ * the way the FSM drives it: on in its direction, stopping at the stops it has already committed to, until no stops
+ * remain ahead, and then turning. A call is picked up on the way if it goes in the direction of travel or is the
+ * last stop before the car turns. On top of the arrival time, every stop already committed costs a fraction of a
+ * stop, so that calls are spread between cars which would arrive about as fast.
+ */
+
+#ifndef DISPATCHER_H
+#define DISPATCHER_H
+
+#include <stdbool.h>
+
+#include "hardware.h"
+#include "position.h"
+
+/**
+ * @brief Maximum number of cars in a group.
+ */
+#define DISPATCHER_MAX_NUMBER_OF_CARS 8
+
+/**
+ * @brief Returned instead of a car when a call could not be assigned.
+ */
+#define DISPATCHER_NO_CAR -1
+
+/**
+ * @brief Held instead of a car by a hall call which no car could take yet, see
+ *        #dispatcher_assign_unassigned_hall_calls.
+ */
+#define DISPATCHER_UNASSIGNED_CAR -2
+
+/**
+ * @brief Part of the stop time counted for every stop a car has already committed to.
+ */
+#define DISPATCHER_COMMITTED_STOP_WEIGHT 0.5
+
+/**
+ * @brief What the dispatcher knows about one car.
+ */
+typedef struct {
+    /**
+     * @brief Position of the car, its floor is -1 until the car has found a floor.
+     */
+    Position position;
+
+    /**
+     * @brief The direction the car is travelling in, #HARDWARE_MOVEMENT_STOP when idle.
+     */
+    HardwareMovement direction;
+
+    /**
+     * @brief Floors the car has been asked to stop at from its cab.
+     */
+    bool cab_calls[HARDWARE_MAX_NUMBER_OF_FLOORS];
+
+    /**
+     * @brief Whether the car takes hall calls, see #dispatcher_set_car_in_service.
+     */
+    bool is_in_service;
+} DispatcherCar;
+
+/**
+ * @brief A group of cars.
+ */
+typedef struct {
+    int number_of_floors;
+    int number_of_cars;
+    DispatcherCar cars[DISPATCHER_MAX_NUMBER_OF_CARS];
+
+    /**
+     * @brief The car each hall call is assigned to, indexed by floor and #HardwareOrder, #DISPATCHER_NO_CAR if there
+     *        is no call and #DISPATCHER_UNASSIGNED_CAR if no car could take it yet. The inside column is unused.
+     */
+    int hall_call_cars[HARDWARE_MAX_NUMBER_OF_FLOORS][HARDWARE_NUMBER_OF_BUTTONS];
+
+    /**
+     * @brief Seconds a car takes to travel from one floor to the next.
+     */
+    double travel_time;
+
+    /**
+     * @brief Seconds a stop takes, from slowing down to leaving again.
+     */
+    double stop_time;
+} Dispatcher;
+
+/**
+ * @brief Sets up a group of cars with no calls, with each car in service at an unknown position.
+ *
+ * @param[out] p_dispatcher The dispatcher.
+ * @param[in] number_of_floors Number of floors, at most #HARDWARE_MAX_NUMBER_OF_FLOORS.
+ * @param[in] number_of_cars Number of cars, at most #DISPATCHER_MAX_NUMBER_OF_CARS.
+ * @param[in] travel_time Seconds a car takes to travel from one floor to the next.
+ * @param[in] stop_time Seconds a stop takes.
+ */
+void dispatcher_init(Dispatcher* p_dispatcher,
+                     const int number_of_floors,
+                     const int number_of_cars,
+                     const double travel_time,
+                     const double stop_time);
+
+/**
+ * @brief Updates the position and direction of @p car, should be called by the car every iteration.
+ *
+ * @param[in, out] p_dispatcher The dispatcher.
+ * @param[in] car The car.
+ * @param[in] position The position of the car.
+ * @param[in] direction The direction the car is travelling in, #HARDWARE_MOVEMENT_STOP when idle.
+ */
+void dispatcher_update_car(Dispatcher* p_dispatcher,
+                           const int car,
+                           const Position position,
+                           const HardwareMovement direction);
+
+/**
+ * @brief Estimates the cost of @p car serving a hall call.
+ *
+ * @param[in] p_dispatcher The dispatcher.
+ * @param[in] car The car.
+ * @param[in] floor Floor of the call.
+ * @param[in] direction Direction of the call, #HARDWARE_ORDER_UP or #HARDWARE_ORDER_DOWN.
+ *
+ * @return The cost in seconds, negative if the car can not take calls as it is out of service or its position is
+ *         unknown.
+ */
+double dispatcher_estimate_cost(const Dispatcher* p_dispatcher,
+                                const int car,
+                                const int floor,
+                                const HardwareOrder direction);
+
+/**
+ * @brief Assigns a hall call to the car with the lowest estimated cost. A call which is already assigned stays with
+ *        its car.
+ *
+ * @param[in, out] p_dispatcher The dispatcher.
+ * @param[in] floor Floor of the call.
+ * @param[in] direction Direction of the call, #HARDWARE_ORDER_UP or #HARDWARE_ORDER_DOWN.
+ *
+ * @return The car the call is assigned to, #DISPATCHER_NO_CAR if no car can take it yet. The call is then kept, and
+ *         assigned by #dispatcher_assign_unassigned_hall_calls once a car can take it.
+ */
+int dispatcher_assign_hall_call(Dispatcher* p_dispatcher, const int floor, const HardwareOrder direction);
+
+/**
+ * @brief Assigns the hall calls which no car could take so far, see #dispatcher_assign_hall_call. Should be called
+ *        every iteration, after the cars are updated.
+ *
+ * @param[in, out] p_dispatcher The dispatcher.
+ */
+void dispatcher_assign_unassigned_hall_calls(Dispatcher* p_dispatcher);
+
+/**
+ * @brief Takes @p car in or out of service. A car out of service, e.g. one which is stopped, gets no hall calls. Its
+ *        cab calls are dropped, and the hall calls assigned to it are handed back to be assigned to other cars.
+ *
+ * @param[in, out] p_dispatcher The dispatcher.
+ * @param[in] car The car.
+ * @param[in] is_in_service Whether the car takes calls.
+ */
+void dispatcher_set_car_in_service(Dispatcher* p_dispatcher, const int car, const bool is_in_service);
+
+/**
+ * @brief Adds a call made from the cab of @p car.
+ *
+ * @param[in, out] p_dispatcher The dispatcher.
+ * @param[in] car The car.
+ * @param[in] floor Floor of the call.
+ */
+void dispatcher_add_cab_call(Dispatcher* p_dispatcher, const int car, const int floor);
+
+/**
+ * @brief Removes a call made from the cab of @p car, e.g. one the car did not take.
+ *
+ * @param[in, out] p_dispatcher The dispatcher.
+ * @param[in] car The car.
+ * @param[in] floor Floor of the call.
+ */
+void dispatcher_remove_cab_call(Dispatcher* p_dispatcher, const int car, const int floor);
+
+/**
+ * @brief Clears the calls served by @p car stopping at @p floor: its cab call, and the hall calls at the floor
+ *        assigned to it.
+ *
+ * @param[in, out] p_dispatcher The dispatcher.
+ * @param[in] car The car.
+ * @param[in] floor The floor the car stopped at.
+ */
+void dispatcher_car_served_floor(Dispatcher* p_dispatcher, const int car, const int floor);
+
+/**
+ * @brief Gets the car a hall call is assigned to.
+ *
+ * @param[in] p_dispatcher The dispatcher.
+ * @param[in] floor Floor of the call.
+ * @param[in] direction Direction of the call.
+ *
+ * @return The car, #DISPATCHER_NO_CAR if there is no such call or no car has it yet.
+ */
+int dispatcher_get_hall_call_car(const Dispatcher* p_dispatcher, const int floor, const HardwareOrder direction);
+
+/**
+ * @brief Checks if the shared hall light of a direction at a floor should be lit.
+ *
+ * @param[in] p_dispatcher The dispatcher.
+ * @param[in] floor Floor of the light.
+ * @param[in] direction Direction of the light.
+ *
+ * @return true if any car has the call.
+ */
+bool dispatcher_hall_light_is_on(const Dispatcher* p_dispatcher, const int floor, const HardwareOrder direction);
+
+#endif
@@ -5,42 +5,46 @@
 
 #include "door.h"
 
-#include <time.h>
-#include "hardware.h"
-
 /**
- * @brief Keeps track of the time since we last requested the door to open and autoclose.
- * 
- * @note This time will be reset to the current time if there occurs an obstruction.
+ * @brief Time the door is kept open, in milliseconds.
  */
-static time_t m_door_last_open_and_autoclose_request_time;
+#define DOOR_OPEN_TIME_INTERVAL_MS ((uint64_t)(DOOR_OPEN_TIME_INTERVAL * 1000))
 
 /**
- * @brief Tracks whether the door is open or not. 
+ * @brief Closes the door, called by the close timer of the door when it expires.
+ *
+ * @param[in] p_context The door.
  */
-static bool m_door_is_currenty_open = false;
+static void door_close(void* p_context) {
+    Door* p_door = p_context;
+
+    hardware_backend_command_door_open(p_door->p_hardware, false);
+    p_door->is_open = false;
+}
 
-void door_request_open_and_autoclose() {
-    hardware_command_door_open(1);
-    m_door_last_open_and_autoclose_request_time = time(NULL);
-    m_door_is_currenty_open = true;
+void door_init(Door* p_door, const HardwareBackend* p_hardware, TimerService* p_timers) {
+    p_door->p_hardware = p_hardware;
+    p_door->p_timers = p_timers;
+    p_door->close_timer = TIMER_ID_INVALID;
+    p_door->is_open = false;
 }
 
-void door_update() {
-    if (door_is_open()) {
-        if (hardware_read_obstruction_signal()) {
-            m_door_last_open_and_autoclose_request_time = time(NULL);
-        }
+void door_request_open_and_autoclose(Door* p_door, const uint64_t now_ms) {
+    hardware_backend_command_door_open(p_door->p_hardware, true);
 
-        const time_t interval = time(NULL) - m_door_last_open_and_autoclose_request_time;
+    if (!timer_restart(p_door->p_timers, p_door->close_timer, now_ms, DOOR_OPEN_TIME_INTERVAL_MS)) {
+        p_door->close_timer = timer_start(p_door->p_timers, now_ms, DOOR_OPEN_TIME_INTERVAL_MS, door_close, p_door);
+    }
+
+    p_door->is_open = true;
+}
 
-        if (interval >= DOOR_OPEN_TIME_INTERVAL) {
-            hardware_command_door_open(0);
-            m_door_is_currenty_open = false;
-        }
+void door_update(Door* p_door, const bool obstruction, const uint64_t now_ms) {
+    if (door_is_open(p_door) && obstruction) {
+        timer_restart(p_door->p_timers, p_door->close_timer, now_ms, DOOR_OPEN_TIME_INTERVAL_MS);
     }
 }
 
-bool door_is_open() {
-    return m_door_is_currenty_open;
+bool door_is_open(const Door* p_door) {
+    return p_door->is_open;
 }
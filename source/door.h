@@ -8,32 +8,83 @@
 #define DOOR_H
 
 #include <stdbool.h>
+#include <stdint.h>
+
+#include "hardware_backend.h"
+#include "timer.h"
 
 /**
- * @brief Specifies how long the door should be open given that there is no obstruction.
+ * @brief Specifies how long, in seconds, the door should be open given that there is no obstruction.
  */
 #define DOOR_OPEN_TIME_INTERVAL 3.0
 
+/**
+ * @brief The door of one elevator.
+ */
+typedef struct {
+    /**
+     * @brief The hardware the door is commanded through.
+     */
+    const HardwareBackend* p_hardware;
+
+    /**
+     * @brief The timer service of the elevator, which runs @c close_timer.
+     */
+    TimerService* p_timers;
+
+    /**
+     * @brief The timer closing the door once #DOOR_OPEN_TIME_INTERVAL has passed since we last requested the door
+     *        to open and autoclose.
+     *
+     * @note This timer will be restarted if there occurs an obstruction.
+     */
+    TimerId close_timer;
+
+    /**
+     * @brief Tracks whether the door is open or not.
+     */
+    bool is_open;
+} Door;
+
+/**
+ * @brief Sets up @p p_door as closed.
+ *
+ * @param[out] p_door The door.
+ * @param[in] p_hardware The hardware the door is commanded through, must outlive the door.
+ * @param[in] p_timers The timer service closing the door, must outlive the door.
+ */
+void door_init(Door* p_door, const HardwareBackend* p_hardware, TimerService* p_timers);
+
 /**
  * @brief Will open the door and close it after a number of seconds specified 
  *        by #DOOR_OPEN_TIME_INTERVAL.
+ *
+ * @param[in, out] p_door The door.
+ * @param[in] now_ms The current time, on the time base of the timer service of the door.
+ *
+ * @note The door is closed by a timer, so #timer_expire has to be called for it to close.
  */
-void door_request_open_and_autoclose();
+void door_request_open_and_autoclose(Door* p_door, const uint64_t now_ms);
 
 /**
- * @brief Updates the state of the door and checks whether we should close the door (which happens 
- *        after the time interval specified by #DOOR_OPEN_TIME_INTERVAL).
- * 
+ * @brief Updates the state of the door by checking for obstructions. Should be called before #timer_expire.
+ *
+ * @param[in, out] p_door The door.
+ * @param[in] obstruction Whether the door is obstructed.
+ * @param[in] now_ms The current time, on the time base of the timer service of the door.
+ *
  * @note If there is an obstruction the timer will be reset and the door will try to close
  *       again after #DOOR_OPEN_TIME_INTERVAL.
  */
-void door_update();
+void door_update(Door* p_door, const bool obstruction, const uint64_t now_ms);
 
 /**
  * @brief Indicates whether the door is open or not.
- * 
+ *
+ * @param[in] p_door The door.
+ *
  * @return Whether the door is open.
  */
-bool door_is_open();
+bool door_is_open(const Door* p_door);
 
 #endif
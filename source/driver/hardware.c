@@ -1,12 +1,21 @@
 #include "hardware.h"
 #include "channels.h"
 #include "io.h"
+#include "hardware_shadow.h"
 
+#include <limits.h>
 #include <stdlib.h>
+#include <string.h>
+
+// The lab rig is wired for four floors, see channels.h
+#define HARDWARE_RIG_NUMBER_OF_FLOORS 4
+
+// Subdevices of the rig's I/O card, PORT0 to PORT4 in channels.h
+#define HARDWARE_RIG_NUMBER_OF_SUBDEVICES 4
 
 static int hardware_legal_floor(int floor, HardwareOrder order_type){
     int lower_floor = 0;
-    int upper_floor = HARDWARE_NUMBER_OF_FLOORS - 1;
+    int upper_floor = HARDWARE_RIG_NUMBER_OF_FLOORS - 1;
 
     if(floor < lower_floor || floor > upper_floor){
         return 0;
@@ -48,17 +57,10 @@ int hardware_init(){
         return 1;
     }
 
-    for(int i = 0; i < HARDWARE_NUMBER_OF_FLOORS; i++){
-        if(i != 0){
-            hardware_command_order_light(HARDWARE_ORDER_DOWN, i, 0);
-        }
+    hardware_shadow_reset();
 
-        if(i != HARDWARE_NUMBER_OF_FLOORS - 1){
-            hardware_command_order_light(HARDWARE_ORDER_UP, i, 0);
-        }
-
-        hardware_command_order_light(HARDWARE_ORDER_INSIDE, i, 0);
-    }
+    const uint64_t no_lights[HARDWARE_NUMBER_OF_ORDER_WORDS] = {0};
+    hardware_command_lights_bulk(no_lights, NULL);
 
     hardware_command_stop_light(0);
     hardware_command_door_open(0);
@@ -67,56 +69,133 @@ int hardware_init(){
     return 0;
 }
 
+int hardware_set_number_of_floors(int number_of_floors){
+    return number_of_floors != HARDWARE_RIG_NUMBER_OF_FLOORS;
+}
+
+int hardware_get_number_of_floors(){
+    return HARDWARE_RIG_NUMBER_OF_FLOORS;
+}
+
+int hardware_start_input_acquisition(unsigned int scan_period_us){
+    // Comedi takes the period in nanoseconds, in an unsigned int
+    if(scan_period_us > UINT_MAX / 1000){
+        return 1;
+    }
+
+    return !io_start_acquisition(scan_period_us * 1000);
+}
+
+int hardware_event_fd(){
+    return io_acquisition_fd();
+}
+
 void hardware_command_movement(HardwareMovement movement){
     switch(movement){
         case HARDWARE_MOVEMENT_UP:
-            io_clear_bit(MOTORDIR);
-            io_write_analog(MOTOR, 2800);
+            if(hardware_shadow_update(HARDWARE_SHADOW_MOTOR_DIRECTION, 0)){
+                io_clear_bit(MOTORDIR);
+            }
+            if(hardware_shadow_update(HARDWARE_SHADOW_MOTOR_SPEED, 2800)){
+                io_write_analog(MOTOR, 2800);
+            }
             break;
 
         case HARDWARE_MOVEMENT_STOP:
-            io_write_analog(MOTOR, 0);
+            if(hardware_shadow_update(HARDWARE_SHADOW_MOTOR_SPEED, 0)){
+                io_write_analog(MOTOR, 0);
+            }
             break;
 
-        case HARDWARE_ORDER_DOWN:
-            io_set_bit(MOTORDIR);
-            io_write_analog(MOTOR, 2800);
+        case HARDWARE_MOVEMENT_DOWN:
+            if(hardware_shadow_update(HARDWARE_SHADOW_MOTOR_DIRECTION, 1)){
+                io_set_bit(MOTORDIR);
+            }
+            if(hardware_shadow_update(HARDWARE_SHADOW_MOTOR_SPEED, 2800)){
+                io_write_analog(MOTOR, 2800);
+            }
             break;
     }
 }
 
-int hardware_read_stop_signal(){
-    return io_read_bit(STOP);
+// The inputs of the rig live on two subdevices, see channels.h. An image holds
+// both ports as read with one comedi_dio_bitfield2 call each, and every input
+// is decoded from it, so a snapshot costs two reads instead of one per input.
+typedef struct {
+    unsigned int port1;
+    unsigned int port4;
+} HardwarePortImage;
+
+static void hardware_read_port(HardwarePortImage* p_image, int subdevice){
+    if(subdevice == PORT1){
+        p_image->port1 = io_read_port(PORT1);
+    }
+    else{
+        p_image->port4 = io_read_port(PORT4);
+    }
 }
 
-int hardware_read_obstruction_signal(){
-    return io_read_bit(OBSTRUCTION);
+static void hardware_read_port_image(HardwarePortImage* p_image){
+    hardware_read_port(p_image, PORT1);
+    hardware_read_port(p_image, PORT4);
 }
 
-int hardware_read_floor_sensor(int floor){
-    int floor_bit;
-    switch(floor){
-        case 0:
-            floor_bit = SENSOR_FLOOR1;
-            break;
+static int hardware_decode_channel(const HardwarePortImage* p_image, int channel){
+    const unsigned int port = (channel >> 8) == PORT1 ? p_image->port1 : p_image->port4;
 
-        case 1:
-            floor_bit = SENSOR_FLOOR2;
-            break;
+    return (port >> (channel & 0xff)) & 1;
+}
 
-        case 2:
-            floor_bit = SENSOR_FLOOR3;
-            break;
+static int hardware_order_channel(int floor, HardwareOrder order_type){
+    static const int order_bit_lookup[][3] = {
+        {BUTTON_UP1, BUTTON_DOWN1, BUTTON_COMMAND1},
+        {BUTTON_UP2, BUTTON_DOWN2, BUTTON_COMMAND2},
+        {BUTTON_UP3, BUTTON_DOWN3, BUTTON_COMMAND3},
+        {BUTTON_UP4, BUTTON_DOWN4, BUTTON_COMMAND4}
+    };
 
-        case 3:
-            floor_bit = SENSOR_FLOOR4;
-            break;
+    return order_bit_lookup[floor][hardware_order_type_bit(order_type)];
+}
+
+static int hardware_decode_current_floor(const HardwarePortImage* p_image){
+    const unsigned int sensor_bits = (p_image->port1 >> (SENSOR_FLOOR1 & 0xff)) & 0x0f;
+
+    if(!sensor_bits){
+        return -1;
+    }
 
-        default:
-            return 0;
+    return __builtin_ctz(sensor_bits);
+}
+
+// Reads only the port holding channel, and decodes the channel from it
+static int hardware_read_channel(int channel){
+    HardwarePortImage image = {0};
+    hardware_read_port(&image, channel >> 8);
+
+    return hardware_decode_channel(&image, channel);
+}
+
+int hardware_read_stop_signal(){
+    return hardware_read_channel(STOP);
+}
+
+int hardware_read_obstruction_signal(){
+    return hardware_read_channel(OBSTRUCTION);
+}
+
+int hardware_read_floor_sensor(int floor){
+    if(floor < 0 || floor >= HARDWARE_RIG_NUMBER_OF_FLOORS){
+        return 0;
     }
 
-    return io_read_bit(floor_bit);
+    return hardware_read_channel(SENSOR_FLOOR1 + floor);
+}
+
+int hardware_read_current_floor(){
+    HardwarePortImage image = {0};
+    hardware_read_port(&image, SENSOR_FLOOR1 >> 8);
+
+    return hardware_decode_current_floor(&image);
 }
 
 int hardware_read_order(int floor, HardwareOrder order_type){
@@ -124,19 +203,41 @@ int hardware_read_order(int floor, HardwareOrder order_type){
         return 0;
     }
 
-    static const int order_bit_lookup[][3] = {
-        {BUTTON_UP1, BUTTON_DOWN1, BUTTON_COMMAND1},
-        {BUTTON_UP2, BUTTON_DOWN2, BUTTON_COMMAND2},
-        {BUTTON_UP3, BUTTON_DOWN3, BUTTON_COMMAND3},
-        {BUTTON_UP4, BUTTON_DOWN4, BUTTON_COMMAND4}
-    };
+    return hardware_read_channel(hardware_order_channel(floor, order_type));
+}
+
+void hardware_read_snapshot(HardwareSnapshot* p_snapshot){
+    // The samples of the acquisition only tell that something changed,
+    // the inputs themselves are read from the ports below
+    io_drain_acquisition();
+
+    HardwarePortImage image;
+    hardware_read_port_image(&image);
+
+    memset(p_snapshot->orders, 0, sizeof(p_snapshot->orders));
 
-    int type_bit = hardware_order_type_bit(order_type);
+    for(int floor = 0; floor < HARDWARE_RIG_NUMBER_OF_FLOORS; floor++){
+        for(HardwareOrder order_type = HARDWARE_ORDER_UP; order_type <= HARDWARE_ORDER_DOWN; order_type++){
+            if(!hardware_legal_floor(floor, order_type)){
+                continue;
+            }
 
-    return io_read_bit(order_bit_lookup[floor][type_bit]);
+            if(hardware_decode_channel(&image, hardware_order_channel(floor, order_type))){
+                p_snapshot->orders[HARDWARE_ORDER_WORD(floor, order_type)] |= HARDWARE_ORDER_BIT(floor, order_type);
+            }
+        }
+    }
+
+    p_snapshot->floor = hardware_decode_current_floor(&image);
+    p_snapshot->stop_signal = hardware_decode_channel(&image, STOP);
+    p_snapshot->obstruction_signal = hardware_decode_channel(&image, OBSTRUCTION);
 }
 
 void hardware_command_door_open(int door_open){
+    if(!hardware_shadow_update(HARDWARE_SHADOW_DOOR, door_open != 0)){
+        return;
+    }
+
     if(door_open){
         io_set_bit(LIGHT_DOOR_OPEN);
     }
@@ -146,6 +247,10 @@ void hardware_command_door_open(int door_open){
 }
 
 void hardware_command_floor_indicator_on(int floor){
+    if(!hardware_shadow_update(HARDWARE_SHADOW_FLOOR_INDICATOR, floor)){
+        return;
+    }
+
     if(floor & 0x02){
         io_set_bit(LIGHT_FLOOR_IND1);
     }
@@ -162,6 +267,10 @@ void hardware_command_floor_indicator_on(int floor){
 }
 
 void hardware_command_stop_light(int on){
+    if(!hardware_shadow_update(HARDWARE_SHADOW_STOP_LIGHT, on != 0)){
+        return;
+    }
+
     if(on){
         io_set_bit(LIGHT_STOP);
     }
@@ -170,11 +279,7 @@ void hardware_command_stop_light(int on){
     }
 }
 
-void hardware_command_order_light(int floor, HardwareOrder order_type, int on){
-    if(!hardware_legal_floor(floor, order_type)){
-        return;
-    }
-
+static int hardware_light_channel(int floor, HardwareOrder order_type){
     static const int light_bit_lookup[][3] = {
         {LIGHT_UP1, LIGHT_DOWN1, LIGHT_COMMAND1},
         {LIGHT_UP2, LIGHT_DOWN2, LIGHT_COMMAND2},
@@ -182,12 +287,70 @@ void hardware_command_order_light(int floor, HardwareOrder order_type, int on){
         {LIGHT_UP4, LIGHT_DOWN4, LIGHT_COMMAND4}
     };
 
-    int type_bit = hardware_order_type_bit(order_type);
+    return light_bit_lookup[floor][hardware_order_type_bit(order_type)];
+}
+
+void hardware_command_order_light(int floor, HardwareOrder order_type, int on){
+    if(!hardware_legal_floor(floor, order_type)){
+        return;
+    }
+
+    if(!hardware_shadow_update(hardware_shadow_order_light(floor, order_type), on != 0)){
+        return;
+    }
 
     if(on){
-        io_set_bit(light_bit_lookup[floor][type_bit]);
+        io_set_bit(hardware_light_channel(floor, order_type));
     }
     else{
-        io_clear_bit(light_bit_lookup[floor][type_bit]);
+        io_clear_bit(hardware_light_channel(floor, order_type));
     }
 }
+
+void hardware_command_lights_bulk(const uint64_t* p_lights, const uint64_t* p_mask){
+    // The lights which change are gathered per subdevice, and each subdevice
+    // is written with one masked comedi_dio_bitfield2 call. Every light of
+    // the rig is on the same subdevice, see channels.h.
+    unsigned int subdevice_masks[HARDWARE_RIG_NUMBER_OF_SUBDEVICES] = {0};
+    unsigned int subdevice_bits[HARDWARE_RIG_NUMBER_OF_SUBDEVICES] = {0};
+
+    for(int floor = 0; floor < HARDWARE_RIG_NUMBER_OF_FLOORS; floor++){
+        for(HardwareOrder order_type = HARDWARE_ORDER_UP; order_type <= HARDWARE_ORDER_DOWN; order_type++){
+            const int word = HARDWARE_ORDER_WORD(floor, order_type);
+            const uint64_t bit = HARDWARE_ORDER_BIT(floor, order_type);
+
+            if(!hardware_legal_floor(floor, order_type) || (p_mask && !(p_mask[word] & bit))){
+                continue;
+            }
+
+            const int on = (p_lights[word] & bit) != 0;
+            if(!hardware_shadow_update(hardware_shadow_order_light(floor, order_type), on)){
+                continue;
+            }
+
+            const int channel = hardware_light_channel(floor, order_type);
+            subdevice_masks[channel >> 8] |= 1u << (channel & 0xff);
+            if(on){
+                subdevice_bits[channel >> 8] |= 1u << (channel & 0xff);
+            }
+        }
+    }
+
+    for(int subdevice = 0; subdevice < HARDWARE_RIG_NUMBER_OF_SUBDEVICES; subdevice++){
+        if(subdevice_masks[subdevice]){
+            io_write_port(subdevice, subdevice_masks[subdevice], subdevice_bits[subdevice]);
+        }
+    }
+}
+
+void hardware_set_command_buffering(int enabled){
+    // Every command is written immediately, there is nothing to buffer
+    (void)(enabled);
+}
+
+void hardware_flush(){
+}
+
+void hardware_get_output_statistics(HardwareOutputStatistics* p_statistics){
+    hardware_shadow_get_statistics(p_statistics);
+}
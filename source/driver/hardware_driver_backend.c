@@ -0,0 +1,65 @@
+// Hardware backend forwarding to the linked driver, shared by all drivers.
+#include <stddef.h>
+
+#include "hardware.h"
+#include "hardware_backend.h"
+
+static void hardware_driver_backend_command_movement(void* p_context, const HardwareMovement movement) {
+    (void)p_context;
+    hardware_command_movement(movement);
+}
+
+
+static void hardware_driver_backend_command_order_light(void* p_context,
+                                                        const int floor,
+                                                        const HardwareOrder order_type,
+                                                        const bool on) {
+    (void)p_context;
+    hardware_command_order_light(floor, order_type, on);
+}
+
+
+static void hardware_driver_backend_command_order_lights(void* p_context,
+                                                         const uint64_t* p_lights,
+                                                         const uint64_t* p_mask) {
+    (void)p_context;
+    hardware_command_lights_bulk(p_lights, p_mask);
+}
+
+
+static void hardware_driver_backend_command_floor_indicator_on(void* p_context, const int floor) {
+    (void)p_context;
+    hardware_command_floor_indicator_on(floor);
+}
+
+
+static void hardware_driver_backend_command_door_open(void* p_context, const bool door_open) {
+    (void)p_context;
+    hardware_command_door_open(door_open);
+}
+
+
+static void hardware_driver_backend_command_stop_light(void* p_context, const bool on) {
+    (void)p_context;
+    hardware_command_stop_light(on);
+}
+
+
+static const HardwareBackendOperations operations = {
+    .command_movement = hardware_driver_backend_command_movement,
+    .command_order_light = hardware_driver_backend_command_order_light,
+    .command_floor_indicator_on = hardware_driver_backend_command_floor_indicator_on,
+    .command_door_open = hardware_driver_backend_command_door_open,
+    .command_stop_light = hardware_driver_backend_command_stop_light,
+    .command_order_lights = hardware_driver_backend_command_order_lights,
+};
+
+
+
+HardwareBackend hardware_backend_driver(void) {
+    return (HardwareBackend) {
+        .p_operations = &operations,
+        .p_context = NULL,
+        .number_of_floors = hardware_get_number_of_floors(),
+    };
+}
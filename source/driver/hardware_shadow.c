@@ -0,0 +1,34 @@
+#include "hardware_shadow.h"
+
+// Value used for outputs whose state is not known
+#define HARDWARE_SHADOW_UNKNOWN -1
+
+static int m_shadow[HARDWARE_SHADOW_NUMBER_OF_OUTPUTS];
+static unsigned long m_shadow_writes_issued = 0;
+static unsigned long m_shadow_writes_suppressed = 0;
+
+HardwareShadowOutput hardware_shadow_order_light(int floor, HardwareOrder order_type){
+    return (HardwareShadowOutput)(floor * HARDWARE_NUMBER_OF_BUTTONS + order_type);
+}
+
+void hardware_shadow_reset(){
+    for(int i = 0; i < HARDWARE_SHADOW_NUMBER_OF_OUTPUTS; i++){
+        m_shadow[i] = HARDWARE_SHADOW_UNKNOWN;
+    }
+}
+
+int hardware_shadow_update(HardwareShadowOutput output, int value){
+    if(m_shadow[output] == value){
+        m_shadow_writes_suppressed++;
+        return 0;
+    }
+
+    m_shadow[output] = value;
+    m_shadow_writes_issued++;
+    return 1;
+}
+
+void hardware_shadow_get_statistics(HardwareOutputStatistics* p_statistics){
+    p_statistics->writes_issued = m_shadow_writes_issued;
+    p_statistics->writes_suppressed = m_shadow_writes_suppressed;
+}
@@ -0,0 +1,60 @@
+// Shadow copy of the elevator outputs.
+// Both drivers keep the last value written to every output here, and only
+// pass a command on to the hardware when it changes an output.
+#ifndef __INCLUDE_DRIVER_HARDWARE_SHADOW_H__
+#define __INCLUDE_DRIVER_HARDWARE_SHADOW_H__
+
+#include "hardware.h"
+
+/**
+  Outputs kept in the shadow. The order lights come first, one per
+  floor and order type up to HARDWARE_MAX_NUMBER_OF_FLOORS, followed
+  by the other outputs.
+*/
+typedef enum {
+    HARDWARE_SHADOW_FLOOR_INDICATOR = HARDWARE_MAX_NUMBER_OF_FLOORS * HARDWARE_NUMBER_OF_BUTTONS,
+    HARDWARE_SHADOW_DOOR,
+    HARDWARE_SHADOW_STOP_LIGHT,
+    HARDWARE_SHADOW_MOTOR_DIRECTION,
+    HARDWARE_SHADOW_MOTOR_SPEED,
+    HARDWARE_SHADOW_NUMBER_OF_OUTPUTS
+} HardwareShadowOutput;
+
+
+
+/**
+  Gets the shadow output of an order light.
+  @param floor Floor of the order light.
+  @param order_type Order type of the order light.
+  @return The shadow output.
+*/
+HardwareShadowOutput hardware_shadow_order_light(int floor, HardwareOrder order_type);
+
+
+
+/**
+  Marks every output as unknown, so the next write to each of them
+  reaches the hardware.
+*/
+void hardware_shadow_reset();
+
+
+
+/**
+  Records a write to an output, and counts it as issued or suppressed.
+  @param output Output to write.
+  @param value Value to write.
+  @return 1 if the value differs from the shadow and must be written
+  to the hardware, 0 if the write can be suppressed.
+*/
+int hardware_shadow_update(HardwareShadowOutput output, int value);
+
+
+
+/**
+  Gets the number of writes issued to and suppressed from the hardware.
+  @param p_statistics Statistics to fill.
+*/
+void hardware_shadow_get_statistics(HardwareOutputStatistics* p_statistics);
+
+#endif // #ifndef __INCLUDE_DRIVER_HARDWARE_SHADOW_H__
@@ -1,14 +1,84 @@
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/socket.h>
 #include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <stdio.h>
 #include <pthread.h>
 
 #include "hardware.h"
+#include "hardware_shadow.h"
 
 static int sockfd;
 static pthread_mutex_t sockmtx;
+static int number_of_floors = HARDWARE_DEFAULT_NUMBER_OF_FLOORS;
+
+// Commands written while buffering is enabled are kept here until
+// hardware_flush(), so that they all go out in a single send.
+#define HARDWARE_SIM_COMMAND_BUFFER_SIZE 64
+
+static char command_buffer[HARDWARE_SIM_COMMAND_BUFFER_SIZE][4];
+static int number_of_buffered_commands = 0;
+static int command_buffering = 0;
+
+static void hardware_sim_send_all(const void* data, size_t length) {
+    const char* p_data = data;
+    while (length > 0) {
+        ssize_t sent = send(sockfd, p_data, length, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return;
+        }
+        p_data += sent;
+        length -= sent;
+    }
+}
+
+// Must be called with sockmtx held
+static void hardware_sim_flush_locked(void) {
+    if (number_of_buffered_commands > 0) {
+        hardware_sim_send_all(command_buffer, number_of_buffered_commands * sizeof(command_buffer[0]));
+        number_of_buffered_commands = 0;
+    }
+}
+
+static void hardware_sim_recv_all(void* data, size_t length) {
+    char* p_data = data;
+    while (length > 0) {
+        ssize_t received = recv(sockfd, p_data, length, 0);
+        if (received <= 0) {
+            memset(p_data, 0, length);
+            return;
+        }
+        p_data += received;
+        length -= received;
+    }
+}
+
+// Writes all requests at once and then reads the replies in order, so a
+// batch of reads costs a single round trip. Every request gets a 4 byte
+// reply.
+static void hardware_sim_request(const char (*requests)[4], char (*replies)[4], int number_of_requests) {
+    pthread_mutex_lock(&sockmtx);
+    hardware_sim_flush_locked();
+    hardware_sim_send_all(requests, number_of_requests * sizeof(requests[0]));
+    hardware_sim_recv_all(replies, number_of_requests * sizeof(replies[0]));
+    pthread_mutex_unlock(&sockmtx);
+}
+
+static void hardware_sim_send_command(const char command[4]) {
+    pthread_mutex_lock(&sockmtx);
+    if (command_buffering) {
+        if (number_of_buffered_commands == HARDWARE_SIM_COMMAND_BUFFER_SIZE) {
+            hardware_sim_flush_locked();
+        }
+        memcpy(command_buffer[number_of_buffered_commands++], command, 4);
+    } else {
+        hardware_sim_send_all(command, 4);
+    }
+    pthread_mutex_unlock(&sockmtx);
+}
 
 int hardware_movement_to_legacy(HardwareMovement hardware_movement)
 {
@@ -46,6 +116,7 @@ int hardware_init() {
     char port[8] = "15657";
 
     pthread_mutex_init(&sockmtx, NULL);
+    hardware_shadow_reset();
 
     sockfd = socket(AF_INET, SOCK_STREAM, 0);
     assert(sockfd != -1 && "Unable to set up socket");
@@ -61,6 +132,11 @@ int hardware_init() {
     int fail = connect(sockfd, res->ai_addr, res->ai_addrlen);
     assert(fail == 0 && "Unable to connect to simulator server");
 
+    // Every request is answered before the next is sent, so waiting for
+    // more data to fill a segment only adds latency
+    int nodelay = 1;
+    setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
     freeaddrinfo(res);
 
     send(sockfd, (char[4]) {0}, 4, 0);
@@ -70,86 +146,248 @@ int hardware_init() {
 
 
 
+int hardware_set_number_of_floors(int floors) {
+    if (floors < 2 || floors > HARDWARE_MAX_NUMBER_OF_FLOORS) {
+        return 1;
+    }
+
+    number_of_floors = floors;
+    return 0;
+}
+
+
+int hardware_get_number_of_floors(void) {
+    return number_of_floors;
+}
+
+
+int hardware_start_input_acquisition(unsigned int scan_period_us) {
+    // The simulator only ever answers requests, so the inputs must be polled
+    (void)scan_period_us;
+    return 1;
+}
+
+
+// The socket only carries replies to our own requests, and is readable
+// for good with EOF once the simulator closes it, so it is no use as a
+// notification of new input. The inputs must be polled.
+int hardware_event_fd(void) {
+    return -1;
+}
+
 
 void hardware_command_movement(HardwareMovement movement) {
-    pthread_mutex_lock(&sockmtx);
-    send(sockfd, (char[4]) {1, hardware_movement_to_legacy(movement)}, 4, 0);
-    pthread_mutex_unlock(&sockmtx);
+    int direction_changed = hardware_shadow_update(HARDWARE_SHADOW_MOTOR_DIRECTION, hardware_movement_to_legacy(movement));
+    int speed_changed = hardware_shadow_update(HARDWARE_SHADOW_MOTOR_SPEED, movement != HARDWARE_MOVEMENT_STOP);
+    if (!direction_changed && !speed_changed) {
+        return;
+    }
+
+    hardware_sim_send_command((char[4]) {1, hardware_movement_to_legacy(movement)});
 }
 
 
 void hardware_command_order_light(int floor, HardwareOrder order_type, int on) {
     assert(floor >= 0);
-    assert(floor < HARDWARE_NUMBER_OF_FLOORS);
+    assert(floor < number_of_floors);
     assert(order_type >= 0);
     assert(order_type < HARDWARE_NUMBER_OF_BUTTONS);
 
+    if (!hardware_shadow_update(hardware_shadow_order_light(floor, order_type), on != 0)) {
+        return;
+    }
+
+    hardware_sim_send_command((char[4]) {2, hardware_order_to_legacy(order_type), floor, on});
+}
+
+
+void hardware_command_lights_bulk(const uint64_t* p_lights, const uint64_t* p_mask) {
+    // The protocol has no bulk command, but the lights which change are
+    // buffered and sent in a single write
     pthread_mutex_lock(&sockmtx);
-    send(sockfd, (char[4]) {2, hardware_order_to_legacy(order_type), floor, on}, 4, 0);
+    const int was_buffering = command_buffering;
+    command_buffering = 1;
     pthread_mutex_unlock(&sockmtx);
+
+    for (int floor = 0; floor < number_of_floors; floor++) {
+        for (HardwareOrder order_type = HARDWARE_ORDER_UP; order_type <= HARDWARE_ORDER_DOWN; order_type++) {
+            const int word = HARDWARE_ORDER_WORD(floor, order_type);
+            const uint64_t bit = HARDWARE_ORDER_BIT(floor, order_type);
+
+            if (!p_mask || (p_mask[word] & bit)) {
+                hardware_command_order_light(floor, order_type, (p_lights[word] & bit) != 0);
+            }
+        }
+    }
+
+    if (!was_buffering) {
+        hardware_set_command_buffering(0);
+    }
 }
 
 
 void hardware_command_floor_indicator_on(int floor) {
     assert(floor >= 0);
-    assert(floor < HARDWARE_NUMBER_OF_FLOORS);
+    assert(floor < number_of_floors);
 
-    pthread_mutex_lock(&sockmtx);
-    send(sockfd, (char[4]) {3, floor}, 4, 0);
-    pthread_mutex_unlock(&sockmtx);
+    if (!hardware_shadow_update(HARDWARE_SHADOW_FLOOR_INDICATOR, floor)) {
+        return;
+    }
+
+    hardware_sim_send_command((char[4]) {3, floor});
 }
 
 
 void hardware_command_door_open(int door_open) {
-    pthread_mutex_lock(&sockmtx);
-    send(sockfd, (char[4]) {4, door_open}, 4, 0);
-    pthread_mutex_unlock(&sockmtx);
+    if (!hardware_shadow_update(HARDWARE_SHADOW_DOOR, door_open != 0)) {
+        return;
+    }
+
+    hardware_sim_send_command((char[4]) {4, door_open});
 }
 
 
 void hardware_command_stop_light(int on) {
-    pthread_mutex_lock(&sockmtx);
-    send(sockfd, (char[4]) {5, on}, 4, 0);
-    pthread_mutex_unlock(&sockmtx);
+    if (!hardware_shadow_update(HARDWARE_SHADOW_STOP_LIGHT, on != 0)) {
+        return;
+    }
+
+    hardware_sim_send_command((char[4]) {5, on});
 }
 
 
 
 int hardware_read_order(int floor, HardwareOrder order_type) {
-    pthread_mutex_lock(&sockmtx);
-    send(sockfd, (char[4]) {6, hardware_order_to_legacy(order_type), floor}, 4, 0);
-    char buf[4];
-    recv(sockfd, buf, 4, 0);
-    pthread_mutex_unlock(&sockmtx);
-    return buf[1];
+    char reply[1][4];
+    hardware_sim_request((char[1][4]) {{6, hardware_order_to_legacy(order_type), floor}}, reply, 1);
+    return reply[0][1];
 }
 
 
 int hardware_read_floor_sensor(int floor) {
+    char reply[1][4];
+    hardware_sim_request((char[1][4]) {{7}}, reply, 1);
+    return reply[0][1] ? (unsigned char)reply[0][2] == floor : 0;
+}
+
+
+int hardware_read_current_floor(void) {
+    char reply[1][4];
+    hardware_sim_request((char[1][4]) {{7}}, reply, 1);
+    return reply[0][1] ? (unsigned char)reply[0][2] : -1;
+}
+
+
+int hardware_read_stop_signal(void) {
+    char reply[1][4];
+    hardware_sim_request((char[1][4]) {{8}}, reply, 1);
+    return reply[0][1];
+}
+
+
+int hardware_read_obstruction_signal(void) {
+    char reply[1][4];
+    hardware_sim_request((char[1][4]) {{9}}, reply, 1);
+    return reply[0][1];
+}
+
+
+// Bulk state request. The reply is a 4 byte header {10, at_floor, floor,
+// stop | obstruction << 1} followed by one byte per floor holding the
+// order buttons, bit n set for legacy order type n, so every input is
+// read in one exchange whatever the number of floors. The server must be
+// started with the same number of floors. The stock simulator server does
+// not know this opcode, so it is only used when built with
+// -DHARDWARE_SIM_BULK_READ.
+#define HARDWARE_SIM_OPCODE_SNAPSHOT 10
+
+void hardware_read_snapshot(HardwareSnapshot* p_snapshot) {
+    memset(p_snapshot->orders, 0, sizeof(p_snapshot->orders));
+
+#ifdef HARDWARE_SIM_BULK_READ
+    unsigned char buf[4 + HARDWARE_MAX_NUMBER_OF_FLOORS];
+
     pthread_mutex_lock(&sockmtx);
-    send(sockfd, (char[4]) {7}, 4, 0);
-    char buf[4];
-    recv(sockfd, buf, 4, 0);
+    hardware_sim_flush_locked();
+    hardware_sim_send_all((char[4]) {HARDWARE_SIM_OPCODE_SNAPSHOT}, 4);
+    hardware_sim_recv_all(buf, 4 + number_of_floors);
     pthread_mutex_unlock(&sockmtx);
-    return buf[1] ? buf[2] == floor : 0;
+
+    p_snapshot->floor = buf[1] ? buf[2] : -1;
+    p_snapshot->stop_signal = buf[3] & 0x01;
+    p_snapshot->obstruction_signal = (buf[3] >> 1) & 0x01;
+
+    for (int floor = 0; floor < number_of_floors; floor++) {
+        if (!buf[4 + floor]) {
+            continue;
+        }
+        for (HardwareOrder order_type = HARDWARE_ORDER_UP; order_type <= HARDWARE_ORDER_DOWN; order_type++) {
+            if (buf[4 + floor] & (1 << hardware_order_to_legacy(order_type))) {
+                p_snapshot->orders[HARDWARE_ORDER_WORD(floor, order_type)] |= HARDWARE_ORDER_BIT(floor, order_type);
+            }
+        }
+    }
+#else
+    // One order request per button, followed by floor, stop and obstruction,
+    // all pipelined in a single round trip. The stock protocol has no
+    // other way to read the buttons, so tall buildings should use the bulk
+    // request above.
+    enum {
+        MAX_NUMBER_OF_REQUESTS = HARDWARE_MAX_NUMBER_OF_FLOORS * HARDWARE_NUMBER_OF_BUTTONS + 3
+    };
+
+    const int number_of_order_requests = number_of_floors * HARDWARE_NUMBER_OF_BUTTONS;
+    const int floor_request = number_of_order_requests;
+    const int stop_request = floor_request + 1;
+    const int obstruction_request = floor_request + 2;
+    const int number_of_requests = floor_request + 3;
+
+    char requests[MAX_NUMBER_OF_REQUESTS][4];
+    char replies[MAX_NUMBER_OF_REQUESTS][4];
+    memset(requests, 0, number_of_requests * sizeof(requests[0]));
+
+    for (int floor = 0; floor < number_of_floors; floor++) {
+        for (HardwareOrder order_type = HARDWARE_ORDER_UP; order_type <= HARDWARE_ORDER_DOWN; order_type++) {
+            char* request = requests[HARDWARE_ORDER_INDEX(floor, order_type)];
+            request[0] = 6;
+            request[1] = hardware_order_to_legacy(order_type);
+            request[2] = floor;
+        }
+    }
+    requests[floor_request][0] = 7;
+    requests[stop_request][0] = 8;
+    requests[obstruction_request][0] = 9;
+
+    hardware_sim_request(requests, replies, number_of_requests);
+
+    for (int i = 0; i < number_of_order_requests; i++) {
+        if (replies[i][1]) {
+            p_snapshot->orders[i / 64] |= UINT64_C(1) << (i % 64);
+        }
+    }
+
+    p_snapshot->floor = replies[floor_request][1] ? (unsigned char)replies[floor_request][2] : -1;
+    p_snapshot->stop_signal = replies[stop_request][1];
+    p_snapshot->obstruction_signal = replies[obstruction_request][1];
+#endif
 }
 
 
-int hardware_read_stop_signal(void) {
+void hardware_get_output_statistics(HardwareOutputStatistics* p_statistics) {
+    hardware_shadow_get_statistics(p_statistics);
+}
+
+
+void hardware_set_command_buffering(int enabled) {
     pthread_mutex_lock(&sockmtx);
-    send(sockfd, (char[4]) {8}, 4, 0);
-    char buf[4];
-    recv(sockfd, buf, 4, 0);
+    hardware_sim_flush_locked();
+    command_buffering = enabled;
     pthread_mutex_unlock(&sockmtx);
-    return buf[1];
 }
 
 
-int hardware_read_obstruction_signal(void) {
+void hardware_flush(void) {
     pthread_mutex_lock(&sockmtx);
-    send(sockfd, (char[4]) {9}, 4, 0);
-    char buf[4];
-    recv(sockfd, buf, 4, 0);
+    hardware_sim_flush_locked();
     pthread_mutex_unlock(&sockmtx);
-    return buf[1];
 }
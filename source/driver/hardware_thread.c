@@ -0,0 +1,284 @@
+// Dedicated I/O thread for the linked driver, shared by all drivers.
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hardware.h"
+#include "hardware_backend.h"
+#include "hardware_channel.h"
+#include "hardware_thread.h"
+
+static HardwareSnapshotSeqlock m_snapshot;
+static HardwareCommandRing m_commands;
+
+static pthread_t m_thread;
+static atomic_bool m_running;
+static unsigned int m_poll_period_us;
+
+// Written by the elevator to wake the I/O thread when it publishes commands
+static int m_wake_fd = -1;
+
+// Written by the I/O thread when it publishes new inputs
+static int m_input_fd = -1;
+
+
+static void hardware_thread_signal_fd(int fd) {
+    const uint64_t one = 1;
+    while (write(fd, &one, sizeof(one)) == -1 && errno == EINTR) {
+    }
+}
+
+
+// Order lights are gathered into bitmaps while they follow each other, and
+// written with hardware_command_lights_bulk before any other command
+static void hardware_thread_apply_commands(void) {
+    uint64_t lights[HARDWARE_NUMBER_OF_ORDER_WORDS] = {0};
+    uint64_t light_mask[HARDWARE_NUMBER_OF_ORDER_WORDS] = {0};
+    bool has_lights = false;
+
+    HardwareCommand command;
+    while (hardware_command_ring_pop(&m_commands, &command)) {
+        if (command.type == HARDWARE_COMMAND_ORDER_LIGHT) {
+            const int word = HARDWARE_ORDER_WORD(command.floor, command.order_type);
+            const uint64_t bit = HARDWARE_ORDER_BIT(command.floor, command.order_type);
+
+            light_mask[word] |= bit;
+            lights[word] = command.value ? lights[word] | bit : lights[word] & ~bit;
+            has_lights = true;
+            continue;
+        }
+
+        if (has_lights) {
+            hardware_command_lights_bulk(lights, light_mask);
+            memset(lights, 0, sizeof(lights));
+            memset(light_mask, 0, sizeof(light_mask));
+            has_lights = false;
+        }
+
+        switch (command.type) {
+            case HARDWARE_COMMAND_MOVEMENT:
+                hardware_command_movement((HardwareMovement)command.value);
+                break;
+            case HARDWARE_COMMAND_FLOOR_INDICATOR_ON:
+                hardware_command_floor_indicator_on(command.floor);
+                break;
+            case HARDWARE_COMMAND_DOOR_OPEN:
+                hardware_command_door_open(command.value);
+                break;
+            case HARDWARE_COMMAND_STOP_LIGHT:
+                hardware_command_stop_light(command.value);
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (has_lights) {
+        hardware_command_lights_bulk(lights, light_mask);
+    }
+}
+
+
+// Padding is zeroed so that snapshots can be compared with memcmp
+static void hardware_thread_read_inputs(HardwareSnapshot* p_snapshot) {
+    memset(p_snapshot, 0, sizeof(*p_snapshot));
+    hardware_read_snapshot(p_snapshot);
+}
+
+
+// Sleeps for the poll period, or until the elevator publishes commands or the driver has input for us
+static void hardware_thread_wait(void) {
+    if (m_poll_period_us == 0) {
+        return;
+    }
+
+    struct pollfd fds[2] = {
+        {.fd = m_wake_fd, .events = POLLIN},
+        {.fd = hardware_event_fd(), .events = POLLIN},
+    };
+    const nfds_t number_of_fds = fds[1].fd == -1 ? 1 : 2;
+    const struct timespec timeout = {m_poll_period_us / 1000000, (m_poll_period_us % 1000000) * 1000L};
+
+    if (ppoll(fds, number_of_fds, &timeout, NULL) > 0 && (fds[0].revents & POLLIN)) {
+        uint64_t wakeups;
+        if (read(m_wake_fd, &wakeups, sizeof(wakeups)) == -1) {
+            return;
+        }
+    }
+}
+
+
+static void* hardware_thread_run(void* p_argument) {
+    (void)p_argument;
+
+    HardwareSnapshot last_inputs;
+    hardware_snapshot_seqlock_read(&m_snapshot, &last_inputs);
+
+    while (atomic_load_explicit(&m_running, memory_order_acquire)) {
+        // Reads flush the commands first, so they reach the hardware before the inputs are read
+        hardware_thread_apply_commands();
+
+        HardwareSnapshot inputs;
+        hardware_thread_read_inputs(&inputs);
+        if (memcmp(&inputs, &last_inputs, sizeof(inputs)) != 0) {
+            hardware_snapshot_seqlock_write(&m_snapshot, &inputs);
+            last_inputs = inputs;
+            hardware_thread_signal_fd(m_input_fd);
+        }
+
+        hardware_thread_wait();
+    }
+
+    hardware_thread_apply_commands();
+    hardware_flush();
+
+    return NULL;
+}
+
+
+int hardware_thread_start(const unsigned int poll_period_us) {
+    m_poll_period_us = poll_period_us;
+    hardware_command_ring_init(&m_commands);
+
+    HardwareSnapshot inputs;
+    hardware_thread_read_inputs(&inputs);
+    hardware_snapshot_seqlock_init(&m_snapshot, &inputs);
+
+    m_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    m_input_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wake_fd == -1 || m_input_fd == -1) {
+        hardware_thread_stop();
+        return 1;
+    }
+
+    // Signals are left to the other threads, so that they interrupt the loop of the elevator. The new thread
+    // inherits the mask.
+    sigset_t all_signals;
+    sigset_t previous_signals;
+    sigfillset(&all_signals);
+    pthread_sigmask(SIG_BLOCK, &all_signals, &previous_signals);
+
+    atomic_store(&m_running, true);
+    const int error = pthread_create(&m_thread, NULL, hardware_thread_run, NULL);
+    pthread_sigmask(SIG_SETMASK, &previous_signals, NULL);
+
+    if (error != 0) {
+        atomic_store(&m_running, false);
+        hardware_thread_stop();
+        return 1;
+    }
+
+    return 0;
+}
+
+
+static void hardware_thread_push(const HardwareCommand* p_command) {
+    while (!hardware_command_ring_push(&m_commands, p_command)) {
+        // The I/O thread can only make room once it sees the commands
+        hardware_thread_flush();
+        sched_yield();
+    }
+}
+
+
+static void hardware_thread_command_movement(void* p_context, const HardwareMovement movement) {
+    (void)p_context;
+    hardware_thread_push(&(HardwareCommand) {.type = HARDWARE_COMMAND_MOVEMENT, .value = (uint8_t)movement});
+}
+
+
+static void hardware_thread_command_order_light(void* p_context,
+                                                const int floor,
+                                                const HardwareOrder order_type,
+                                                const bool on) {
+    (void)p_context;
+    hardware_thread_push(&(HardwareCommand) {
+        .type = HARDWARE_COMMAND_ORDER_LIGHT,
+        .order_type = (uint8_t)order_type,
+        .value = on,
+        .floor = floor,
+    });
+}
+
+
+static void hardware_thread_command_floor_indicator_on(void* p_context, const int floor) {
+    (void)p_context;
+    hardware_thread_push(&(HardwareCommand) {.type = HARDWARE_COMMAND_FLOOR_INDICATOR_ON, .floor = floor});
+}
+
+
+static void hardware_thread_command_door_open(void* p_context, const bool door_open) {
+    (void)p_context;
+    hardware_thread_push(&(HardwareCommand) {.type = HARDWARE_COMMAND_DOOR_OPEN, .value = door_open});
+}
+
+
+static void hardware_thread_command_stop_light(void* p_context, const bool on) {
+    (void)p_context;
+    hardware_thread_push(&(HardwareCommand) {.type = HARDWARE_COMMAND_STOP_LIGHT, .value = on});
+}
+
+
+static const HardwareBackendOperations operations = {
+    .command_movement = hardware_thread_command_movement,
+    .command_order_light = hardware_thread_command_order_light,
+    .command_floor_indicator_on = hardware_thread_command_floor_indicator_on,
+    .command_door_open = hardware_thread_command_door_open,
+    .command_stop_light = hardware_thread_command_stop_light,
+};
+
+
+
+HardwareBackend hardware_thread_backend(void) {
+    return (HardwareBackend) {
+        .p_operations = &operations,
+        .p_context = NULL,
+        .number_of_floors = hardware_get_number_of_floors(),
+    };
+}
+
+
+void hardware_thread_read_snapshot(HardwareSnapshot* p_snapshot) {
+    hardware_snapshot_seqlock_read(&m_snapshot, p_snapshot);
+}
+
+
+void hardware_thread_flush(void) {
+    // A spinning I/O thread sees the commands on its own
+    if (hardware_command_ring_publish(&m_commands) && m_poll_period_us > 0) {
+        hardware_thread_signal_fd(m_wake_fd);
+    }
+}
+
+
+int hardware_thread_event_fd(void) {
+    return m_input_fd;
+}
+
+
+void hardware_thread_stop(void) {
+    if (atomic_load(&m_running)) {
+        hardware_command_ring_publish(&m_commands);
+        atomic_store(&m_running, false);
+        hardware_thread_signal_fd(m_wake_fd);
+        pthread_join(m_thread, NULL);
+    }
+
+    if (m_wake_fd != -1) {
+        close(m_wake_fd);
+        m_wake_fd = -1;
+    }
+
+    if (m_input_fd != -1) {
+        close(m_input_fd);
+        m_input_fd = -1;
+    }
+}
@@ -9,10 +9,35 @@
 #include "channels.h"
 
 #include <comedilib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <unistd.h>
 
 
 static comedi_t *it_g = NULL;
 
+// An asynchronous command on one input port. A handle only reads from one
+// subdevice, so each port gets a handle of its own.
+typedef struct {
+    comedi_t *it;
+    comedi_cmd cmd;
+    unsigned int chanlist[8];
+    int fd;
+} io_acquisition_t;
+
+// The input ports, and the first of their 8 input channels
+static const int input_ports[2][2] = {
+    {PORT1, BUTTON_DOWN2 & 0xff},
+    {PORT4, BUTTON_UP2 & 0xff},
+};
+
+// The running acquisitions, kept to restart them if they stop, and the
+// epoll descriptor which is readable when any of them has samples
+static io_acquisition_t acquisitions[2] = {{.fd = -1}, {.fd = -1}};
+static int acquisition_fd = -1;
+
 
 
 int io_init() {
@@ -63,6 +88,186 @@ int io_read_bit(int channel) {
 
 
 
+unsigned int io_read_port(int subdevice) {
+    unsigned int data = 0;
+    comedi_dio_bitfield2(it_g, subdevice, 0, &data, 0);
+
+    return data;
+}
+
+
+
+void io_write_port(int subdevice, unsigned int mask, unsigned int bits) {
+    comedi_dio_bitfield2(it_g, subdevice, mask, &bits, 0);
+}
+
+
+
+// Picks the first of the sources in preferred that the subdevice supports,
+// or 0 if it supports none of them
+static unsigned int io_pick_src(unsigned int supported, const unsigned int *preferred, int count) {
+    for (int i = 0; i < count; i++) {
+        if (supported & preferred[i])
+            return preferred[i];
+    }
+
+    return 0;
+}
+
+
+
+// Cancels the acquisitions and closes their handles
+static void io_stop_acquisition() {
+    for (int i = 0; i < 2; i++) {
+        io_acquisition_t *acquisition = &acquisitions[i];
+        if (acquisition->fd != -1)
+            comedi_cancel(acquisition->it, acquisition->cmd.subdev);
+        if (acquisition->it != NULL)
+            comedi_close(acquisition->it);
+
+        memset(acquisition, 0, sizeof(*acquisition));
+        acquisition->fd = -1;
+    }
+
+    if (acquisition_fd != -1)
+        close(acquisition_fd);
+    acquisition_fd = -1;
+}
+
+
+
+// Starts the command on the input port subdevice, over its 8 input
+// channels from first_channel. Returns 0 if it does not support it.
+static int io_start_port_acquisition(io_acquisition_t *acquisition, int subdevice, int first_channel,
+                                     unsigned int scan_period_ns) {
+    acquisition->it = comedi_open("/dev/comedi0");
+    if (acquisition->it == NULL)
+        return 0;
+
+    comedi_t *it = acquisition->it;
+
+    // Only a digital input subdevice with commands can report the changes
+    // of our inputs. The default read subdevice of a card is usually its
+    // analog input, which knows nothing of them.
+    const int flags = comedi_get_subdevice_flags(it, subdevice);
+    if (flags < 0 || !(flags & SDF_CMD_READ) || comedi_set_read_subdevice(it, subdevice) < 0)
+        return 0;
+
+    comedi_cmd supported;
+    memset(&supported, 0, sizeof(supported));
+    if (comedi_get_cmd_src_mask(it, subdevice, &supported) < 0)
+        return 0;
+
+    // Change of state is reported by the cards as an external or driver
+    // specific trigger, depending on the driver
+    static const unsigned int change_of_state_srcs[] = {TRIG_OTHER, TRIG_EXT};
+    static const unsigned int timed_srcs[] = {TRIG_TIMER};
+    static const unsigned int convert_srcs[] = {TRIG_NOW, TRIG_FOLLOW};
+
+    comedi_cmd *cmd = &acquisition->cmd;
+    memset(cmd, 0, sizeof(*cmd));
+    cmd->subdev = subdevice;
+    cmd->start_src = TRIG_NOW;
+    cmd->scan_begin_src = scan_period_ns == 0 ? io_pick_src(supported.scan_begin_src, change_of_state_srcs, 2)
+                                              : io_pick_src(supported.scan_begin_src, timed_srcs, 1);
+    cmd->scan_begin_arg = scan_period_ns;
+    cmd->convert_src = io_pick_src(supported.convert_src, convert_srcs, 2);
+    cmd->scan_end_src = TRIG_COUNT;
+    cmd->scan_end_arg = 8;
+    cmd->stop_src = TRIG_NONE;
+
+    // The samples are only used to wake us up, the inputs are read with
+    // io_read_port, but the scan must cover every input of the port for a
+    // change of any of them to be reported
+    for (int i = 0; i < 8; i++)
+        acquisition->chanlist[i] = CR_PACK(first_channel + i, 0, 0);
+    cmd->chanlist = acquisition->chanlist;
+    cmd->chanlist_len = 8;
+
+    if (cmd->scan_begin_src == 0 || cmd->convert_src == 0)
+        return 0;
+
+    // The first test may adjust the arguments to what the card can do, the
+    // second must then pass as is
+    comedi_command_test(it, cmd);
+    if (comedi_command_test(it, cmd) != 0)
+        return 0;
+
+    const int fd = comedi_fileno(it);
+    if (fd < 0 || fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) == -1)
+        return 0;
+
+    if (comedi_command(it, cmd) < 0)
+        return 0;
+
+    acquisition->fd = fd;
+
+    return 1;
+}
+
+
+
+int io_start_acquisition(unsigned int scan_period_ns) {
+    io_stop_acquisition();
+
+    acquisition_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (acquisition_fd == -1)
+        return 0;
+
+    // Either port alone would miss the changes of the other
+    for (int i = 0; i < 2; i++) {
+        io_acquisition_t *acquisition = &acquisitions[i];
+        struct epoll_event event = {.events = EPOLLIN};
+
+        if (!io_start_port_acquisition(acquisition, input_ports[i][0], input_ports[i][1], scan_period_ns) ||
+            epoll_ctl(acquisition_fd, EPOLL_CTL_ADD, acquisition->fd, &event) == -1) {
+            io_stop_acquisition();
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+
+int io_acquisition_fd() {
+    return acquisition_fd;
+}
+
+
+
+void io_drain_acquisition() {
+    for (int i = 0; i < 2; i++) {
+        io_acquisition_t *acquisition = &acquisitions[i];
+        if (acquisition->fd == -1)
+            continue;
+
+        char samples[4096];
+        for (;;) {
+            const ssize_t length = read(acquisition->fd, samples, sizeof(samples));
+
+            if (length > 0 || (length == -1 && errno == EINTR))
+                continue;
+
+            if (length == -1 && errno == EAGAIN)
+                break;
+
+            // The command stopped, e.g. after a buffer overrun. The inputs
+            // are polled until it runs again. A port which cannot restart is
+            // left out of the epoll descriptor, as it would stay readable.
+            comedi_cancel(acquisition->it, acquisition->cmd.subdev);
+            if (comedi_command(acquisition->it, &acquisition->cmd) < 0) {
+                epoll_ctl(acquisition_fd, EPOLL_CTL_DEL, acquisition->fd, NULL);
+                acquisition->fd = -1;
+            }
+            break;
+        }
+    }
+}
+
+
+
 int io_read_analog(int channel) {
     lsampl_t data = 0;
     comedi_data_read(it_g, channel >> 8, channel & 0xff, 0, AREF_GROUND, &data);
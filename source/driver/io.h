@@ -50,6 +50,58 @@ int io_read_bit(int channel);
 
 
 
+/**
+  Reads every digital channel of a subdevice in one go.
+  @param subdevice Subdevice to read from.
+  @return Channel values, bit n holding channel n.
+*/
+unsigned int io_read_port(int subdevice);
+
+
+
+/**
+  Writes several digital channels of a subdevice in one go.
+  @param subdevice Subdevice to write to.
+  @param mask Channels to write, bit n for channel n. The others are
+  left as they are.
+  @param bits Channel values, bit n holding channel n.
+*/
+void io_write_port(int subdevice, unsigned int mask, unsigned int bits);
+
+
+
+
+/**
+  Starts an asynchronous command on each of the digital input
+  subdevices, PORT1 and PORT4, over all of their input channels, so
+  that the file descriptor of the acquisition becomes readable when the
+  inputs change, or on every hardware-timed scan of them.
+  @param scan_period_ns Period of the scan in nanoseconds, or 0 to be
+  woken on every change of state.
+  @return Non-zero on success and 0 if either input subdevice does not
+  support commands, in which case no command is left running.
+*/
+int io_start_acquisition(unsigned int scan_period_ns);
+
+
+
+/**
+  Gets the file descriptor of a started acquisition, an epoll
+  descriptor over the commands of both input subdevices.
+  @return The file descriptor, or -1 if no acquisition is running.
+*/
+int io_acquisition_fd();
+
+
+
+/**
+  Discards the samples of the acquisition read so far, so that its file
+  descriptor only becomes readable again on the next change or scan.
+  Restarts the command if it stopped, e.g. after a buffer overrun.
+*/
+void io_drain_acquisition();
+
+
 
 /**
   Reads a bit value from an analog channel.
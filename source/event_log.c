@@ -0,0 +1,124 @@
+/**
+ * @file
+ * @brief Implementation of the event log.
+ */
+
+#include "event_log.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+_Static_assert((EVENT_LOG_CAPACITY & (EVENT_LOG_CAPACITY - 1)) == 0, "The capacity must be a power of two");
+_Static_assert(sizeof(EventRecord) == 16, "Records are written to files as they are");
+
+/**
+ * @brief Value of @c last_values for an event which has not been recorded.
+ */
+#define EVENT_LOG_NO_VALUE INT_MIN
+
+/**
+ * @brief Gets the current time for the records.
+ *
+ * @return Nanoseconds on the monotonic clock.
+ */
+static uint64_t event_log_now_ns() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+void event_log_init(EventLog* p_log) {
+    memset(p_log->records, 0, sizeof(p_log->records));
+    atomic_init(&p_log->number_of_records, 0);
+
+    for (int type = 0; type < EVENT_TYPE_NUMBER_OF_TYPES; type++) {
+        p_log->last_values[type] = EVENT_LOG_NO_VALUE;
+    }
+}
+
+void event_log_record(EventLog* p_log, const EventType type, const int first_argument, const int second_argument) {
+    if (!p_log) {
+        return;
+    }
+
+    // Only this thread writes the count, so it can be read without ordering
+    const uint64_t index = atomic_load_explicit(&p_log->number_of_records, memory_order_relaxed);
+
+    EventRecord* p_record = &p_log->records[index & (EVENT_LOG_CAPACITY - 1)];
+    p_record->timestamp_ns = event_log_now_ns();
+    p_record->type = (uint32_t)type;
+    p_record->arguments[0] = (int16_t)first_argument;
+    p_record->arguments[1] = (int16_t)second_argument;
+
+    atomic_store_explicit(&p_log->number_of_records, index + 1, memory_order_release);
+}
+
+void event_log_record_if_changed(EventLog* p_log, const EventType type, const int value) {
+    if (!p_log || p_log->last_values[type] == value) {
+        return;
+    }
+
+    p_log->last_values[type] = value;
+    event_log_record(p_log, type, value, 0);
+}
+
+int event_log_flush(const EventLog* p_log, const char* path) {
+    const uint64_t end = atomic_load_explicit(&p_log->number_of_records, memory_order_acquire);
+    const uint64_t begin = end > EVENT_LOG_CAPACITY ? end - EVENT_LOG_CAPACITY : 0;
+    const size_t file_size = sizeof(EventLogFileHeader) + (size_t)(end - begin) * sizeof(EventRecord);
+
+    const int fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        return 1;
+    }
+
+    if (ftruncate(fd, (off_t)file_size) == -1) {
+        close(fd);
+        return 1;
+    }
+
+    char* p_file = mmap(NULL, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p_file == MAP_FAILED) {
+        close(fd);
+        return 1;
+    }
+
+    EventRecord* p_file_records = (EventRecord*)(p_file + sizeof(EventLogFileHeader));
+    for (uint64_t index = begin; index < end; index++) {
+        p_file_records[index - begin] = p_log->records[index & (EVENT_LOG_CAPACITY - 1)];
+    }
+
+    // The producer may have lapped the copy, in which case the first records copied can be torn. The record it may be
+    // writing right now is not counted yet, and replaces the record a whole capacity before it.
+    atomic_thread_fence(memory_order_acquire);
+    const uint64_t now = atomic_load_explicit(&p_log->number_of_records, memory_order_relaxed);
+    const uint64_t overwritten_end = now + 1 > EVENT_LOG_CAPACITY ? now + 1 - EVENT_LOG_CAPACITY : 0;
+
+    uint64_t first_intact = begin;
+    if (overwritten_end > first_intact) {
+        first_intact = overwritten_end < end ? overwritten_end : end;
+    }
+
+    const uint64_t number_of_records = end - first_intact;
+    memmove(p_file_records, p_file_records + (first_intact - begin), (size_t)number_of_records * sizeof(EventRecord));
+
+    EventLogFileHeader header = {
+        .record_size = sizeof(EventRecord),
+        .number_of_records = (uint32_t)number_of_records,
+        .number_of_lost_records = end - number_of_records,
+    };
+    memcpy(header.magic, EVENT_LOG_FILE_MAGIC, sizeof(header.magic));
+    memcpy(p_file, &header, sizeof(header));
+
+    const size_t used_size = sizeof(EventLogFileHeader) + (size_t)number_of_records * sizeof(EventRecord);
+    const int error = msync(p_file, file_size, MS_SYNC) == -1 || munmap(p_file, file_size) == -1 ||
+                      ftruncate(fd, (off_t)used_size) == -1;
+    close(fd);
+
+    return error;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file
+ * @brief Log of what an elevator did, kept as fixed size binary records in a ring buffer: state transitions, orders
+ *        added to and removed from the queue, and door and motor commands. Recording is a clock read and a store, it
+ *        never blocks or allocates, so the log can be kept on the control loop all the time.
+ *
+ * The log has a single producer, the thread stepping the elevator, and once full it overwrites its oldest records.
+ * It can be flushed to a file while being recorded to, from the same thread or from one other thread.
+ *
+ * A flushed file is an #EventLogFileHeader followed by its @c number_of_records #EventRecord, oldest first, both in
+ * the byte order of the machine.
+ */
+
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+/**
+ * @brief Number of records kept, the most recent ones. Must be a power of two.
+ */
+#define EVENT_LOG_CAPACITY 4096
+
+/**
+ * @brief The first bytes of a flushed file.
+ */
+#define EVENT_LOG_FILE_MAGIC "ELEVLOG1"
+
+/**
+ * @brief The kinds of records, and what their arguments hold.
+ */
+typedef enum {
+    /**
+     * @brief The FSM changed state, from the #State in the first argument to the one in the second.
+     */
+    EVENT_TYPE_STATE_TRANSITION,
+
+    /**
+     * @brief An order was added to the queue, at the floor in the first argument with the #HardwareOrder in the
+     *        second.
+     */
+    EVENT_TYPE_ORDER_ADD,
+
+    /**
+     * @brief The top order was served and removed from the queue, at the floor in the first argument with the
+     *        #HardwareOrder in the second.
+     */
+    EVENT_TYPE_ORDER_POP,
+
+    /**
+     * @brief Every order was removed from the queue, the number of orders in the first argument.
+     */
+    EVENT_TYPE_ORDER_CLEAR,
+
+    /**
+     * @brief The door was commanded open, 1 in the first argument, or closed, 0.
+     */
+    EVENT_TYPE_DOOR,
+
+    /**
+     * @brief The motor was commanded to the #HardwareMovement in the first argument.
+     */
+    EVENT_TYPE_MOVEMENT,
+
+    EVENT_TYPE_NUMBER_OF_TYPES
+} EventType;
+
+/**
+ * @brief One record of the log.
+ */
+typedef struct {
+    /**
+     * @brief When the event happened, in nanoseconds on the monotonic clock.
+     */
+    uint64_t timestamp_ns;
+
+    /**
+     * @brief The #EventType of the record.
+     */
+    uint32_t type;
+
+    /**
+     * @brief Arguments of the event, see #EventType. Unused arguments are 0.
+     */
+    int16_t arguments[2];
+} EventRecord;
+
+/**
+ * @brief Start of a flushed file.
+ */
+typedef struct {
+    /**
+     * @brief #EVENT_LOG_FILE_MAGIC, without the terminating zero.
+     */
+    char magic[8];
+
+    /**
+     * @brief Size of an #EventRecord in bytes.
+     */
+    uint32_t record_size;
+
+    /**
+     * @brief Number of records in the file.
+     */
+    uint32_t number_of_records;
+
+    /**
+     * @brief Number of records overwritten before the flush, which are missing from the start of the file.
+     */
+    uint64_t number_of_lost_records;
+} EventLogFileHeader;
+
+/**
+ * @brief An event log.
+ */
+typedef struct {
+    /**
+     * @brief The records, record @c n is kept at index @c n modulo #EVENT_LOG_CAPACITY.
+     */
+    EventRecord records[EVENT_LOG_CAPACITY];
+
+    /**
+     * @brief Number of records ever recorded. Only written by the producer, and published after the record is
+     *        written.
+     */
+    _Atomic uint64_t number_of_records;
+
+    /**
+     * @brief The last value recorded for the events recorded with #event_log_record_if_changed, indexed by
+     *        #EventType. Only used by the producer.
+     */
+    int last_values[EVENT_TYPE_NUMBER_OF_TYPES];
+} EventLog;
+
+/**
+ * @brief Empties @p p_log.
+ *
+ * @param[out] p_log The log.
+ */
+void event_log_init(EventLog* p_log);
+
+/**
+ * @brief Records an event in @p p_log, overwriting the oldest record if the log is full.
+ *
+ * @param[in, out] p_log The log, NULL to not record anything.
+ * @param[in] type The kind of event.
+ * @param[in] first_argument The first argument of the event.
+ * @param[in] second_argument The second argument of the event.
+ */
+void event_log_record(EventLog* p_log, const EventType type, const int first_argument, const int second_argument);
+
+/**
+ * @brief Records an event in @p p_log if @p value differs from the value last recorded for @p type with this
+ *        function, e.g. for outputs which are commanded to the same value on every iteration.
+ *
+ * @param[in, out] p_log The log, NULL to not record anything.
+ * @param[in] type The kind of event.
+ * @param[in] value The first argument of the event.
+ */
+void event_log_record_if_changed(EventLog* p_log, const EventType type, const int value);
+
+/**
+ * @brief Writes the records of @p p_log to the file at @p path through a shared memory mapping, replacing the file.
+ *
+ * @param[in] p_log The log.
+ * @param[in] path Path of the file.
+ *
+ * @return 0 on success, non-zero on failure.
+ *
+ * @note Safe to call while the producer records, from one thread at a time. Records which the producer overwrote
+ *       while they were being copied are left out, and counted as lost.
+ */
+int event_log_flush(const EventLog* p_log, const char* path);
+
+#endif
@@ -5,15 +5,11 @@
 
 #include "fsm.h"
 
-#include <signal.h>
 #include <stdbool.h>
-#include <stdio.h>
-#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 
-#include "door.h"
-#include "hardware.h"
 #include "position.h"
-#include "priority_queue.h"
 
 /**
  * @brief Specifies an undefined floor, is used during cases when the FSM don't have information about the current
@@ -22,64 +18,70 @@
 #define FLOOR_UNDEFINED -1
 
 /**
- * @brief The possible states for the state machine.
- */
-typedef enum {
-    STATE_STARTUP,
-    STATE_IDLE,
-    STATE_MOVE,
-    STATE_DOOR_OPEN,
-    STATE_STOP,
-    STATE_UNDEFINED
-} State;
-
-/**
- * @brief Polls hardware, checks the current state and queue, and decides the next state.
+ * @brief Checks the hardware input, the current state and queue, and decides the next state.
  *
  * @param[in] current_state Current state of the elevator.
  * @param[in] p_priority_queue The current queue, makes it possible for states to check if 
  * 						       the queue is in a given state in order to decide the next state. 
+ * @param[in] p_door The door of the elevator.
  * @param[in] current_position The current position the elevator is at. 
+ * @param[in] p_snapshot The hardware input sampled this iteration.
  * 
  * @return Next state in the FSM based on @p current_state, @p priority_queue, @p current_position and hardware input.
  */
 static State fsm_decide_next_state(const State current_state,
                                    const Order* p_priority_queue,
-                                   const Position current_position);
+                                   const Door* p_door,
+                                   const Position current_position,
+                                   const HardwareSnapshot* p_snapshot);
 
 /**
- * @brief Handles transitioning between two states, @p current_state and @p next_state. Will execute the exit 
- *        operations for @p current_state and the enter operations for @p next_state.
+ * @brief Handles transitioning between the current state of @p p_elevator and @p next_state. Will execute the exit
+ *        operations for the current state and the enter operations for @p next_state.
  *
- * @param[in] current_state Current state of the elevator, the state the FSM is leaving.
+ * @param[in, out] p_elevator The elevator, its current state is the state the FSM is leaving. Its queue is checked
+ *                            and updated during the transition.
  * @param[in] next_state Next state of the elevator, the state the FSM is entering.
- * @param[in, out] pp_priority_queue Pointer to the current queue, used to check the current state for the orders
- * 							   during the transition and for updating the queue. 
- * @param[in, out] p_movement_when_left_floor The movement the elevator was set to when it left from the last floor. 
  * @param[in] current_position The current position of the elevator. 
  */
-static void fsm_transition(const State current_state,
-                           const State next_state,
-                           Order** pp_priority_queue,
-                           HardwareMovement* p_movement_when_left_floor,
-                           const Position current_position);
+static void fsm_transition(Elevator* p_elevator, const State next_state, const Position current_position);
 
 /**
- * @brief Will execute the update function defined for the @p current_state and update
- * 		  the @p pp_priority_queue.
+ * @brief Will execute the update function defined for the current state of @p p_elevator and update its queue.
  * 
- * @param[in] current_state The current state that shall have its update function called. 
- * @param[in, out] pp_priority_queue The queue, makes it possible for the states to update the queue. 
+ * @param[in, out] p_elevator The elevator.
  * @param[in] current_position The current position of the elevator. 
+ * @param[in] p_snapshot The hardware input sampled this iteration.
+ * @param[in] now_ms The current time.
  */
-static void fsm_state_update(const State current_state, Order** pp_priority_queue, const Position current_position);
+static void fsm_state_update(Elevator* p_elevator,
+                             const Position current_position,
+                             const HardwareSnapshot* p_snapshot,
+                             const uint64_t now_ms);
 
 /**
- * @brief Gets the floor the elevator is currently at.
- * 
- * @return The floor number if the elevator is at a floor, #FLOOR_UNDEFINED if else.
+ * @brief Decides which way to move to reach the top order of @p p_priority_queue from @p current_position.
+ *
+ * @param[in] p_priority_queue The queue, must not be empty.
+ * @param[in] current_position The current position of the elevator.
+ *
+ * @return The movement towards the top order.
+ */
+static HardwareMovement fsm_decide_movement(const Order* p_priority_queue, const Position current_position);
+
+/**
+ * @brief Sets the movement of the elevator towards the top order of @p p_priority_queue.
+ *
+ * @param[in] p_hardware The hardware of the elevator.
+ * @param[in] p_priority_queue The queue, must not be empty.
+ * @param[in] current_position The current position of the elevator.
+ * @param[in, out] p_movement_when_left_floor The movement the elevator was set to when it left from the last floor,
+ *                                            updated if the elevator is at a floor and about to leave it.
  */
-static int fsm_get_current_floor();
+static void fsm_move_towards_top_order(const HardwareBackend* p_hardware,
+                                       const Order* p_priority_queue,
+                                       const Position current_position,
+                                       HardwareMovement* p_movement_when_left_floor);
 
 /**
  * @brief Checks if the elevator is at any floor based on the @p position. 
@@ -91,29 +93,57 @@ static int fsm_get_current_floor();
 static bool fsm_elevator_is_at_a_floor(const Position position);
 
 /**
- * @brief Decides the position of the elevator given the @p last_floor and @p movement_when_left_floor.
+ * @brief Decides the position of the elevator given the @p last_floor, @p movement_when_left_floor and the
+ *        floor sensors in @p p_snapshot.
  * 
  * @param[in] last_floor The floor the elevator was last recorded to be at.
  * @param[in] movement_when_left_floor The movement when the elevator left @p last_floor. 
+ * @param[in] p_snapshot The hardware input sampled this iteration.
  * 
  * @return The position of the elevator.
  */
-static Position fsm_decide_elevator_position(const int last_floor, const HardwareMovement movement_when_left_floor);
+static Position fsm_decide_elevator_position(const int last_floor,
+                                             const HardwareMovement movement_when_left_floor,
+                                             const HardwareSnapshot* p_snapshot);
 
 /**
  * @brief Clears all the order lights.
+ *
+ * @param[in] p_hardware The hardware of the elevator.
  */
-static void fsm_clear_order_lights();
+static void fsm_clear_order_lights(const HardwareBackend* p_hardware);
 
 /**
- * @brief Polls the current orders and puts them in the @p pp_priority_queue. Updates the order light for the new 
- *        order(s).
+ * @brief Detects the order buttons in @p p_snapshot which were not pressed in @p p_previous_orders, and stores the
+ *        buttons of @p p_snapshot in @p p_previous_orders.
+ * 
+ * @param[in] p_snapshot The hardware input sampled this iteration.
+ * @param[in, out] p_previous_orders The order buttons pressed the last time this was called.
+ * @param[out] p_new_orders The newly pressed order buttons, one bit per button as given by #HARDWARE_ORDER_WORD and
+ *             #HARDWARE_ORDER_BIT.
  * 
+ * @return true if any button was newly pressed.
+ */
+static bool fsm_detect_new_orders(const HardwareSnapshot* p_snapshot,
+                                  uint64_t* p_previous_orders,
+                                  uint64_t* p_new_orders);
+
+/**
+ * @brief Puts the orders which were pressed since the last call in the @p pp_priority_queue. Updates the order
+ *        light for the new order(s). A button being held down only gives one order.
+ * 
+ * @param[in] p_hardware The hardware of the elevator.
  * @param[in, out] pp_priority_queue The current queue.
  * @param[in] current_position The position of the elevator, used in the queue algorithm to decide where the new 
  *             orders should be placed.
+ * @param[in] p_snapshot The hardware input sampled this iteration.
+ * @param[in, out] p_previous_orders The order buttons pressed the last time orders were managed.
  */
-static void fsm_manage_orders_and_update_queue(Order** pp_priority_queue, const Position current_position);
+static void fsm_manage_orders_and_update_queue(const HardwareBackend* p_hardware,
+                                               Order** pp_priority_queue,
+                                               const Position current_position,
+                                               const HardwareSnapshot* p_snapshot,
+                                               uint64_t* p_previous_orders);
 
 /**
  * @brief Checks if the top order in the @p p_priority_queue is at the @p floor.
@@ -129,23 +159,14 @@ static bool fsm_top_order_is_at_floor(const Order* p_priority_queue, const int f
  * @brief Clears the top order of the @p pp_priority_queue and turns off the lights for the floor the top
  *        order is pointing to.
  * 
+ * @param[in] p_hardware The hardware of the elevator.
  * @param[in, out] pp_priority_queue The priority queue to clear the top order from. 
  * @param[in] current_position The current position of the elevator. 
  * 
  */
-static void fsm_clear_top_order_and_update_order_lights(Order** pp_priority_queue, const Position current_position);
-
-/**
- * @brief Handles signal interrupt from the command line.
- * 
- * @param[in] sig The signal.
- */
-static void fsm_sigint_handler(int sig);
-
-/**
- * @brief Determines if the FSM should continue running.
- */
-static bool m_fsm_should_abort = false;
+static void fsm_clear_top_order_and_update_order_lights(const HardwareBackend* p_hardware,
+                                                       Order** pp_priority_queue,
+                                                       const Position current_position);
 
 /**
  * #################################################################################################################
@@ -153,50 +174,66 @@ static bool m_fsm_should_abort = false;
  * #################################################################################################################
  */
 
-void fsm_run() {
-    int error = hardware_init();
-    if (error != 0) {
-        fprintf(stderr, "Unable to initialize hardware\n");
-        exit(1);
-    }
-
-    signal(SIGINT, fsm_sigint_handler);
-
-    State current_state = STATE_UNDEFINED;
-
-    int last_floor = FLOOR_UNDEFINED;
-    Position current_position = {FLOOR_UNDEFINED, OFFSET_UNDEFINED};
+void fsm_init(Elevator* p_elevator, const HardwareBackend* p_hardware) {
+    p_elevator->hardware = *p_hardware;
+    timer_service_init(&p_elevator->timers);
+    door_init(&p_elevator->door, &p_elevator->hardware, &p_elevator->timers);
 
-    Order* p_priority_queue = NULL;
+    p_elevator->current_state = STATE_UNDEFINED;
+    p_elevator->last_floor = FLOOR_UNDEFINED;
+    p_elevator->movement_when_left_floor = HARDWARE_MOVEMENT_STOP;
+    p_elevator->p_priority_queue = NULL;
+    memset(p_elevator->previous_orders, 0, sizeof(p_elevator->previous_orders));
+}
 
-    HardwareMovement* p_movement_when_left_floor = malloc(sizeof(HardwareMovement));
-    *p_movement_when_left_floor = HARDWARE_MOVEMENT_STOP;
+void fsm_step(Elevator* p_elevator, const HardwareSnapshot* p_inputs, const uint64_t now_ms) {
+    const Position current_position = fsm_decide_elevator_position(p_elevator->last_floor,
+                                                                   p_elevator->movement_when_left_floor,
+                                                                   p_inputs);
 
-    while (!m_fsm_should_abort) {
-        current_position = fsm_decide_elevator_position(last_floor, *p_movement_when_left_floor);
+    if (fsm_elevator_is_at_a_floor(current_position)) {
+        hardware_backend_command_floor_indicator_on(&p_elevator->hardware, current_position.floor);
+        p_elevator->last_floor = current_position.floor;
+    }
 
-        if (fsm_elevator_is_at_a_floor(current_position)) {
-            hardware_command_floor_indicator_on(current_position.floor);
-            last_floor = current_position.floor;
-        }
+    State next_state = fsm_decide_next_state(p_elevator->current_state,
+                                             p_elevator->p_priority_queue,
+                                             &p_elevator->door,
+                                             current_position,
+                                             p_inputs);
+
+    if (next_state != p_elevator->current_state) {
+        event_log_record(p_elevator->hardware.p_event_log,
+                         EVENT_TYPE_STATE_TRANSITION,
+                         p_elevator->current_state,
+                         next_state);
+        fsm_transition(p_elevator, next_state, current_position);
+        p_elevator->current_state = next_state;
+    }
 
-        State next_state = fsm_decide_next_state(current_state, p_priority_queue, current_position);
+    fsm_state_update(p_elevator, current_position, p_inputs, now_ms);
+    door_update(&p_elevator->door, p_inputs->obstruction_signal, now_ms);
+    timer_expire(&p_elevator->timers, now_ms);
+}
 
-        if (next_state != current_state) {
-            fsm_transition(current_state, next_state, &p_priority_queue, p_movement_when_left_floor, current_position);
-            current_state = next_state;
-        }
+uint64_t fsm_next_deadline_ms(const Elevator* p_elevator) {
+    return timer_next_deadline_ms(&p_elevator->timers);
+}
 
-        fsm_state_update(current_state, &p_priority_queue, current_position);
-        door_update();
-    }
+Position fsm_get_position(const Elevator* p_elevator, const HardwareSnapshot* p_inputs) {
+    return fsm_decide_elevator_position(p_elevator->last_floor, p_elevator->movement_when_left_floor, p_inputs);
+}
 
-    printf("Terminating elevator\n");
-    free(p_movement_when_left_floor);
-    hardware_command_movement(HARDWARE_MOVEMENT_STOP);
+void fsm_deinit(Elevator* p_elevator) {
+    p_elevator->p_priority_queue = priority_queue_clear(p_elevator->p_priority_queue);
+    hardware_backend_command_movement(&p_elevator->hardware, HARDWARE_MOVEMENT_STOP);
 }
 
-State fsm_decide_next_state(const State current_state, const Order* p_priority_queue, const Position current_position) {
+State fsm_decide_next_state(const State current_state,
+                            const Order* p_priority_queue,
+                            const Door* p_door,
+                            const Position current_position,
+                            const HardwareSnapshot* p_snapshot) {
     State next_state = current_state;
 
     switch (current_state) {
@@ -204,7 +241,7 @@ State fsm_decide_next_state(const State current_state, const Order* p_priority_q
             next_state = STATE_STARTUP;
             break;
         case STATE_STARTUP: {
-            if (hardware_read_stop_signal()) {
+            if (p_snapshot->stop_signal) {
                 next_state = STATE_STOP;
             } else if (fsm_elevator_is_at_a_floor(current_position)) {
                 next_state = STATE_IDLE;
@@ -212,15 +249,20 @@ State fsm_decide_next_state(const State current_state, const Order* p_priority_q
         } break;
 
         case STATE_IDLE: {
-            if (hardware_read_stop_signal()) {
+            if (p_snapshot->stop_signal) {
                 next_state = STATE_STOP;
+            } else if (fsm_top_order_is_at_floor(p_priority_queue, current_position.floor) &&
+                       current_position.offset == OFFSET_AT_FLOOR) {
+                // Moving would take us off the floor of the order, and the direction is only decided when the
+                // move starts
+                next_state = STATE_DOOR_OPEN;
             } else if (!priority_queue_is_empty(p_priority_queue)) {
                 next_state = STATE_MOVE;
             }
         } break;
 
         case STATE_MOVE: {
-            if (hardware_read_stop_signal()) {
+            if (p_snapshot->stop_signal) {
                 next_state = STATE_STOP;
             } else if (p_priority_queue->floor == current_position.floor && current_position.offset == OFFSET_AT_FLOOR) {
                 next_state = STATE_DOOR_OPEN;
@@ -228,22 +270,22 @@ State fsm_decide_next_state(const State current_state, const Order* p_priority_q
         } break;
 
         case STATE_DOOR_OPEN: {
-            if (hardware_read_stop_signal()) {
+            if (p_snapshot->stop_signal) {
                 next_state = STATE_STOP;
-            } else if (!door_is_open() && priority_queue_is_empty(p_priority_queue)) {
+            } else if (!door_is_open(p_door) && priority_queue_is_empty(p_priority_queue)) {
                 next_state = STATE_IDLE;
-            } else if (!door_is_open() && !priority_queue_is_empty(p_priority_queue)) {
+            } else if (!door_is_open(p_door) && !priority_queue_is_empty(p_priority_queue)) {
                 next_state = STATE_MOVE;
             }
         } break;
 
         case STATE_STOP: {
-            if (!hardware_read_stop_signal()) {
-                if (door_is_open()) {
+            if (!p_snapshot->stop_signal) {
+                if (door_is_open(p_door)) {
                     next_state = STATE_DOOR_OPEN;
-                } else if (!door_is_open() && current_position.floor == FLOOR_UNDEFINED) {
+                } else if (!door_is_open(p_door) && current_position.floor == FLOOR_UNDEFINED) {
                     next_state = STATE_STARTUP;
-                } else if (!door_is_open() && current_position.floor != FLOOR_UNDEFINED) {
+                } else if (!door_is_open(p_door) && current_position.floor != FLOOR_UNDEFINED) {
                     next_state = STATE_IDLE;
                 }
             }
@@ -253,15 +295,13 @@ State fsm_decide_next_state(const State current_state, const Order* p_priority_q
     return next_state;
 }
 
-void fsm_transition(const State current_state,
-                    const State next_state,
-                    Order** pp_priority_queue,
-                    HardwareMovement* p_movement_when_left_floor,
-                    const Position current_position) {
+void fsm_transition(Elevator* p_elevator, const State next_state, const Position current_position) {
+    const HardwareBackend* p_hardware = &p_elevator->hardware;
+
     // Perform exit for current state
-    switch (current_state) {
+    switch (p_elevator->current_state) {
         case STATE_STARTUP: {
-            hardware_command_movement(HARDWARE_MOVEMENT_STOP);
+            hardware_backend_command_movement(p_hardware, HARDWARE_MOVEMENT_STOP);
         } break;
 
         case STATE_IDLE: {
@@ -269,7 +309,7 @@ void fsm_transition(const State current_state,
         } break;
 
         case STATE_MOVE: {
-            hardware_command_movement(HARDWARE_MOVEMENT_STOP);
+            hardware_backend_command_movement(p_hardware, HARDWARE_MOVEMENT_STOP);
         } break;
 
         case STATE_DOOR_OPEN: {
@@ -277,7 +317,7 @@ void fsm_transition(const State current_state,
         } break;
 
         case STATE_STOP: {
-            hardware_command_stop_light(false);
+            hardware_backend_command_stop_light(p_hardware, false);
         } break;
 
         default:
@@ -287,10 +327,12 @@ void fsm_transition(const State current_state,
     // Perform enter for next state
     switch (next_state) {
         case STATE_STARTUP: {
-            fsm_clear_order_lights();
+            fsm_clear_order_lights(p_hardware);
+            // The buttons are not read until the startup is over, so one still held by then is a new press
+            memset(p_elevator->previous_orders, 0, sizeof(p_elevator->previous_orders));
 
             if (!fsm_elevator_is_at_a_floor(current_position)) {
-                hardware_command_movement(HARDWARE_MOVEMENT_DOWN);
+                hardware_backend_command_movement(p_hardware, HARDWARE_MOVEMENT_DOWN);
             }
         } break;
 
@@ -299,22 +341,10 @@ void fsm_transition(const State current_state,
         } break;
 
         case STATE_MOVE: {
-            HardwareMovement new_movement = (*pp_priority_queue)->floor < current_position.floor ? HARDWARE_MOVEMENT_DOWN : HARDWARE_MOVEMENT_UP;
-
-            // If we stopped between floors and order to the current floor we decide movement based
-            // on the elevators offset to the current floor
-            if ((*pp_priority_queue)->floor == current_position.floor && current_position.offset == OFFSET_BELOW) {
-                new_movement = HARDWARE_MOVEMENT_UP;
-            } else if ((*pp_priority_queue)->floor == current_position.floor && current_position.offset == OFFSET_ABOVE) {
-                new_movement = HARDWARE_MOVEMENT_DOWN;
-            }
-
-            hardware_command_movement(new_movement);
-
-            // Only update the movement when the elevator is at a floor and leaving
-            if (fsm_elevator_is_at_a_floor(current_position)) {
-                *p_movement_when_left_floor = new_movement;
-            }
+            fsm_move_towards_top_order(p_hardware,
+                                       p_elevator->p_priority_queue,
+                                       current_position,
+                                       &p_elevator->movement_when_left_floor);
         } break;
 
         case STATE_DOOR_OPEN: {
@@ -322,10 +352,16 @@ void fsm_transition(const State current_state,
         } break;
 
         case STATE_STOP: {
-            hardware_command_movement(HARDWARE_MOVEMENT_STOP);
-            hardware_command_stop_light(true);
-            fsm_clear_order_lights();
-            *pp_priority_queue = priority_queue_clear(*pp_priority_queue);
+            hardware_backend_command_movement(p_hardware, HARDWARE_MOVEMENT_STOP);
+            hardware_backend_command_stop_light(p_hardware, true);
+            fsm_clear_order_lights(p_hardware);
+            event_log_record(p_hardware->p_event_log,
+                             EVENT_TYPE_ORDER_CLEAR,
+                             priority_queue_length(p_elevator->p_priority_queue),
+                             0);
+            p_elevator->p_priority_queue = priority_queue_clear(p_elevator->p_priority_queue);
+            // The orders are dropped, so a button still held once the stop is over is a new press
+            memset(p_elevator->previous_orders, 0, sizeof(p_elevator->previous_orders));
         } break;
 
         default:
@@ -333,33 +369,57 @@ void fsm_transition(const State current_state,
     }
 }
 
-void fsm_state_update(const State current_state, Order** pp_priority_queue, const Position current_position) {
-    switch (current_state) {
+void fsm_state_update(Elevator* p_elevator,
+                      const Position current_position,
+                      const HardwareSnapshot* p_snapshot,
+                      const uint64_t now_ms) {
+    const HardwareBackend* p_hardware = &p_elevator->hardware;
+    Order** pp_priority_queue = &p_elevator->p_priority_queue;
+
+    switch (p_elevator->current_state) {
         case STATE_STARTUP: {
             // No update
         } break;
 
         case STATE_IDLE: {
-            fsm_manage_orders_and_update_queue(pp_priority_queue, current_position);
+            fsm_manage_orders_and_update_queue(p_hardware,
+                                               pp_priority_queue,
+                                               current_position,
+                                               p_snapshot,
+                                               p_elevator->previous_orders);
         } break;
 
         case STATE_MOVE: {
-            fsm_manage_orders_and_update_queue(pp_priority_queue, current_position);
+            fsm_manage_orders_and_update_queue(p_hardware,
+                                               pp_priority_queue,
+                                               current_position,
+                                               p_snapshot,
+                                               p_elevator->previous_orders);
+
+            // A new order can take the top spot behind us, so the direction from when the move started can be wrong
+            fsm_move_towards_top_order(p_hardware,
+                                       *pp_priority_queue,
+                                       current_position,
+                                       &p_elevator->movement_when_left_floor);
         } break;
 
         case STATE_DOOR_OPEN: {
-            fsm_manage_orders_and_update_queue(pp_priority_queue, current_position);
+            fsm_manage_orders_and_update_queue(p_hardware,
+                                               pp_priority_queue,
+                                               current_position,
+                                               p_snapshot,
+                                               p_elevator->previous_orders);
 
             if (fsm_top_order_is_at_floor(*pp_priority_queue, current_position.floor)) {
-                fsm_clear_top_order_and_update_order_lights(pp_priority_queue, current_position);
-                door_request_open_and_autoclose();
+                fsm_clear_top_order_and_update_order_lights(p_hardware, pp_priority_queue, current_position);
+                door_request_open_and_autoclose(&p_elevator->door, now_ms);
             }
 
         } break;
 
         case STATE_STOP: {
             if (fsm_elevator_is_at_a_floor(current_position)) {
-                door_request_open_and_autoclose();
+                door_request_open_and_autoclose(&p_elevator->door, now_ms);
             }
         } break;
 
@@ -375,27 +435,46 @@ void fsm_state_update(const State current_state, Order** pp_priority_queue, cons
  * #################################################################################################################
  */
 
-static int fsm_get_current_floor() {
-    for (unsigned int floor = 0; floor < HARDWARE_NUMBER_OF_FLOORS; floor++) {
-        if (hardware_read_floor_sensor(floor)) {
-            return floor;
-        }
+static HardwareMovement fsm_decide_movement(const Order* p_priority_queue, const Position current_position) {
+    HardwareMovement new_movement = p_priority_queue->floor < current_position.floor ? HARDWARE_MOVEMENT_DOWN : HARDWARE_MOVEMENT_UP;
+
+    // If we stopped between floors and order to the current floor we decide movement based
+    // on the elevators offset to the current floor
+    if (p_priority_queue->floor == current_position.floor && current_position.offset == OFFSET_BELOW) {
+        new_movement = HARDWARE_MOVEMENT_UP;
+    } else if (p_priority_queue->floor == current_position.floor && current_position.offset == OFFSET_ABOVE) {
+        new_movement = HARDWARE_MOVEMENT_DOWN;
     }
 
-    return FLOOR_UNDEFINED;
+    return new_movement;
+}
+
+static void fsm_move_towards_top_order(const HardwareBackend* p_hardware,
+                                       const Order* p_priority_queue,
+                                       const Position current_position,
+                                       HardwareMovement* p_movement_when_left_floor) {
+    const HardwareMovement new_movement = fsm_decide_movement(p_priority_queue, current_position);
+
+    hardware_backend_command_movement(p_hardware, new_movement);
+
+    // Only update the movement when the elevator is at a floor and leaving
+    if (fsm_elevator_is_at_a_floor(current_position)) {
+        *p_movement_when_left_floor = new_movement;
+    }
 }
 
 static bool fsm_elevator_is_at_a_floor(const Position position) {
     return position.floor != FLOOR_UNDEFINED && position.offset == OFFSET_AT_FLOOR;
 }
 
-static Position fsm_decide_elevator_position(const int last_floor, const HardwareMovement movement_when_left_floor) {
+static Position fsm_decide_elevator_position(const int last_floor,
+                                             const HardwareMovement movement_when_left_floor,
+                                             const HardwareSnapshot* p_snapshot) {
     int new_floor = last_floor;
     Offset offset = OFFSET_UNDEFINED;
 
-    const int current_floor = fsm_get_current_floor();
-    if (current_floor != FLOOR_UNDEFINED) {
-        new_floor = current_floor;
+    if (p_snapshot->floor != FLOOR_UNDEFINED) {
+        new_floor = p_snapshot->floor;
         offset = OFFSET_AT_FLOOR;
     }
 
@@ -414,23 +493,48 @@ static Position fsm_decide_elevator_position(const int last_floor, const Hardwar
  * #################################################################################################################
  */
 
-static void fsm_clear_order_lights() {
-    for (unsigned int floor = 0; floor < HARDWARE_NUMBER_OF_FLOORS; floor++) {
-        for (HardwareOrder order_type = HARDWARE_ORDER_UP; order_type <= HARDWARE_ORDER_DOWN; order_type++) {
-            hardware_command_order_light(floor, order_type, false);
-        }
+static void fsm_clear_order_lights(const HardwareBackend* p_hardware) {
+    const uint64_t no_lights[HARDWARE_NUMBER_OF_ORDER_WORDS] = {0};
+    hardware_backend_command_order_lights(p_hardware, no_lights, NULL);
+}
+
+static bool fsm_detect_new_orders(const HardwareSnapshot* p_snapshot,
+                                  uint64_t* p_previous_orders,
+                                  uint64_t* p_new_orders) {
+    uint64_t any_new_orders = 0;
+
+    for (int word = 0; word < HARDWARE_NUMBER_OF_ORDER_WORDS; word++) {
+        p_new_orders[word] = p_snapshot->orders[word] & ~p_previous_orders[word];
+        p_previous_orders[word] = p_snapshot->orders[word];
+        any_new_orders |= p_new_orders[word];
     }
+
+    return any_new_orders != 0;
 }
 
-static void fsm_manage_orders_and_update_queue(Order** pp_priority_queue, const Position current_position) {
-    for (unsigned int floor = 0; floor < HARDWARE_NUMBER_OF_FLOORS; floor++) {
-        for (HardwareOrder order_type = HARDWARE_ORDER_UP; order_type <= HARDWARE_ORDER_DOWN; order_type++) {
-            if (hardware_read_order(floor, order_type)) {
-                *pp_priority_queue = priority_queue_add_order(priority_queue_order_create(floor, order_type),
-                                                              *pp_priority_queue,
-                                                              current_position);
-                hardware_command_order_light(floor, order_type, true);
-            }
+static void fsm_manage_orders_and_update_queue(const HardwareBackend* p_hardware,
+                                               Order** pp_priority_queue,
+                                               const Position current_position,
+                                               const HardwareSnapshot* p_snapshot,
+                                               uint64_t* p_previous_orders) {
+    uint64_t new_orders[HARDWARE_NUMBER_OF_ORDER_WORDS];
+    if (!fsm_detect_new_orders(p_snapshot, p_previous_orders, new_orders)) {
+        return;
+    }
+
+    for (int word = 0; word < HARDWARE_NUMBER_OF_ORDER_WORDS; word++) {
+        while (new_orders[word]) {
+            const unsigned int bit = word * 64 + __builtin_ctzll(new_orders[word]);
+            const int floor = bit / HARDWARE_NUMBER_OF_BUTTONS;
+            const HardwareOrder order_type = (HardwareOrder)(bit % HARDWARE_NUMBER_OF_BUTTONS);
+
+            *pp_priority_queue = priority_queue_add_order(priority_queue_order_create(floor, order_type),
+                                                          *pp_priority_queue,
+                                                          current_position);
+            hardware_backend_command_order_light(p_hardware, floor, order_type, true);
+            event_log_record(p_hardware->p_event_log, EVENT_TYPE_ORDER_ADD, floor, order_type);
+
+            new_orders[word] &= new_orders[word] - 1;
         }
     }
 }
@@ -439,22 +543,21 @@ static bool fsm_top_order_is_at_floor(const Order* p_priority_queue, const int f
     return !priority_queue_is_empty(p_priority_queue) && p_priority_queue->floor == floor;
 }
 
-static void fsm_clear_top_order_and_update_order_lights(Order** pp_priority_queue, const Position current_position) {
-    for (unsigned int order_type = HARDWARE_ORDER_UP; order_type <= HARDWARE_ORDER_DOWN; order_type++) {
-        hardware_command_order_light((*pp_priority_queue)->floor, order_type, false);
+static void fsm_clear_top_order_and_update_order_lights(const HardwareBackend* p_hardware,
+                                                       Order** pp_priority_queue,
+                                                       const Position current_position) {
+    const uint64_t no_lights[HARDWARE_NUMBER_OF_ORDER_WORDS] = {0};
+    uint64_t floor_lights[HARDWARE_NUMBER_OF_ORDER_WORDS] = {0};
+    for (HardwareOrder order_type = HARDWARE_ORDER_UP; order_type <= HARDWARE_ORDER_DOWN; order_type++) {
+        floor_lights[HARDWARE_ORDER_WORD((*pp_priority_queue)->floor, order_type)] |=
+            HARDWARE_ORDER_BIT((*pp_priority_queue)->floor, order_type);
     }
+    hardware_backend_command_order_lights(p_hardware, no_lights, floor_lights);
 
+    event_log_record(p_hardware->p_event_log,
+                     EVENT_TYPE_ORDER_POP,
+                     (*pp_priority_queue)->floor,
+                     (*pp_priority_queue)->direction);
     *pp_priority_queue = priority_queue_pop(*pp_priority_queue);
     *pp_priority_queue = priority_queue_reorder_based_on_position(*pp_priority_queue, current_position);
 }
-
-/**
- * #################################################################################################################
- * #####                                       INTERRUPTS                                                      #####
- * #################################################################################################################
- */
-
-static void fsm_sigint_handler(int sig) {
-    (void)(sig);
-    m_fsm_should_abort = true;
-}
\ No newline at end of file
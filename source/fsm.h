@@ -1,14 +1,123 @@
 /**
  * @file
- * @brief Finite state machine for the elevator.
+ * @brief Finite state machine for the elevator. All the state of one elevator is kept in an #Elevator, and the FSM is
+ *        stepped with the inputs and the time given by the caller, so any number of elevators can be run side by side
+ *        in one process, each on its own hardware backend.
  */
 
 #ifndef FSM_H
 #define FSM_H
 
+#include <stdint.h>
+
+#include "door.h"
+#include "hardware.h"
+#include "hardware_backend.h"
+#include "priority_queue.h"
+#include "timer.h"
+
+/**
+ * @brief The possible states for the state machine.
+ */
+typedef enum {
+    STATE_STARTUP,
+    STATE_IDLE,
+    STATE_MOVE,
+    STATE_DOOR_OPEN,
+    STATE_STOP,
+    STATE_UNDEFINED
+} State;
+
+/**
+ * @brief An elevator controlled by the FSM.
+ *
+ * @note The door refers to the hardware and the timers of the elevator, so an elevator must not be moved in memory
+ *       between #fsm_init and #fsm_deinit.
+ */
+typedef struct {
+    /**
+     * @brief The hardware the elevator is commanded through.
+     */
+    HardwareBackend hardware;
+
+    /**
+     * @brief The timers of the elevator.
+     */
+    TimerService timers;
+
+    /**
+     * @brief The door of the elevator.
+     */
+    Door door;
+
+    /**
+     * @brief The state the FSM is in.
+     */
+    State current_state;
+
+    /**
+     * @brief The last floor the elevator was at, -1 until it has reached one.
+     */
+    int last_floor;
+
+    /**
+     * @brief The movement of the elevator when it last left a floor.
+     */
+    HardwareMovement movement_when_left_floor;
+
+    /**
+     * @brief The orders of the elevator.
+     */
+    Order* p_priority_queue;
+
+    /**
+     * @brief The order buttons pressed the last time orders were managed, cleared when entering the stop and startup
+     *        states.
+     */
+    uint64_t previous_orders[HARDWARE_NUMBER_OF_ORDER_WORDS];
+} Elevator;
+
+/**
+ * @brief Sets up @p p_elevator in its startup state.
+ *
+ * @param[out] p_elevator The elevator.
+ * @param[in] p_hardware The hardware of the elevator, copied into @p p_elevator.
+ */
+void fsm_init(Elevator* p_elevator, const HardwareBackend* p_hardware);
+
+/**
+ * @brief Runs one iteration of the FSM: changes state if needed, updates the orders and the door, and expires timers.
+ *
+ * @param[in, out] p_elevator The elevator.
+ * @param[in] p_inputs The hardware input of the elevator, sampled for this iteration.
+ * @param[in] now_ms The current time in milliseconds. Must never go backwards, but can be on any time base.
+ */
+void fsm_step(Elevator* p_elevator, const HardwareSnapshot* p_inputs, const uint64_t now_ms);
+
+/**
+ * @brief Gets the time the FSM next has to be stepped at even if no input changes, e.g. to close the door.
+ *
+ * @param[in] p_elevator The elevator.
+ *
+ * @return The time, on the time base of #fsm_step, #TIMER_NO_DEADLINE if there is none.
+ */
+uint64_t fsm_next_deadline_ms(const Elevator* p_elevator);
+
+/**
+ * @brief Gets the position of @p p_elevator, the way #fsm_step sees it.
+ *
+ * @param[in] p_elevator The elevator.
+ * @param[in] p_inputs The hardware input of the elevator.
+ *
+ * @return The position, with floor -1 until the elevator has reached a floor.
+ */
+Position fsm_get_position(const Elevator* p_elevator, const HardwareSnapshot* p_inputs);
+
 /**
- * @brief Starts the FSM.
+ * @brief Clears the orders of @p p_elevator and stops it.
+ *
+ * @param[in, out] p_elevator The elevator.
  */
-void fsm_run();
+void fsm_deinit(Elevator* p_elevator);
 
 #endif
@@ -0,0 +1,379 @@
+/**
+ * @file
+ * @brief Implementation of the group of cars.
+ */
+
+#include "group.h"
+
+#include <string.h>
+
+/**
+ * @brief The order types of the hall buttons.
+ */
+static const HardwareOrder m_group_hall_order_types[] = {HARDWARE_ORDER_UP, HARDWARE_ORDER_DOWN};
+
+/**
+ * @brief Gets the floor of the bit numbered @p bit in @c HardwareSnapshot::orders.
+ *
+ * @param[in] bit The bit, counted from the first word.
+ *
+ * @return The floor.
+ */
+static int group_bit_floor(const unsigned int bit) {
+    return bit / HARDWARE_NUMBER_OF_BUTTONS;
+}
+
+/**
+ * @brief Gets the order type of the bit numbered @p bit in @c HardwareSnapshot::orders.
+ *
+ * @param[in] bit The bit, counted from the first word.
+ *
+ * @return The order type.
+ */
+static HardwareOrder group_bit_order_type(const unsigned int bit) {
+    return (HardwareOrder)(bit % HARDWARE_NUMBER_OF_BUTTONS);
+}
+
+/**
+ * #################################################################################################################
+ * #####                                       CAR HARDWARE                                                    #####
+ * #################################################################################################################
+ */
+
+/**
+ * @brief Records the movement of the car at @p p_context, and forwards it to its hardware.
+ *
+ * @param[in, out] p_context The #GroupCar.
+ * @param[in] movement The movement.
+ */
+static void group_car_command_movement(void* p_context, const HardwareMovement movement) {
+    GroupCar* p_car = p_context;
+
+    p_car->movement = movement;
+    p_car->hardware.p_operations->command_movement(p_car->hardware.p_context, movement);
+}
+
+/**
+ * @brief Records a cab light of the car at @p p_context, and forwards it to its hardware. The hall lights are driven
+ *        by the group, so those of the FSM are dropped.
+ *
+ * @param[in, out] p_context The #GroupCar.
+ * @param[in] floor The floor of the light.
+ * @param[in] order_type The order type of the light.
+ * @param[in] on Whether to turn the light on.
+ */
+static void group_car_command_order_light(void* p_context,
+                                          const int floor,
+                                          const HardwareOrder order_type,
+                                          const bool on) {
+    GroupCar* p_car = p_context;
+
+    if (order_type == HARDWARE_ORDER_INSIDE) {
+        const int word = HARDWARE_ORDER_WORD(floor, order_type);
+        const uint64_t bit = HARDWARE_ORDER_BIT(floor, order_type);
+        p_car->cab_lights[word] = on ? p_car->cab_lights[word] | bit : p_car->cab_lights[word] & ~bit;
+
+        p_car->hardware.p_operations->command_order_light(p_car->hardware.p_context, floor, order_type, on);
+    }
+}
+
+/**
+ * @brief Records the cab lights among @p p_mask of the car at @p p_context, and forwards them to its hardware.
+ *
+ * @param[in, out] p_context The #GroupCar.
+ * @param[in] p_lights The lights, see #hardware_backend_command_order_lights.
+ * @param[in] p_mask The lights to set, NULL for all.
+ */
+static void group_car_command_order_lights(void* p_context, const uint64_t* p_lights, const uint64_t* p_mask) {
+    GroupCar* p_car = p_context;
+
+    uint64_t cab_light_mask[HARDWARE_NUMBER_OF_ORDER_WORDS] = {0};
+    for (int floor = 0; floor < p_car->hardware.number_of_floors; floor++) {
+        const int word = HARDWARE_ORDER_WORD(floor, HARDWARE_ORDER_INSIDE);
+        const uint64_t bit = HARDWARE_ORDER_BIT(floor, HARDWARE_ORDER_INSIDE);
+
+        if (!p_mask || (p_mask[word] & bit)) {
+            cab_light_mask[word] |= bit;
+        }
+    }
+
+    for (int word = 0; word < HARDWARE_NUMBER_OF_ORDER_WORDS; word++) {
+        p_car->cab_lights[word] = (p_car->cab_lights[word] & ~cab_light_mask[word]) |
+                                  (p_lights[word] & cab_light_mask[word]);
+    }
+
+    hardware_backend_command_order_lights(&p_car->hardware, p_lights, cab_light_mask);
+}
+
+/**
+ * @brief Forwards the floor indicator to the hardware of the car at @p p_context.
+ */
+static void group_car_command_floor_indicator_on(void* p_context, const int floor) {
+    GroupCar* p_car = p_context;
+    p_car->hardware.p_operations->command_floor_indicator_on(p_car->hardware.p_context, floor);
+}
+
+/**
+ * @brief Forwards the door to the hardware of the car at @p p_context.
+ */
+static void group_car_command_door_open(void* p_context, const bool door_open) {
+    GroupCar* p_car = p_context;
+    p_car->hardware.p_operations->command_door_open(p_car->hardware.p_context, door_open);
+}
+
+/**
+ * @brief Forwards the stop light to the hardware of the car at @p p_context.
+ */
+static void group_car_command_stop_light(void* p_context, const bool on) {
+    GroupCar* p_car = p_context;
+    p_car->hardware.p_operations->command_stop_light(p_car->hardware.p_context, on);
+}
+
+/**
+ * @brief The hardware the FSM of a car is given, which forwards to the hardware of the car.
+ */
+static const HardwareBackendOperations m_group_car_operations = {
+    .command_movement = group_car_command_movement,
+    .command_order_light = group_car_command_order_light,
+    .command_floor_indicator_on = group_car_command_floor_indicator_on,
+    .command_door_open = group_car_command_door_open,
+    .command_stop_light = group_car_command_stop_light,
+    .command_order_lights = group_car_command_order_lights,
+};
+
+/**
+ * #################################################################################################################
+ * #####                                       CALLS                                                           #####
+ * #################################################################################################################
+ */
+
+/**
+ * @brief Finds the hall buttons which are pressed in the inputs of any car, but were not in the previous step.
+ *
+ * @param[in, out] p_group The group.
+ * @param[in] p_inputs The inputs of each car.
+ * @param[out] p_new_hall_calls The new hall calls.
+ */
+static void group_detect_new_hall_calls(Group* p_group, const HardwareSnapshot* p_inputs, uint64_t* p_new_hall_calls) {
+    for (int word = 0; word < HARDWARE_NUMBER_OF_ORDER_WORDS; word++) {
+        uint64_t hall_calls = 0;
+        for (int car = 0; car < p_group->number_of_cars; car++) {
+            hall_calls |= p_inputs[car].orders[word];
+        }
+        hall_calls &= p_group->hall_call_mask[word];
+
+        p_new_hall_calls[word] = hall_calls & ~p_group->previous_hall_calls[word];
+        p_group->previous_hall_calls[word] = hall_calls;
+    }
+}
+
+/**
+ * @brief Gives the dispatcher the cab calls of @p car from its cab lights, which are on for as long as the FSM of the
+ *        car holds the order. A cab button the FSM ignored, as it does in its stop and startup states, is left out.
+ *
+ * @param[in, out] p_group The group.
+ * @param[in] car The car.
+ */
+static void group_update_cab_calls(Group* p_group, const int car) {
+    const GroupCar* p_car = &p_group->cars[car];
+
+    for (int floor = 0; floor < p_group->number_of_floors; floor++) {
+        const int word = HARDWARE_ORDER_WORD(floor, HARDWARE_ORDER_INSIDE);
+        const uint64_t bit = HARDWARE_ORDER_BIT(floor, HARDWARE_ORDER_INSIDE);
+
+        if (p_car->cab_lights[word] & bit) {
+            dispatcher_add_cab_call(&p_group->dispatcher, car, floor);
+        } else {
+            dispatcher_remove_cab_call(&p_group->dispatcher, car, floor);
+        }
+    }
+}
+
+/**
+ * @brief Gets the inputs the FSM of @p car is stepped with: the inputs of the car, with the hall buttons of the hall
+ *        calls assigned to the car pressed and no others. A call is pressed for as long as it is assigned, so the FSM
+ *        adds it once.
+ *
+ * @param[in] p_group The group.
+ * @param[in] car The car.
+ * @param[in] p_inputs The inputs of the car.
+ * @param[out] p_car_inputs The inputs of the FSM.
+ */
+static void group_make_car_inputs(const Group* p_group,
+                                  const int car,
+                                  const HardwareSnapshot* p_inputs,
+                                  HardwareSnapshot* p_car_inputs) {
+    *p_car_inputs = *p_inputs;
+
+    for (int word = 0; word < HARDWARE_NUMBER_OF_ORDER_WORDS; word++) {
+        p_car_inputs->orders[word] &= ~p_group->hall_call_mask[word];
+    }
+
+    for (int floor = 0; floor < p_group->number_of_floors; floor++) {
+        for (int i = 0; i < 2; i++) {
+            const HardwareOrder order_type = m_group_hall_order_types[i];
+            if (dispatcher_get_hall_call_car(&p_group->dispatcher, floor, order_type) == car) {
+                p_car_inputs->orders[HARDWARE_ORDER_WORD(floor, order_type)] |= HARDWARE_ORDER_BIT(floor, order_type);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Clears the calls of @p car as served where its door is open.
+ *
+ * @param[in, out] p_group The group.
+ * @param[in] car The car.
+ * @param[in] position The position of the car.
+ */
+static void group_clear_served_calls(Group* p_group, const int car, const Position position) {
+    const State state = p_group->cars[car].elevator.current_state;
+
+    if (state == STATE_DOOR_OPEN && position.offset == OFFSET_AT_FLOOR) {
+        dispatcher_car_served_floor(&p_group->dispatcher, car, position.floor);
+    }
+}
+
+/**
+ * @brief Takes @p car out of service while it is stopped or starting up, as its FSM then drops its orders and
+ *        ignores the buttons. Its hall calls are handed back to the dispatcher, for another car to take.
+ *
+ * @param[in, out] p_group The group.
+ * @param[in] car The car.
+ */
+static void group_update_car_in_service(Group* p_group, const int car) {
+    const State state = p_group->cars[car].elevator.current_state;
+    dispatcher_set_car_in_service(&p_group->dispatcher, car, state != STATE_STOP && state != STATE_STARTUP);
+}
+
+/**
+ * @brief Sets the hall lights of every car from the hall calls of the dispatcher, only commanding the lights which
+ *        changed.
+ *
+ * @param[in, out] p_group The group.
+ */
+static void group_update_hall_lights(Group* p_group) {
+    uint64_t lights[HARDWARE_NUMBER_OF_ORDER_WORDS] = {0};
+    for (int floor = 0; floor < p_group->number_of_floors; floor++) {
+        for (int i = 0; i < 2; i++) {
+            const HardwareOrder order_type = m_group_hall_order_types[i];
+            if (dispatcher_hall_light_is_on(&p_group->dispatcher, floor, order_type)) {
+                lights[HARDWARE_ORDER_WORD(floor, order_type)] |= HARDWARE_ORDER_BIT(floor, order_type);
+            }
+        }
+    }
+
+    uint64_t changed_lights[HARDWARE_NUMBER_OF_ORDER_WORDS];
+    uint64_t any_changed_lights = 0;
+    for (int word = 0; word < HARDWARE_NUMBER_OF_ORDER_WORDS; word++) {
+        changed_lights[word] = lights[word] ^ p_group->hall_lights[word];
+        any_changed_lights |= changed_lights[word];
+    }
+
+    if (!any_changed_lights) {
+        return;
+    }
+
+    for (int car = 0; car < p_group->number_of_cars; car++) {
+        hardware_backend_command_order_lights(&p_group->cars[car].hardware, lights, changed_lights);
+    }
+    memcpy(p_group->hall_lights, lights, sizeof(lights));
+}
+
+/**
+ * #################################################################################################################
+ * #####                                       GROUP                                                           #####
+ * #################################################################################################################
+ */
+
+void group_init(Group* p_group,
+                const HardwareBackend* p_hardware,
+                const int number_of_cars,
+                const double travel_time,
+                const double stop_time) {
+    memset(p_group, 0, sizeof(*p_group));
+
+    p_group->number_of_cars = number_of_cars > DISPATCHER_MAX_NUMBER_OF_CARS ? DISPATCHER_MAX_NUMBER_OF_CARS
+                                                                             : number_of_cars;
+    p_group->number_of_floors = p_group->number_of_cars > 0 ? p_hardware[0].number_of_floors : 0;
+    dispatcher_init(&p_group->dispatcher, p_group->number_of_floors, p_group->number_of_cars, travel_time, stop_time);
+
+    for (int floor = 0; floor < p_group->number_of_floors; floor++) {
+        for (int i = 0; i < 2; i++) {
+            const HardwareOrder order_type = m_group_hall_order_types[i];
+            p_group->hall_call_mask[HARDWARE_ORDER_WORD(floor, order_type)] |= HARDWARE_ORDER_BIT(floor, order_type);
+        }
+    }
+
+    for (int car = 0; car < p_group->number_of_cars; car++) {
+        GroupCar* p_car = &p_group->cars[car];
+        p_car->hardware = p_hardware[car];
+        p_car->movement = HARDWARE_MOVEMENT_STOP;
+
+        const HardwareBackend car_hardware = {
+            .p_operations = &m_group_car_operations,
+            .p_context = p_car,
+            .number_of_floors = p_group->number_of_floors,
+            .p_event_log = p_car->hardware.p_event_log,
+        };
+        fsm_init(&p_car->elevator, &car_hardware);
+        group_update_car_in_service(p_group, car);
+
+        hardware_backend_command_order_lights(&p_car->hardware, p_group->hall_lights, p_group->hall_call_mask);
+    }
+}
+
+void group_step(Group* p_group, const HardwareSnapshot* p_inputs, const uint64_t now_ms) {
+    uint64_t new_hall_calls[HARDWARE_NUMBER_OF_ORDER_WORDS];
+    group_detect_new_hall_calls(p_group, p_inputs, new_hall_calls);
+
+    for (int car = 0; car < p_group->number_of_cars; car++) {
+        const GroupCar* p_car = &p_group->cars[car];
+        dispatcher_update_car(&p_group->dispatcher,
+                              car,
+                              fsm_get_position(&p_car->elevator, &p_inputs[car]),
+                              p_car->movement);
+    }
+
+    dispatcher_assign_unassigned_hall_calls(&p_group->dispatcher);
+    for (int word = 0; word < HARDWARE_NUMBER_OF_ORDER_WORDS; word++) {
+        while (new_hall_calls[word]) {
+            const unsigned int bit = word * 64 + __builtin_ctzll(new_hall_calls[word]);
+            dispatcher_assign_hall_call(&p_group->dispatcher, group_bit_floor(bit), group_bit_order_type(bit));
+
+            new_hall_calls[word] &= new_hall_calls[word] - 1;
+        }
+    }
+
+    for (int car = 0; car < p_group->number_of_cars; car++) {
+        Elevator* p_elevator = &p_group->cars[car].elevator;
+
+        HardwareSnapshot car_inputs;
+        group_make_car_inputs(p_group, car, &p_inputs[car], &car_inputs);
+        fsm_step(p_elevator, &car_inputs, now_ms);
+
+        group_clear_served_calls(p_group, car, fsm_get_position(p_elevator, &car_inputs));
+        group_update_car_in_service(p_group, car);
+        group_update_cab_calls(p_group, car);
+    }
+
+    group_update_hall_lights(p_group);
+}
+
+uint64_t group_next_deadline_ms(const Group* p_group) {
+    uint64_t deadline_ms = TIMER_NO_DEADLINE;
+    for (int car = 0; car < p_group->number_of_cars; car++) {
+        const uint64_t car_deadline_ms = fsm_next_deadline_ms(&p_group->cars[car].elevator);
+        if (car_deadline_ms < deadline_ms) {
+            deadline_ms = car_deadline_ms;
+        }
+    }
+
+    return deadline_ms;
+}
+
+void group_deinit(Group* p_group) {
+    for (int car = 0; car < p_group->number_of_cars; car++) {
+        fsm_deinit(&p_group->cars[car].elevator);
+    }
+}
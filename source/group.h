@@ -0,0 +1,118 @@
+/**
+ * @file
+ * @brief A group of cars in one building, each driven by its own FSM on its own hardware, with the hall calls shared
+ *        between them by a #Dispatcher.
+ *
+ * The hall buttons are shared by the cars, so a hall button counts as pressed if it is pressed in the inputs of any
+ * car. A new hall call goes to the car picked by #dispatcher_assign_hall_call, whose FSM sees it as a press of the
+ * button. A car is out of service while it is stopped or starting up, and its hall calls are handed to other cars. A
+ * call no car can take yet is kept, and assigned on a later step. Cab calls are left to the FSM of the car they were
+ * made in, and the dispatcher counts those the FSM took. The hall lights are driven by the group from
+ * #dispatcher_hall_light_is_on, on the hardware of every car, and the FSMs only drive the cab lights of their car.
+ */
+
+#ifndef GROUP_H
+#define GROUP_H
+
+#include <stdint.h>
+
+#include "dispatcher.h"
+#include "fsm.h"
+#include "hardware.h"
+#include "hardware_backend.h"
+
+/**
+ * @brief One car of a group.
+ */
+typedef struct {
+    /**
+     * @brief The FSM of the car, commanding the car through the group.
+     */
+    Elevator elevator;
+
+    /**
+     * @brief The hardware of the car.
+     */
+    HardwareBackend hardware;
+
+    /**
+     * @brief The movement last commanded by the FSM, #HARDWARE_MOVEMENT_STOP when idle.
+     */
+    HardwareMovement movement;
+
+    /**
+     * @brief The cab lights as last commanded by the FSM, laid out like @c HardwareSnapshot::orders.
+     */
+    uint64_t cab_lights[HARDWARE_NUMBER_OF_ORDER_WORDS];
+} GroupCar;
+
+/**
+ * @brief A group of cars.
+ *
+ * @note The FSMs refer to their cars, so a group must not be moved in memory between #group_init and #group_deinit.
+ */
+typedef struct {
+    int number_of_floors;
+    int number_of_cars;
+    GroupCar cars[DISPATCHER_MAX_NUMBER_OF_CARS];
+    Dispatcher dispatcher;
+
+    /**
+     * @brief The bits of the hall buttons of the floors of the building, laid out like @c HardwareSnapshot::orders.
+     */
+    uint64_t hall_call_mask[HARDWARE_NUMBER_OF_ORDER_WORDS];
+
+    /**
+     * @brief The hall buttons pressed in the previous step.
+     */
+    uint64_t previous_hall_calls[HARDWARE_NUMBER_OF_ORDER_WORDS];
+
+    /**
+     * @brief The hall lights as last commanded.
+     */
+    uint64_t hall_lights[HARDWARE_NUMBER_OF_ORDER_WORDS];
+} Group;
+
+/**
+ * @brief Sets up a group of cars in their startup state, with no calls and the hall lights off.
+ *
+ * @param[out] p_group The group.
+ * @param[in] p_hardware The hardware of each car, copied into @p p_group. Every car must have the same number of
+ *                       floors.
+ * @param[in] number_of_cars Number of cars, at most #DISPATCHER_MAX_NUMBER_OF_CARS.
+ * @param[in] travel_time Seconds a car takes to travel from one floor to the next, see #dispatcher_init.
+ * @param[in] stop_time Seconds a stop takes, see #dispatcher_init.
+ */
+void group_init(Group* p_group,
+                const HardwareBackend* p_hardware,
+                const int number_of_cars,
+                const double travel_time,
+                const double stop_time);
+
+/**
+ * @brief Runs one iteration of the group: assigns the new hall calls, steps the FSM of every car, and updates the
+ *        hall lights.
+ *
+ * @param[in, out] p_group The group.
+ * @param[in] p_inputs The hardware input of each car, sampled for this iteration.
+ * @param[in] now_ms The current time in milliseconds, see #fsm_step.
+ */
+void group_step(Group* p_group, const HardwareSnapshot* p_inputs, const uint64_t now_ms);
+
+/**
+ * @brief Gets the time the group next has to be stepped at even if no input changes.
+ *
+ * @param[in] p_group The group.
+ *
+ * @return The earliest deadline of the cars, #TIMER_NO_DEADLINE if there is none.
+ */
+uint64_t group_next_deadline_ms(const Group* p_group);
+
+/**
+ * @brief Clears the orders of every car and stops them.
+ *
+ * @param[in, out] p_group The group.
+ */
+void group_deinit(Group* p_group);
+
+#endif
@@ -9,7 +9,21 @@
  */
 #ifndef HARDWARE_H
 #define HARDWARE_H
-#define HARDWARE_NUMBER_OF_FLOORS 4
+
+#include <stdint.h>
+
+/**
+ * @brief Number of floors used unless another number is set with
+ * @c hardware_set_number_of_floors, the floors of the lab rig.
+ */
+#define HARDWARE_DEFAULT_NUMBER_OF_FLOORS 4
+
+/**
+ * @brief Highest number of floors supported, the size of every
+ * per-floor table.
+ */
+#define HARDWARE_MAX_NUMBER_OF_FLOORS 128
+
 #define HARDWARE_NUMBER_OF_BUTTONS 3
 
 /**
@@ -31,6 +45,76 @@ typedef enum {
     HARDWARE_ORDER_DOWN
 } HardwareOrder;
 
+/**
+ * @brief Number of 64 bit words in @c HardwareSnapshot::orders.
+ */
+#define HARDWARE_NUMBER_OF_ORDER_WORDS \
+    ((HARDWARE_MAX_NUMBER_OF_FLOORS * HARDWARE_NUMBER_OF_BUTTONS + 63) / 64)
+
+/**
+ * @brief Index of the bit in @c HardwareSnapshot::orders for an
+ * order of type @p order_type at floor @p floor.
+ */
+#define HARDWARE_ORDER_INDEX(floor, order_type) \
+    ((floor) * HARDWARE_NUMBER_OF_BUTTONS + (order_type))
+
+/**
+ * @brief Word in @c HardwareSnapshot::orders holding the bit for an
+ * order of type @p order_type at floor @p floor.
+ */
+#define HARDWARE_ORDER_WORD(floor, order_type) \
+    (HARDWARE_ORDER_INDEX(floor, order_type) / 64)
+
+/**
+ * @brief Bit within #HARDWARE_ORDER_WORD for an order of type
+ * @p order_type at floor @p floor.
+ */
+#define HARDWARE_ORDER_BIT(floor, order_type) \
+    (UINT64_C(1) << (HARDWARE_ORDER_INDEX(floor, order_type) % 64))
+
+/**
+ * @brief Every input of the elevator hardware, sampled in one go
+ * by @c hardware_read_snapshot.
+ */
+typedef struct {
+    /**
+     * @brief Order buttons currently pressed, one bit per button as
+     * given by #HARDWARE_ORDER_WORD and #HARDWARE_ORDER_BIT.
+     */
+    uint64_t orders[HARDWARE_NUMBER_OF_ORDER_WORDS];
+
+    /**
+     * @brief The floor the elevator is at, or -1 if it is between floors.
+     */
+    int floor;
+
+    /**
+     * @brief 1 if the stop signal is high; 0 if it is low.
+     */
+    int stop_signal;
+
+    /**
+     * @brief 1 if the obstruction signal is high; 0 if it is low.
+     */
+    int obstruction_signal;
+} HardwareSnapshot;
+
+/**
+ * @brief Number of writes to the outputs, see
+ * @c hardware_get_output_statistics.
+ */
+typedef struct {
+    /**
+     * @brief Writes which changed an output and reached the hardware.
+     */
+    unsigned long writes_issued;
+
+    /**
+     * @brief Writes which left an output unchanged and were dropped.
+     */
+    unsigned long writes_suppressed;
+} HardwareOutputStatistics;
+
 /**
  * @brief Initializes the elevator control hardware.
  * Must be called once before other calls to the elevator
@@ -40,6 +124,54 @@ typedef enum {
  */
 int hardware_init();
 
+/**
+ * @brief Sets the number of floors of the elevator. Must be called
+ * before @c hardware_init, which otherwise uses
+ * #HARDWARE_DEFAULT_NUMBER_OF_FLOORS.
+ *
+ * @param number_of_floors Number of floors, at least 2 and at most
+ * #HARDWARE_MAX_NUMBER_OF_FLOORS.
+ *
+ * @return 0 on success. Non-zero if the driver does not support
+ * @p number_of_floors floors.
+ */
+int hardware_set_number_of_floors(int number_of_floors);
+
+/**
+ * @brief Gets the number of floors of the elevator.
+ *
+ * @return The number of floors.
+ */
+int hardware_get_number_of_floors();
+
+/**
+ * @brief Gets a file descriptor which becomes readable when the
+ * hardware has input for us, e.g. for use with @c epoll.
+ *
+ * @return The file descriptor, or -1 if the driver has none.
+ */
+int hardware_event_fd();
+
+/**
+ * @brief Makes the hardware deliver its inputs asynchronously, so
+ * that the file descriptor of @c hardware_event_fd becomes readable
+ * when they change, instead of them only being polled. Must be
+ * called after @c hardware_init.
+ *
+ * @param scan_period_us Period of a hardware-timed scan of the inputs
+ * in microseconds, or 0 to be woken on every change of state.
+ *
+ * @return 0 on success. Non-zero if the driver or the hardware does
+ * not support it, in which case the inputs can still be polled. On
+ * the lab hardware both digital input subdevices must support
+ * asynchronous commands, and @p scan_period_us must be at most
+ * @c UINT_MAX / 1000, as Comedi takes it in nanoseconds.
+ *
+ * @note @c hardware_read_snapshot consumes what was delivered, so the
+ * descriptor only becomes readable again on the next change or scan.
+ */
+int hardware_start_input_acquisition(unsigned int scan_period_us);
+
 /**
  * @brief Commands the elevator to either move up or down,
  * or commands it to halt.
@@ -71,6 +203,13 @@ int hardware_read_obstruction_signal();
  */
 int hardware_read_floor_sensor(int floor);
 
+/**
+ * @brief Polls the floor sensors for the floor the elevator is at.
+ *
+ * @return The floor the elevator is at, or -1 if it is between floors.
+ */
+int hardware_read_current_floor();
+
 /**
  * @brief Polls the hardware for the status of orders from
  * floor @p floor of type @p order_type.
@@ -83,6 +222,18 @@ int hardware_read_floor_sensor(int floor);
  */
 int hardware_read_order(int floor, HardwareOrder order_type);
 
+/**
+ * @brief Polls every input of the hardware at once: order buttons,
+ * floor sensors, stop and obstruction.
+ *
+ * @param p_snapshot Snapshot to fill.
+ *
+ * @note Prefer this over the individual @c hardware_read_* calls
+ * when several inputs are needed, as the drivers can fetch them
+ * in a single exchange with the hardware.
+ */
+void hardware_read_snapshot(HardwareSnapshot* p_snapshot);
+
 /**
  * @brief Commands the hardware to open- or close the elevator door.
  *
@@ -123,4 +274,44 @@ void hardware_command_stop_light(int on);
  */
 void hardware_command_order_light(int floor, HardwareOrder order_type, int on);
 
+/**
+ * @brief Sets the lights in many order buttons at once, writing
+ * the lights which change in one go where the hardware allows it.
+ *
+ * @param p_lights Bitmap of the lights, laid out like
+ * @c HardwareSnapshot::orders. A set bit turns the light on, a
+ * clear bit turns it off.
+ * @param p_mask Bitmap of the lights to set, laid out the same way.
+ * The other lights are left as they are. NULL to set every light.
+ */
+void hardware_command_lights_bulk(const uint64_t* p_lights, const uint64_t* p_mask);
+
+/**
+ * @brief Enables or disables buffering of commands. While enabled, the
+ * @c hardware_command_* calls may be held back by the driver until
+ * @c hardware_flush is called, so they can be written in one go.
+ *
+ * @param enabled A truthy value (non-zero) to buffer commands; 0 to
+ * write every command immediately. Disabling flushes the buffer.
+ */
+void hardware_set_command_buffering(int enabled);
+
+/**
+ * @brief Writes every buffered command to the hardware.
+ *
+ * @note Reads flush the buffer first, so commands always reach the
+ * hardware in the order they were given relative to reads.
+ */
+void hardware_flush();
+
+/**
+ * @brief Gets the number of output writes which reached the hardware,
+ * and the number which were suppressed because they did not change
+ * the output. Every light, the door, the motor direction and the
+ * motor speed count as one output each.
+ *
+ * @param p_statistics Statistics to fill.
+ */
+void hardware_get_output_statistics(HardwareOutputStatistics* p_statistics);
+
 #endif
@@ -0,0 +1,54 @@
+/**
+ * @file
+ * @brief Implementation of the hardware backend commands.
+ */
+
+#include "hardware_backend.h"
+
+void hardware_backend_command_movement(const HardwareBackend* p_backend, const HardwareMovement movement) {
+    event_log_record_if_changed(p_backend->p_event_log, EVENT_TYPE_MOVEMENT, movement);
+    p_backend->p_operations->command_movement(p_backend->p_context, movement);
+}
+
+void hardware_backend_command_order_light(const HardwareBackend* p_backend,
+                                          const int floor,
+                                          const HardwareOrder order_type,
+                                          const bool on) {
+    p_backend->p_operations->command_order_light(p_backend->p_context, floor, order_type, on);
+}
+
+void hardware_backend_command_order_lights(const HardwareBackend* p_backend,
+                                           const uint64_t* p_lights,
+                                           const uint64_t* p_mask) {
+    if (p_backend->p_operations->command_order_lights) {
+        p_backend->p_operations->command_order_lights(p_backend->p_context, p_lights, p_mask);
+        return;
+    }
+
+    for (int floor = 0; floor < p_backend->number_of_floors; floor++) {
+        for (HardwareOrder order_type = HARDWARE_ORDER_UP; order_type <= HARDWARE_ORDER_DOWN; order_type++) {
+            const int word = HARDWARE_ORDER_WORD(floor, order_type);
+            const uint64_t bit = HARDWARE_ORDER_BIT(floor, order_type);
+
+            if (!p_mask || (p_mask[word] & bit)) {
+                p_backend->p_operations->command_order_light(p_backend->p_context,
+                                                             floor,
+                                                             order_type,
+                                                             (p_lights[word] & bit) != 0);
+            }
+        }
+    }
+}
+
+void hardware_backend_command_floor_indicator_on(const HardwareBackend* p_backend, const int floor) {
+    p_backend->p_operations->command_floor_indicator_on(p_backend->p_context, floor);
+}
+
+void hardware_backend_command_door_open(const HardwareBackend* p_backend, const bool door_open) {
+    event_log_record_if_changed(p_backend->p_event_log, EVENT_TYPE_DOOR, door_open);
+    p_backend->p_operations->command_door_open(p_backend->p_context, door_open);
+}
+
+void hardware_backend_command_stop_light(const HardwareBackend* p_backend, const bool on) {
+    p_backend->p_operations->command_stop_light(p_backend->p_context, on);
+}
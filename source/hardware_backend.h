@@ -0,0 +1,128 @@
+/**
+ * @file
+ * @brief The outputs of one elevator, as seen by its FSM. A backend either forwards to the linked hardware driver, or
+ *        to anything else implementing #HardwareBackendOperations, e.g. a simulated car, so that every elevator in a
+ *        process can have its own hardware.
+ */
+
+#ifndef HARDWARE_BACKEND_H
+#define HARDWARE_BACKEND_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "event_log.h"
+#include "hardware.h"
+
+/**
+ * @brief The commands of a backend, each called with the @c p_context of the backend. They mirror the
+ *        @c hardware_command_* calls of the driver.
+ */
+typedef struct {
+    void (*command_movement)(void* p_context, const HardwareMovement movement);
+    void (*command_order_light)(void* p_context, const int floor, const HardwareOrder order_type, const bool on);
+    void (*command_floor_indicator_on)(void* p_context, const int floor);
+    void (*command_door_open)(void* p_context, const bool door_open);
+    void (*command_stop_light)(void* p_context, const bool on);
+
+    /**
+     * @brief Sets many order lights at once, see #hardware_backend_command_order_lights. Optional, NULL for a backend
+     *        which has no cheaper way than setting them one by one with @c command_order_light.
+     */
+    void (*command_order_lights)(void* p_context, const uint64_t* p_lights, const uint64_t* p_mask);
+} HardwareBackendOperations;
+
+/**
+ * @brief The hardware of one elevator.
+ */
+typedef struct {
+    /**
+     * @brief The commands of the backend.
+     */
+    const HardwareBackendOperations* p_operations;
+
+    /**
+     * @brief Passed to every command, e.g. the simulated car.
+     */
+    void* p_context;
+
+    /**
+     * @brief Number of floors of the elevator.
+     */
+    int number_of_floors;
+
+    /**
+     * @brief Where the door and motor commands are logged, together with the state transitions and the orders of the
+     *        elevator. NULL to not log them.
+     */
+    EventLog* p_event_log;
+} HardwareBackend;
+
+/**
+ * @brief Gets a backend forwarding to the linked hardware driver, with the number of floors set in the driver.
+ *
+ * @return The backend.
+ *
+ * @note Implemented next to the drivers, so it is only available where a driver is linked. There is only one driver,
+ *       so there should only be one elevator using this backend.
+ */
+HardwareBackend hardware_backend_driver();
+
+/**
+ * @brief Commands the elevator to either move up or down, or commands it to halt. Logged if the movement changed.
+ *
+ * @param[in] p_backend The backend.
+ * @param[in] movement Commanded movement.
+ */
+void hardware_backend_command_movement(const HardwareBackend* p_backend, const HardwareMovement movement);
+
+/**
+ * @brief Sets the light in the button of an order of type @p order_type, at floor @p floor.
+ *
+ * @param[in] p_backend The backend.
+ * @param[in] floor The floor of the order indicator.
+ * @param[in] order_type The type of order.
+ * @param[in] on true to turn the light on, false to turn it off.
+ */
+void hardware_backend_command_order_light(const HardwareBackend* p_backend,
+                                          const int floor,
+                                          const HardwareOrder order_type,
+                                          const bool on);
+
+/**
+ * @brief Sets the lights in many order buttons at once. Backends without @c command_order_lights get the lights one
+ *        by one, by floor and then by order type.
+ *
+ * @param[in] p_backend The backend.
+ * @param[in] p_lights Bitmap of the lights, laid out like @c HardwareSnapshot::orders, a set bit for on.
+ * @param[in] p_mask Bitmap of the lights to set, laid out the same way, NULL to set every light of the elevator.
+ */
+void hardware_backend_command_order_lights(const HardwareBackend* p_backend,
+                                           const uint64_t* p_lights,
+                                           const uint64_t* p_mask);
+
+/**
+ * @brief Turns on the floor indicator for @p floor, turning off the others.
+ *
+ * @param[in] p_backend The backend.
+ * @param[in] floor Floor to turn on the indicator for.
+ */
+void hardware_backend_command_floor_indicator_on(const HardwareBackend* p_backend, const int floor);
+
+/**
+ * @brief Opens or closes the door. Logged if the door changed.
+ *
+ * @param[in] p_backend The backend.
+ * @param[in] door_open true to open the door, false to close it.
+ */
+void hardware_backend_command_door_open(const HardwareBackend* p_backend, const bool door_open);
+
+/**
+ * @brief Sets the light in the panel stop button.
+ *
+ * @param[in] p_backend The backend.
+ * @param[in] on true to turn the light on, false to turn it off.
+ */
+void hardware_backend_command_stop_light(const HardwareBackend* p_backend, const bool on);
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * @file
+ * @brief Implementation of the hardware channels.
+ */
+
+#include "hardware_channel.h"
+
+#include <string.h>
+
+_Static_assert(sizeof(HardwareSnapshot) % sizeof(uint64_t) == 0, "Snapshots are copied in 64 bit words");
+_Static_assert((HARDWARE_COMMAND_RING_CAPACITY & (HARDWARE_COMMAND_RING_CAPACITY - 1)) == 0,
+               "The capacity must be a power of two");
+
+void hardware_snapshot_seqlock_init(HardwareSnapshotSeqlock* p_seqlock, const HardwareSnapshot* p_snapshot) {
+    uint64_t words[HARDWARE_SNAPSHOT_NUMBER_OF_WORDS];
+    memcpy(words, p_snapshot, sizeof(words));
+
+    atomic_init(&p_seqlock->sequence, 0);
+    for (size_t i = 0; i < HARDWARE_SNAPSHOT_NUMBER_OF_WORDS; i++) {
+        atomic_init(&p_seqlock->words[i], words[i]);
+    }
+}
+
+void hardware_snapshot_seqlock_write(HardwareSnapshotSeqlock* p_seqlock, const HardwareSnapshot* p_snapshot) {
+    uint64_t words[HARDWARE_SNAPSHOT_NUMBER_OF_WORDS];
+    memcpy(words, p_snapshot, sizeof(words));
+
+    // Only this thread writes the sequence, so it can be read without ordering. The fence keeps the words from being
+    // written before the sequence turns odd.
+    const uint64_t sequence = atomic_load_explicit(&p_seqlock->sequence, memory_order_relaxed);
+    atomic_store_explicit(&p_seqlock->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    for (size_t i = 0; i < HARDWARE_SNAPSHOT_NUMBER_OF_WORDS; i++) {
+        atomic_store_explicit(&p_seqlock->words[i], words[i], memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&p_seqlock->sequence, sequence + 2, memory_order_release);
+}
+
+uint64_t hardware_snapshot_seqlock_read(HardwareSnapshotSeqlock* p_seqlock, HardwareSnapshot* p_snapshot) {
+    uint64_t words[HARDWARE_SNAPSHOT_NUMBER_OF_WORDS];
+    uint64_t sequence;
+
+    for (;;) {
+        sequence = atomic_load_explicit(&p_seqlock->sequence, memory_order_acquire);
+        if (sequence & 1) {
+            continue;
+        }
+
+        for (size_t i = 0; i < HARDWARE_SNAPSHOT_NUMBER_OF_WORDS; i++) {
+            words[i] = atomic_load_explicit(&p_seqlock->words[i], memory_order_relaxed);
+        }
+
+        // The fence keeps the words from being read after the sequence is checked again
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&p_seqlock->sequence, memory_order_relaxed) == sequence) {
+            break;
+        }
+    }
+
+    memcpy(p_snapshot, words, sizeof(words));
+
+    return sequence / 2;
+}
+
+void hardware_command_ring_init(HardwareCommandRing* p_ring) {
+    memset(p_ring->commands, 0, sizeof(p_ring->commands));
+    atomic_init(&p_ring->head, 0);
+    atomic_init(&p_ring->tail, 0);
+    p_ring->pending_head = 0;
+    p_ring->producer_tail = 0;
+    p_ring->consumer_head = 0;
+}
+
+bool hardware_command_ring_push(HardwareCommandRing* p_ring, const HardwareCommand* p_command) {
+    if (p_ring->pending_head - p_ring->producer_tail == HARDWARE_COMMAND_RING_CAPACITY) {
+        p_ring->producer_tail = atomic_load_explicit(&p_ring->tail, memory_order_acquire);
+        if (p_ring->pending_head - p_ring->producer_tail == HARDWARE_COMMAND_RING_CAPACITY) {
+            return false;
+        }
+    }
+
+    p_ring->commands[p_ring->pending_head & (HARDWARE_COMMAND_RING_CAPACITY - 1)] = *p_command;
+    p_ring->pending_head++;
+
+    return true;
+}
+
+bool hardware_command_ring_publish(HardwareCommandRing* p_ring) {
+    // Only the producer writes the head, so it can be read without ordering
+    if (atomic_load_explicit(&p_ring->head, memory_order_relaxed) == p_ring->pending_head) {
+        return false;
+    }
+
+    atomic_store_explicit(&p_ring->head, p_ring->pending_head, memory_order_release);
+
+    return true;
+}
+
+bool hardware_command_ring_pop(HardwareCommandRing* p_ring, HardwareCommand* p_command) {
+    const uint32_t tail = atomic_load_explicit(&p_ring->tail, memory_order_relaxed);
+    if (tail == p_ring->consumer_head) {
+        p_ring->consumer_head = atomic_load_explicit(&p_ring->head, memory_order_acquire);
+        if (tail == p_ring->consumer_head) {
+            return false;
+        }
+    }
+
+    *p_command = p_ring->commands[tail & (HARDWARE_COMMAND_RING_CAPACITY - 1)];
+    atomic_store_explicit(&p_ring->tail, tail + 1, memory_order_release);
+
+    return true;
+}
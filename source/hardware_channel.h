@@ -0,0 +1,181 @@
+/**
+ * @file
+ * @brief Lock-free channels between the thread stepping an elevator and a thread doing its I/O. The latest inputs
+ *        are published through a seqlock, and the commands are passed through a single producer, single consumer
+ *        ring. Neither side ever takes a lock or waits for the other, except for a producer facing a full ring.
+ */
+
+#ifndef HARDWARE_CHANNEL_H
+#define HARDWARE_CHANNEL_H
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hardware.h"
+
+/**
+ * @brief Number of commands the ring holds. Must be a power of two, and should hold every command of a step, even
+ *        one turning off every order light of the tallest building.
+ */
+#define HARDWARE_COMMAND_RING_CAPACITY 1024
+
+/**
+ * @brief Size of a cache line, the fields written by different threads are kept this far apart.
+ */
+#define HARDWARE_CHANNEL_CACHE_LINE_SIZE 64
+
+/**
+ * @brief Number of 64 bit words a #HardwareSnapshot is copied through in a #HardwareSnapshotSeqlock.
+ */
+#define HARDWARE_SNAPSHOT_NUMBER_OF_WORDS (sizeof(HardwareSnapshot) / sizeof(uint64_t))
+
+/**
+ * @brief The commands of the hardware.
+ */
+typedef enum {
+    HARDWARE_COMMAND_MOVEMENT,
+    HARDWARE_COMMAND_ORDER_LIGHT,
+    HARDWARE_COMMAND_FLOOR_INDICATOR_ON,
+    HARDWARE_COMMAND_DOOR_OPEN,
+    HARDWARE_COMMAND_STOP_LIGHT
+} HardwareCommandType;
+
+/**
+ * @brief One command passed through a #HardwareCommandRing.
+ */
+typedef struct {
+    /**
+     * @brief The #HardwareCommandType of the command.
+     */
+    uint8_t type;
+
+    /**
+     * @brief The #HardwareOrder of an order light, 0 for the other commands.
+     */
+    uint8_t order_type;
+
+    /**
+     * @brief The #HardwareMovement of a movement, 1 for on or open and 0 for off or closed, 0 for the floor indicator.
+     */
+    uint8_t value;
+
+    /**
+     * @brief The floor of an order light or the floor indicator, 0 for the other commands.
+     */
+    int32_t floor;
+} HardwareCommand;
+
+/**
+ * @brief The latest inputs, written by one thread and read by any number of threads. A reader retries while the
+ *        inputs are being written, so it always gets one whole snapshot and never blocks the writer.
+ */
+typedef struct {
+    /**
+     * @brief Odd while the snapshot is being written, incremented before and after every write.
+     */
+    _Atomic uint64_t sequence;
+
+    /**
+     * @brief The snapshot, copied word by word so that a read racing a write is well defined.
+     */
+    _Atomic uint64_t words[HARDWARE_SNAPSHOT_NUMBER_OF_WORDS];
+} HardwareSnapshotSeqlock;
+
+/**
+ * @brief A ring of commands, with one producer and one consumer. Commands pushed by the producer are only seen by the
+ *        consumer once published, so the commands of a step are handed over with a single store.
+ */
+typedef struct {
+    HardwareCommand commands[HARDWARE_COMMAND_RING_CAPACITY];
+
+    /**
+     * @brief Number of commands ever published. Only written by the producer.
+     */
+    alignas(HARDWARE_CHANNEL_CACHE_LINE_SIZE) _Atomic uint32_t head;
+
+    /**
+     * @brief Number of commands ever pushed, published or not. Only used by the producer.
+     */
+    uint32_t pending_head;
+
+    /**
+     * @brief The last @c tail seen by the producer, so that it only reads @c tail when the ring looks full.
+     */
+    uint32_t producer_tail;
+
+    /**
+     * @brief Number of commands ever popped. Only written by the consumer.
+     */
+    alignas(HARDWARE_CHANNEL_CACHE_LINE_SIZE) _Atomic uint32_t tail;
+
+    /**
+     * @brief The last @c head seen by the consumer, so that it only reads @c head when the ring looks empty.
+     */
+    uint32_t consumer_head;
+} HardwareCommandRing;
+
+/**
+ * @brief Sets up @p p_seqlock with its first snapshot.
+ *
+ * @param[out] p_seqlock The seqlock.
+ * @param[in] p_snapshot The first snapshot.
+ */
+void hardware_snapshot_seqlock_init(HardwareSnapshotSeqlock* p_seqlock, const HardwareSnapshot* p_snapshot);
+
+/**
+ * @brief Publishes @p p_snapshot. Must only be called from one thread.
+ *
+ * @param[in, out] p_seqlock The seqlock.
+ * @param[in] p_snapshot The snapshot.
+ */
+void hardware_snapshot_seqlock_write(HardwareSnapshotSeqlock* p_seqlock, const HardwareSnapshot* p_snapshot);
+
+/**
+ * @brief Gets the latest snapshot published in @p p_seqlock.
+ *
+ * @param[in] p_seqlock The seqlock.
+ * @param[out] p_snapshot The snapshot.
+ *
+ * @return The number of snapshots written since the first one, which tells a reader if the snapshot is new.
+ */
+uint64_t hardware_snapshot_seqlock_read(HardwareSnapshotSeqlock* p_seqlock, HardwareSnapshot* p_snapshot);
+
+/**
+ * @brief Empties @p p_ring.
+ *
+ * @param[out] p_ring The ring.
+ */
+void hardware_command_ring_init(HardwareCommandRing* p_ring);
+
+/**
+ * @brief Pushes @p p_command to @p p_ring, without publishing it. Producer only.
+ *
+ * @param[in, out] p_ring The ring.
+ * @param[in] p_command The command.
+ *
+ * @return true if the command was pushed, false if the ring is full.
+ */
+bool hardware_command_ring_push(HardwareCommandRing* p_ring, const HardwareCommand* p_command);
+
+/**
+ * @brief Publishes every command pushed to @p p_ring to the consumer. Producer only.
+ *
+ * @param[in, out] p_ring The ring.
+ *
+ * @return true if there were commands to publish.
+ */
+bool hardware_command_ring_publish(HardwareCommandRing* p_ring);
+
+/**
+ * @brief Pops the oldest published command of @p p_ring. Consumer only.
+ *
+ * @param[in, out] p_ring The ring.
+ * @param[out] p_command The command.
+ *
+ * @return true if a command was popped, false if the ring is empty.
+ */
+bool hardware_command_ring_pop(HardwareCommandRing* p_ring, HardwareCommand* p_command);
+
+#endif
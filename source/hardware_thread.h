@@ -0,0 +1,64 @@
+/**
+ * @file
+ * @brief Runs the hardware driver on a dedicated I/O thread, so that the thread stepping the elevator never waits for
+ *        the hardware. The I/O thread owns the driver: it applies the commands of the elevator, reads the inputs and
+ *        publishes them, over and over. The elevator reads the latest inputs through a #HardwareSnapshotSeqlock and
+ *        issues its commands through a #HardwareCommandRing, neither of which takes a lock or makes a system call.
+ *
+ * While the I/O thread runs, the @c hardware_* calls of the driver must not be used from any other thread.
+ */
+
+#ifndef HARDWARE_THREAD_H
+#define HARDWARE_THREAD_H
+
+#include "hardware.h"
+#include "hardware_backend.h"
+
+/**
+ * @brief Reads the inputs once and starts the I/O thread. Must be called after @c hardware_init.
+ *
+ * @param[in] poll_period_us How long the I/O thread waits between two reads of the inputs when there are no commands
+ *                           to apply, in microseconds. 0 to read them back to back, which keeps one core busy.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+int hardware_thread_start(const unsigned int poll_period_us);
+
+/**
+ * @brief Gets a backend passing the commands to the I/O thread. The commands are applied once published by
+ *        #hardware_thread_flush.
+ *
+ * @return The backend.
+ *
+ * @note Must only be used from one thread, the one calling #hardware_thread_flush.
+ */
+HardwareBackend hardware_thread_backend();
+
+/**
+ * @brief Gets the latest inputs read by the I/O thread.
+ *
+ * @param[out] p_snapshot Snapshot to fill.
+ */
+void hardware_thread_read_snapshot(HardwareSnapshot* p_snapshot);
+
+/**
+ * @brief Hands the commands issued through #hardware_thread_backend over to the I/O thread, and wakes it up if it
+ *        is waiting.
+ */
+void hardware_thread_flush();
+
+/**
+ * @brief Gets a file descriptor which becomes readable when the I/O thread publishes inputs which differ from the
+ *        previous ones, e.g. for use with @c epoll. It is never read, so it should be watched edge triggered.
+ *
+ * @return The file descriptor, -1 if the I/O thread is not running.
+ */
+int hardware_thread_event_fd();
+
+/**
+ * @brief Applies the commands left, stops the I/O thread and waits for it to terminate. The driver can be used
+ *        directly again afterwards.
+ */
+void hardware_thread_stop();
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * @file
+ * @brief Implementation of the histograms.
+ */
+
+#include "histogram.h"
+
+#include <math.h>
+#include <string.h>
+
+/**
+ * @brief Gets the bucket of @p value.
+ *
+ * @param[in] value The value.
+ *
+ * @return Index of the bucket.
+ */
+static int histogram_bucket_index(const uint64_t value) {
+    if (value < HISTOGRAM_SUB_BUCKET_COUNT) {
+        return (int)value;
+    }
+
+    // Keep the highest bit and the HISTOGRAM_SUB_BUCKET_BITS bits below it
+    const int shift = 63 - __builtin_clzll(value) - HISTOGRAM_SUB_BUCKET_BITS;
+    return (shift + 1) * HISTOGRAM_SUB_BUCKET_COUNT + (int)((value >> shift) - HISTOGRAM_SUB_BUCKET_COUNT);
+}
+
+/**
+ * @brief Gets the highest value which goes into bucket @p index.
+ *
+ * @param[in] index Index of the bucket.
+ *
+ * @return The value.
+ */
+static uint64_t histogram_bucket_highest_value(const int index) {
+    if (index < HISTOGRAM_SUB_BUCKET_COUNT) {
+        return (uint64_t)index;
+    }
+
+    const int shift = index / HISTOGRAM_SUB_BUCKET_COUNT - 1;
+    const uint64_t sub_bucket = HISTOGRAM_SUB_BUCKET_COUNT + index % HISTOGRAM_SUB_BUCKET_COUNT;
+
+    // Wraps around to UINT64_MAX for the last bucket
+    return ((sub_bucket + 1) << shift) - 1;
+}
+
+void histogram_reset(Histogram* p_histogram) {
+    memset(p_histogram->counts, 0, sizeof(p_histogram->counts));
+    p_histogram->total_count = 0;
+    p_histogram->sum = 0;
+    p_histogram->min = UINT64_MAX;
+    p_histogram->max = 0;
+}
+
+void histogram_record(Histogram* p_histogram, const uint64_t value) {
+    p_histogram->counts[histogram_bucket_index(value)]++;
+    p_histogram->total_count++;
+    p_histogram->sum += value;
+
+    if (value < p_histogram->min) {
+        p_histogram->min = value;
+    }
+    if (value > p_histogram->max) {
+        p_histogram->max = value;
+    }
+}
+
+uint64_t histogram_value_at_percentile(const Histogram* p_histogram, const double percentile) {
+    if (p_histogram->total_count == 0) {
+        return 0;
+    }
+
+    // Nearest rank, the first value recorded is rank 1
+    uint64_t rank = (uint64_t)ceil(percentile / 100.0 * (double)p_histogram->total_count);
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    uint64_t count = 0;
+    for (int index = 0; index < HISTOGRAM_NUMBER_OF_BUCKETS; index++) {
+        count += p_histogram->counts[index];
+        if (count >= rank) {
+            const uint64_t value = histogram_bucket_highest_value(index);
+            return value < p_histogram->max ? value : p_histogram->max;
+        }
+    }
+
+    return p_histogram->max;
+}
+
+double histogram_mean(const Histogram* p_histogram) {
+    return p_histogram->total_count > 0 ? (double)p_histogram->sum / (double)p_histogram->total_count : 0.0;
+}
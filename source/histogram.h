@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @brief Histograms with a fixed relative precision over the whole range of 64 bit values, in the style of HDR
+ *        histograms. Recording a value is a bit scan and an increment, with no allocation, so histograms can be kept
+ *        on the control loop all the time.
+ *
+ * Values below #HISTOGRAM_SUB_BUCKET_COUNT get a bucket each. Above that, every power of two is split into
+ * #HISTOGRAM_SUB_BUCKET_COUNT buckets of equal width, so a value is reported at most 1 / #HISTOGRAM_SUB_BUCKET_COUNT
+ * too high.
+ */
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+
+/**
+ * @brief Number of bits of a value kept below its highest bit.
+ */
+#define HISTOGRAM_SUB_BUCKET_BITS 5
+
+/**
+ * @brief Number of buckets every power of two is split into.
+ */
+#define HISTOGRAM_SUB_BUCKET_COUNT (1 << HISTOGRAM_SUB_BUCKET_BITS)
+
+/**
+ * @brief Number of buckets of a histogram, enough for any 64 bit value.
+ */
+#define HISTOGRAM_NUMBER_OF_BUCKETS ((64 - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKET_COUNT)
+
+/**
+ * @brief A histogram of 64 bit values.
+ */
+typedef struct {
+    /**
+     * @brief Number of values recorded in every bucket.
+     */
+    uint64_t counts[HISTOGRAM_NUMBER_OF_BUCKETS];
+
+    /**
+     * @brief Number of values recorded.
+     */
+    uint64_t total_count;
+
+    /**
+     * @brief Sum of the values recorded, for the mean.
+     */
+    uint64_t sum;
+
+    /**
+     * @brief Lowest value recorded, UINT64_MAX if none.
+     */
+    uint64_t min;
+
+    /**
+     * @brief Highest value recorded, 0 if none.
+     */
+    uint64_t max;
+} Histogram;
+
+/**
+ * @brief Removes every value from @p p_histogram.
+ *
+ * @param[out] p_histogram The histogram.
+ */
+void histogram_reset(Histogram* p_histogram);
+
+/**
+ * @brief Records @p value in @p p_histogram.
+ *
+ * @param[in, out] p_histogram The histogram.
+ * @param[in] value The value.
+ */
+void histogram_record(Histogram* p_histogram, const uint64_t value);
+
+/**
+ * @brief Gets the value at @p percentile of the values recorded in @p p_histogram.
+ *
+ * @param[in] p_histogram The histogram.
+ * @param[in] percentile Percentile from 0 to 100.
+ *
+ * @return The highest value of the bucket holding the percentile, but no more than the highest value recorded. 0 if
+ *         no value has been recorded.
+ */
+uint64_t histogram_value_at_percentile(const Histogram* p_histogram, const double percentile);
+
+/**
+ * @brief Gets the mean of the values recorded in @p p_histogram.
+ *
+ * @param[in] p_histogram The histogram.
+ *
+ * @return The mean, 0 if no value has been recorded.
+ */
+double histogram_mean(const Histogram* p_histogram);
+
+#endif
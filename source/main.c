@@ -9,12 +9,25 @@
  * @file 
  * 
  * @brief Main entry point for the elevator. Unit tests can be executed by passing 
- *        the @c --unit-test flag to the binary.
+ *        the @c --unit-test flag to the binary. Passing @c --tick-ms followed by a period in milliseconds
+ *        makes the controller sleep between iterations instead of spinning, and @c --floors followed by a number of
+ *        floors sets the number of floors of the elevator. Passing @c --metrics prints the latency metrics of the loop
+ *        when the controller terminates, they can also be printed at any time by sending SIGUSR1. Passing
+ *        @c --event-log followed by a path keeps a log of the state transitions, orders, door and motor commands,
+ *        written to the path when the controller terminates or gets SIGUSR2. Passing @c --record followed by a path
+ *        records every input and command of the elevator to the path, for replaying it offline. Passing
+ *        @c --io-thread followed by a period in microseconds runs the driver on a dedicated I/O thread, which reads
+ *        the inputs with that period, so the controller never waits for the hardware. Passing @c --acquisition followed
+ *        by a period in microseconds has the hardware scan the inputs with that period, or report every change of
+ *        state with 0, and wake the controller through its file descriptor instead of only being polled.
  */
+#include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
-#include "fsm.h"
+#include "controller.h"
+#include "hardware.h"
 #include "tests/unit_tests.h"
 
 /**
@@ -26,10 +39,59 @@
  * @return Exit status. 
  */
 int main(const int argc, const char** argv) {
-    if (argc == 2 && strcmp(argv[1], "-unit-test")) {
+    bool should_run_unit_tests = false;
+    int number_of_floors = HARDWARE_DEFAULT_NUMBER_OF_FLOORS;
+    ControllerOptions options = {
+        .scheduler_mode = SCHEDULER_MODE_SPIN,
+        .tick_period_ms = 0,
+        .should_print_metrics = false,
+        .event_log_path = NULL,
+        .recording_path = NULL,
+        .should_use_io_thread = false,
+        .io_poll_period_us = 0,
+        .should_acquire_inputs = false,
+        .acquisition_period_us = 0,
+    };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--unit-test") == 0) {
+            should_run_unit_tests = true;
+        } else if (strcmp(argv[i], "--tick-ms") == 0 && i + 1 < argc) {
+            options.scheduler_mode = SCHEDULER_MODE_EVENT;
+            options.tick_period_ms = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--floors") == 0 && i + 1 < argc) {
+            number_of_floors = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--metrics") == 0) {
+            options.should_print_metrics = true;
+        } else if (strcmp(argv[i], "--event-log") == 0 && i + 1 < argc) {
+            options.event_log_path = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            options.recording_path = argv[++i];
+        } else if (strcmp(argv[i], "--io-thread") == 0 && i + 1 < argc) {
+            options.should_use_io_thread = true;
+            options.io_poll_period_us = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--acquisition") == 0 && i + 1 < argc) {
+            options.should_acquire_inputs = true;
+            options.acquisition_period_us = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr,
+                    "Usage: %s [--unit-test] [--tick-ms <period>] [--floors <floors>] [--metrics]\n"
+                    "          [--event-log <path>] [--record <path>] [--io-thread <period>]\n"
+                    "          [--acquisition <period>]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    if (hardware_set_number_of_floors(number_of_floors) != 0) {
+        fprintf(stderr, "The elevator driver does not support %i floors\n", number_of_floors);
+        return 1;
+    }
+
+    if (should_run_unit_tests) {
         unit_tests_check();
     } else {
-        fsm_run();
+        controller_run(&options);
     }
 
     return 0;
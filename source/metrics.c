@@ -0,0 +1,131 @@
+/**
+ * @file
+ * @brief Implementation of the metrics.
+ */
+
+#include "metrics.h"
+
+#include <time.h>
+
+/**
+ * @brief Names of the hardware calls, indexed by #MetricsHardwareCall.
+ */
+static const char* const m_metrics_hardware_call_names[METRICS_NUMBER_OF_HARDWARE_CALLS] = {
+    [METRICS_HARDWARE_CALL_READ_SNAPSHOT] = "hardware_read_snapshot",
+    [METRICS_HARDWARE_CALL_FLUSH] = "hardware_flush",
+};
+
+/**
+ * @brief Names of the states, indexed by #State.
+ */
+static const char* const m_metrics_state_names[STATE_UNDEFINED + 1] = {
+    [STATE_STARTUP] = "startup",
+    [STATE_IDLE] = "idle",
+    [STATE_MOVE] = "move",
+    [STATE_DOOR_OPEN] = "door open",
+    [STATE_STOP] = "stop",
+    [STATE_UNDEFINED] = "undefined",
+};
+
+/**
+ * @brief Prints one histogram on a line.
+ *
+ * @param[in] p_stream Where to print.
+ * @param[in] name Name of the metric.
+ * @param[in] p_histogram The histogram.
+ * @param[in] scale The recorded values are divided by this before printing.
+ * @param[in] unit Unit of the printed values, after scaling.
+ */
+static void metrics_print_histogram(FILE* p_stream,
+                                    const char* name,
+                                    const Histogram* p_histogram,
+                                    const double scale,
+                                    const char* unit) {
+    if (p_histogram->total_count == 0) {
+        fprintf(p_stream, "Metrics: %s: no samples\n", name);
+        return;
+    }
+
+    fprintf(p_stream,
+            "Metrics: %s [%s]: %llu samples, mean %.3f, p50 %.3f, p90 %.3f, p99 %.3f, p99.9 %.3f, max %.3f\n",
+            name,
+            unit,
+            (unsigned long long)p_histogram->total_count,
+            histogram_mean(p_histogram) / scale,
+            (double)histogram_value_at_percentile(p_histogram, 50.0) / scale,
+            (double)histogram_value_at_percentile(p_histogram, 90.0) / scale,
+            (double)histogram_value_at_percentile(p_histogram, 99.0) / scale,
+            (double)histogram_value_at_percentile(p_histogram, 99.9) / scale,
+            (double)p_histogram->max / scale);
+}
+
+uint64_t metrics_now_ns() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+void metrics_init(Metrics* p_metrics, const Elevator* p_elevator, const uint64_t now_ns) {
+    histogram_reset(&p_metrics->loop_period);
+    histogram_reset(&p_metrics->iteration_time);
+    for (int call = 0; call < METRICS_NUMBER_OF_HARDWARE_CALLS; call++) {
+        histogram_reset(&p_metrics->hardware_call_time[call]);
+    }
+    for (int state = 0; state <= STATE_UNDEFINED; state++) {
+        histogram_reset(&p_metrics->state_dwell_time[state]);
+    }
+    histogram_reset(&p_metrics->queue_length);
+
+    p_metrics->iteration_start_ns = 0;
+    p_metrics->state = p_elevator->current_state;
+    p_metrics->state_entry_ns = now_ns;
+}
+
+void metrics_record_iteration_start(Metrics* p_metrics, const uint64_t now_ns) {
+    if (p_metrics->iteration_start_ns != 0) {
+        histogram_record(&p_metrics->loop_period, now_ns - p_metrics->iteration_start_ns);
+    }
+
+    p_metrics->iteration_start_ns = now_ns;
+}
+
+void metrics_record_hardware_call(Metrics* p_metrics,
+                                  const MetricsHardwareCall call,
+                                  const uint64_t start_ns,
+                                  const uint64_t end_ns) {
+    histogram_record(&p_metrics->hardware_call_time[call], end_ns - start_ns);
+}
+
+void metrics_record_iteration_end(Metrics* p_metrics, const Elevator* p_elevator, const uint64_t now_ns) {
+    histogram_record(&p_metrics->iteration_time, now_ns - p_metrics->iteration_start_ns);
+    histogram_record(&p_metrics->queue_length, (uint64_t)priority_queue_length(p_elevator->p_priority_queue));
+
+    if (p_elevator->current_state != p_metrics->state) {
+        histogram_record(&p_metrics->state_dwell_time[p_metrics->state], now_ns - p_metrics->state_entry_ns);
+        p_metrics->state = p_elevator->current_state;
+        p_metrics->state_entry_ns = now_ns;
+    }
+}
+
+void metrics_print(const Metrics* p_metrics, FILE* p_stream) {
+    metrics_print_histogram(p_stream, "loop period", &p_metrics->loop_period, 1e3, "us");
+    metrics_print_histogram(p_stream, "iteration time", &p_metrics->iteration_time, 1e3, "us");
+
+    for (int call = 0; call < METRICS_NUMBER_OF_HARDWARE_CALLS; call++) {
+        metrics_print_histogram(p_stream,
+                                m_metrics_hardware_call_names[call],
+                                &p_metrics->hardware_call_time[call],
+                                1e3,
+                                "us");
+    }
+
+    for (int state = 0; state <= STATE_UNDEFINED; state++) {
+        char name[32];
+        snprintf(name, sizeof(name), "%s dwell time", m_metrics_state_names[state]);
+        metrics_print_histogram(p_stream, name, &p_metrics->state_dwell_time[state], 1e6, "ms");
+    }
+
+    metrics_print_histogram(p_stream, "queue length", &p_metrics->queue_length, 1.0, "orders");
+    fflush(p_stream);
+}
@@ -0,0 +1,125 @@
+/**
+ * @file
+ * @brief Latency metrics of the control loop: the period of the loop, the time spent in an iteration and in every
+ *        hardware call of it, how long the elevator stays in each state, and the length of its queue. Every metric is
+ *        a #Histogram, so recording costs a few clock reads and increments per iteration and can be left on.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "fsm.h"
+#include "histogram.h"
+
+/**
+ * @brief The hardware calls made by every iteration of the loop.
+ */
+typedef enum {
+    METRICS_HARDWARE_CALL_READ_SNAPSHOT,
+    METRICS_HARDWARE_CALL_FLUSH,
+    METRICS_NUMBER_OF_HARDWARE_CALLS
+} MetricsHardwareCall;
+
+/**
+ * @brief The metrics of the loop of one elevator. Times are in nanoseconds on #metrics_now_ns.
+ */
+typedef struct {
+    /**
+     * @brief Time from the start of an iteration to the start of the next.
+     */
+    Histogram loop_period;
+
+    /**
+     * @brief Time from the start of an iteration until its outputs are flushed, not counting the wait before it.
+     */
+    Histogram iteration_time;
+
+    /**
+     * @brief Time spent in every hardware call, indexed by #MetricsHardwareCall.
+     */
+    Histogram hardware_call_time[METRICS_NUMBER_OF_HARDWARE_CALLS];
+
+    /**
+     * @brief Time spent in a state before leaving it, indexed by #State.
+     */
+    Histogram state_dwell_time[STATE_UNDEFINED + 1];
+
+    /**
+     * @brief Number of orders in the queue after every iteration.
+     */
+    Histogram queue_length;
+
+    /**
+     * @brief Start of the last iteration, 0 before the first.
+     */
+    uint64_t iteration_start_ns;
+
+    /**
+     * @brief The state of the elevator after the last iteration.
+     */
+    State state;
+
+    /**
+     * @brief When the elevator entered @c state.
+     */
+    uint64_t state_entry_ns;
+} Metrics;
+
+/**
+ * @brief Gets the current time for the metrics.
+ *
+ * @return Nanoseconds on the monotonic clock.
+ */
+uint64_t metrics_now_ns();
+
+/**
+ * @brief Clears every metric of @p p_metrics.
+ *
+ * @param[out] p_metrics The metrics.
+ * @param[in] p_elevator The elevator the metrics are kept for, in the state it starts the loop in.
+ * @param[in] now_ns The current time.
+ */
+void metrics_init(Metrics* p_metrics, const Elevator* p_elevator, const uint64_t now_ns);
+
+/**
+ * @brief Records the start of an iteration of the loop.
+ *
+ * @param[in, out] p_metrics The metrics.
+ * @param[in] now_ns The current time.
+ */
+void metrics_record_iteration_start(Metrics* p_metrics, const uint64_t now_ns);
+
+/**
+ * @brief Records the time spent in a hardware call.
+ *
+ * @param[in, out] p_metrics The metrics.
+ * @param[in] call The call.
+ * @param[in] start_ns When the call was made.
+ * @param[in] end_ns When the call returned.
+ */
+void metrics_record_hardware_call(Metrics* p_metrics,
+                                  const MetricsHardwareCall call,
+                                  const uint64_t start_ns,
+                                  const uint64_t end_ns);
+
+/**
+ * @brief Records the end of an iteration of the loop, with the state and the queue of @p p_elevator after it.
+ *
+ * @param[in, out] p_metrics The metrics.
+ * @param[in] p_elevator The elevator.
+ * @param[in] now_ns The current time.
+ */
+void metrics_record_iteration_end(Metrics* p_metrics, const Elevator* p_elevator, const uint64_t now_ns);
+
+/**
+ * @brief Prints the count, mean, percentiles and maximum of every metric recorded so far.
+ *
+ * @param[in] p_metrics The metrics.
+ * @param[in] p_stream Where to print.
+ */
+void metrics_print(const Metrics* p_metrics, FILE* p_stream);
+
+#endif
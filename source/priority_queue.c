@@ -5,6 +5,7 @@
 
 #include "priority_queue.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -32,21 +33,21 @@ static Order* priority_queue_get_last_order(Order* p_priority_queue) {
  * @return The updated priority queue.
  */
 static Order* priority_queue_remove_duplicate_orders(Order* p_priority_queue) {
-    bool order_on_floor[PRIORITY_QUEUE_NUMBER_OF_FLOORS];
-    for (unsigned int floor = 0; floor < sizeof(order_on_floor) / sizeof(order_on_floor[0]); floor++) {
-        order_on_floor[floor] = false;
-    }
+    // One bit per floor, so that clearing it does not grow with the number of floors
+    uint64_t order_on_floor[(PRIORITY_QUEUE_NUMBER_OF_FLOORS + 63) / 64] = {0};
 
     Order* p_iterator = p_priority_queue;
     Order* p_previous_order = NULL;
 
     while (p_iterator) {
-        if (order_on_floor[p_iterator->floor]) {
+        const uint64_t floor_bit = UINT64_C(1) << (p_iterator->floor % 64);
+
+        if (order_on_floor[p_iterator->floor / 64] & floor_bit) {
             p_previous_order->next_order = p_iterator->next_order;
             free(p_iterator);
             p_iterator = p_previous_order->next_order;
         } else {
-            order_on_floor[p_iterator->floor] = true;
+            order_on_floor[p_iterator->floor / 64] |= floor_bit;
             p_previous_order = p_iterator;
             p_iterator = p_iterator->next_order;
         }
@@ -86,24 +87,113 @@ static bool priority_queue_order_is_on_way(const Order* p_new_order, const Order
     return new_order_is_on_the_way;
 }
 
+/**
+ * @brief Forgets the position @p p_order was last reordered for, as the queue has changed since.
+ * 
+ * @param[in, out] p_order The order to update.
+ */
+static void priority_queue_invalidate_reorder_position(Order* p_order) {
+    p_order->reorder_position = (Position){-1, OFFSET_UNDEFINED};
+}
+
+/**
+ * @brief Checks if @p p_priority_queue was last reordered for @p current_position, and has not changed since.
+ * 
+ * @param[in] p_priority_queue The queue to check.
+ * @param[in] current_position The current position of the elevator.
+ * 
+ * @return true if reordering for @p current_position would not change the queue.
+ */
+static bool priority_queue_is_ordered_for_position(const Order* p_priority_queue, const Position current_position) {
+    return p_priority_queue->reorder_position.offset != OFFSET_UNDEFINED &&
+           p_priority_queue->reorder_position.floor == current_position.floor &&
+           p_priority_queue->reorder_position.offset == current_position.offset;
+}
+
+/**
+ * @brief Finds where @p p_order should be placed among the orders from @p p_priority_queue up to and including
+ *        @p p_last_order, which is in front of the first of them it is on the way to.
+ * 
+ * @param[in] p_order The order to place.
+ * @param[in] p_priority_queue The queue.
+ * @param[in] p_last_order The last order to check against.
+ * @param[in] current_position The current position of the elevator.
+ * @param[out] pp_previous_target Set to the order before the found target, NULL if the target is the first order.
+ * 
+ * @return The order @p p_order is on the way to, NULL if it is not on the way to any of them.
+ */
+static Order* priority_queue_find_on_way_target(const Order* p_order,
+                                                Order* p_priority_queue,
+                                                const Order* p_last_order,
+                                                const Position current_position,
+                                                Order** pp_previous_target) {
+    Order* p_target = p_priority_queue;
+    *pp_previous_target = NULL;
+
+    while (true) {
+        if (priority_queue_order_is_on_way(p_order, p_target, current_position)) {
+            return p_target;
+        }
+
+        if (p_target == p_last_order) {
+            return NULL;
+        }
+
+        *pp_previous_target = p_target;
+        p_target = p_target->next_order;
+    }
+}
+
 Order* priority_queue_reorder_based_on_position(Order* p_old_priority_queue, const Position current_position) {
     if (!p_old_priority_queue) {
         return NULL;
     }
 
-    Order* p_updated_priority_queue = priority_queue_order_create(p_old_priority_queue->floor, p_old_priority_queue->direction);
+    if (priority_queue_is_ordered_for_position(p_old_priority_queue, current_position)) {
+        return p_old_priority_queue;
+    }
+
+    // Walk the queue from the second order and check each order against the ones already walked, exactly as if
+    // they were added one by one to a queue with only the top order. Orders which are on the way are moved in
+    // front of their target, all other orders keep their place.
+    Order* p_priority_queue = p_old_priority_queue;
+    Order* p_previous_order = p_old_priority_queue;
     Order* p_iterator = p_old_priority_queue->next_order;
 
+    p_old_priority_queue->is_oldest_order = false;
+    priority_queue_invalidate_reorder_position(p_old_priority_queue);
+
     while (p_iterator) {
-        p_updated_priority_queue = priority_queue_add_order(priority_queue_order_create(p_iterator->floor, p_iterator->direction),
-                                                            p_updated_priority_queue,
-                                                            current_position);
-        p_iterator = p_iterator->next_order;
+        Order* p_next_order = p_iterator->next_order;
+        p_iterator->is_oldest_order = false;
+        priority_queue_invalidate_reorder_position(p_iterator);
+
+        Order* p_previous_target = NULL;
+        Order* p_target = priority_queue_find_on_way_target(p_iterator,
+                                                            p_priority_queue,
+                                                            p_previous_order,
+                                                            current_position,
+                                                            &p_previous_target);
+
+        if (p_target) {
+            p_previous_order->next_order = p_next_order;
+            p_iterator->next_order = p_target;
+
+            if (p_previous_target) {
+                p_previous_target->next_order = p_iterator;
+            } else {
+                p_priority_queue = p_iterator;
+            }
+        } else {
+            p_previous_order = p_iterator;
+        }
+
+        p_iterator = p_next_order;
     }
 
-    priority_queue_clear(p_old_priority_queue);
+    p_priority_queue->reorder_position = current_position;
 
-    return p_updated_priority_queue;
+    return p_priority_queue;
 }
 
 Order* priority_queue_order_create(const int floor, const HardwareOrder direction) {
@@ -113,10 +203,13 @@ Order* priority_queue_order_create(const int floor, const HardwareOrder directio
     p_new_order->direction = direction;
     p_new_order->next_order = NULL;
     p_new_order->is_oldest_order = false;
+    priority_queue_invalidate_reorder_position(p_new_order);
 
     return p_new_order;
 }
 
+void priority_queue_order_destroy(Order* p_order) { free(p_order); }
+
 Order* priority_queue_add_order(Order* p_new_order, Order* p_priority_queue, const Position current_position) {
     if (!p_new_order) {
         return p_priority_queue;
@@ -154,6 +247,10 @@ Order* priority_queue_add_order(Order* p_new_order, Order* p_priority_queue, con
             priority_queue_get_last_order(p_priority_queue)->next_order = p_new_order;
         }
 
+        for (p_iterator = p_priority_queue; p_iterator; p_iterator = p_iterator->next_order) {
+            priority_queue_invalidate_reorder_position(p_iterator);
+        }
+
         return priority_queue_remove_duplicate_orders(p_priority_queue);
     }
 }
@@ -191,6 +288,15 @@ Order* priority_queue_clear(Order* p_priority_queue) {
 
 bool priority_queue_is_empty(const Order* p_priority_queue) { return !p_priority_queue; }
 
+int priority_queue_length(const Order* p_priority_queue) {
+    int length = 0;
+    for (const Order* p_iterator = p_priority_queue; p_iterator; p_iterator = p_iterator->next_order) {
+        length++;
+    }
+
+    return length;
+}
+
 void priority_queue_print(Order* p_priority_queue) {
     Order* p_iterator = p_priority_queue;
     int n = 1;
@@ -1,6 +1,12 @@
 /**
  * @file
  * @brief Module for the priority queue, a linked list based on orders of type #Order.
+ *
+ * @note There are two backends for this header, selected at build time. priority_queue.c keeps the orders in a
+ *       heap allocated linked list, priority_queue_bitset.c keeps them in fixed size floor bitsets per direction. With
+ *       the bitset backend the queue is a single #Order holding the next stop, and its @c next_order is always NULL.
+ *       With both backends an order made with #priority_queue_order_create is a queue holding just that order, and
+ *       is released with @c free or #priority_queue_order_destroy if it never gets added to a queue.
  */
 
 #ifndef PRIORITY_QUEUE_H
@@ -12,9 +18,9 @@
 #include "position.h"
 
 /**
- * @brief Specifies the number of floors we're taking account for in the priority queue.
+ * @brief Specifies the highest number of floors we're taking account for in the priority queue.
  */
-#define PRIORITY_QUEUE_NUMBER_OF_FLOORS HARDWARE_NUMBER_OF_FLOORS
+#define PRIORITY_QUEUE_NUMBER_OF_FLOORS HARDWARE_MAX_NUMBER_OF_FLOORS
 
 /**
  * @brief Structure to represent an order in the queue, a node in a linked list.
@@ -42,6 +48,12 @@ typedef struct Order {
      */
     bool is_oldest_order;
 
+    /**
+     * @brief The position the queue was last reordered for, kept by the top order. Lets a reorder for the same
+     *        position be skipped. Has offset #OFFSET_UNDEFINED when the queue has changed since.
+     */
+    Position reorder_position;
+
 } Order;
 
 /**
@@ -56,6 +68,13 @@ typedef struct Order {
  */
 Order* priority_queue_order_create(const int floor, const HardwareOrder direction);
 
+/**
+ * @brief Releases an order made with #priority_queue_order_create which never got added to a queue.
+ *
+ * @param[in] p_order The order to release.
+ */
+void priority_queue_order_destroy(Order* p_order);
+
 /**
  * @brief Adds an order based on a prioritation algorithm. If the queue contains duplicate orders, the lowest priority is deleted.
  *
@@ -78,12 +97,15 @@ Order* priority_queue_add_order(Order* p_new_order, Order* p_priority_queue, con
 Order* priority_queue_pop(Order* p_priority_queue);
 
 /**
- * @brief Checks if orders on the bottom of the queue are compatible with the top order by adding them into a new queue
- *        and thus running the sorting algorithm from #priority_queue_add_order on them.
+ * @brief Checks if orders on the bottom of the queue are compatible with the orders in front of them, the same way
+ *        #priority_queue_add_order places new orders. The queue is reordered in place, and only the orders which
+ *        are now on the way to an order in front of them are moved.
  * 
  * @param[in] p_old_priority_queue The priority queue to reorder.
  * @param[in] current_position The current position, used to determine how we should reorder.
  * 
+ * @note Does nothing if the queue was already reordered for @p current_position and has not changed since.
+ * 
  * @return The reordered priority queue.
  */
 Order* priority_queue_reorder_based_on_position(Order* p_old_priority_queue, const Position current_position);
@@ -106,6 +128,15 @@ Order* priority_queue_clear(Order* p_priority_queue);
  */
 bool priority_queue_is_empty(const Order* p_priority_queue);
 
+/**
+ * @brief Gets the number of orders in the queue.
+ *
+ * @param[in] p_priority_queue Pointer to the priority queue.
+ *
+ * @return The number of orders.
+ */
+int priority_queue_length(const Order* p_priority_queue);
+
 /**
  * @brief Prints the queue, including the order floors and directions.
  *
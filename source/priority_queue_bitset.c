@@ -0,0 +1,501 @@
+/**
+ * @file
+ * @brief Implementation of the priority queue with floor bitsets.
+ *
+ * Every direction has a bitset with one bit per floor, so adding, removing duplicates and clearing a floor is a
+ * couple of bit operations. The next stop is found by a bit scan between the elevator and the oldest order, which
+ * gives the same stops as the linked list: orders on the way to the oldest order are served first. The orders are
+ * also kept in the order they were added, so the next oldest order is known once the oldest one is served.
+ *
+ * Every order made with #priority_queue_order_create is a queue of its own, which is merged into the queue it is
+ * added to. Queues no longer in use are kept by the thread for the next orders, so once a thread has as many queues
+ * as it needs at the same time, adding and serving orders never allocates.
+ */
+
+#include "priority_queue.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Number of 64 bit words in a floor bitset.
+ */
+#define PRIORITY_QUEUE_BITSET_NUMBER_OF_WORDS ((PRIORITY_QUEUE_NUMBER_OF_FLOORS + 63) / 64)
+
+/**
+ * @brief A set of floors, one bit per floor.
+ */
+typedef struct {
+    uint64_t words[PRIORITY_QUEUE_BITSET_NUMBER_OF_WORDS];
+} FloorSet;
+
+/**
+ * @brief The queue behind an #Order pointer handed out by this backend.
+ */
+typedef struct {
+    /**
+     * @brief The next stop. Must be the first member, as the queue is handed out as a pointer to it.
+     */
+    Order top_order;
+
+    /**
+     * @brief One set of floors per direction, indexed by #HardwareOrder.
+     */
+    FloorSet floors[HARDWARE_NUMBER_OF_BUTTONS];
+
+    /**
+     * @brief Orders in the order they were added, as given by #HARDWARE_ORDER_INDEX, starting at @c fifo_head. An
+     *        order which is served and added again before its entry reaches the head keeps its old place.
+     */
+    uint16_t fifo[PRIORITY_QUEUE_NUMBER_OF_FLOORS * HARDWARE_NUMBER_OF_BUTTONS];
+
+    /**
+     * @brief Index of the first entry in @c fifo.
+     */
+    int fifo_head;
+
+    /**
+     * @brief Number of entries in @c fifo.
+     */
+    int fifo_length;
+
+    /**
+     * @brief The orders with an entry in @c fifo, one set of floors per direction.
+     */
+    FloorSet in_fifo[HARDWARE_NUMBER_OF_BUTTONS];
+
+    /**
+     * @brief The floor of the oldest order, which the queue is working its way towards.
+     */
+    int oldest_floor;
+
+    /**
+     * @brief The direction of the oldest order.
+     */
+    HardwareOrder oldest_direction;
+
+    /**
+     * @brief The last position of the elevator given to the queue.
+     */
+    Position position;
+} PriorityQueueBitset;
+
+/**
+ * @brief Queues given back on this thread, linked through the @c next_order of their top order. Thread local so that
+ *        queues can be used from several threads without locking.
+ */
+static _Thread_local Order* m_priority_queue_bitset_free_queues = NULL;
+
+/**
+ * @brief Gets the bitset queue behind @p p_priority_queue.
+ *
+ * @param[in] p_priority_queue The queue.
+ *
+ * @return The bitset queue.
+ */
+static PriorityQueueBitset* priority_queue_bitset_get(Order* p_priority_queue) {
+    return (PriorityQueueBitset*)p_priority_queue;
+}
+
+/**
+ * @brief Takes an empty queue, one given back on this thread if there is any, else a new one from the heap.
+ *
+ * @return The queue.
+ */
+static PriorityQueueBitset* priority_queue_bitset_take(void) {
+    PriorityQueueBitset* p_queue = priority_queue_bitset_get(m_priority_queue_bitset_free_queues);
+
+    if (p_queue) {
+        m_priority_queue_bitset_free_queues = p_queue->top_order.next_order;
+    } else {
+        p_queue = malloc(sizeof(*p_queue));
+        assert(p_queue && "Out of memory for the orders");
+    }
+
+    memset(p_queue, 0, sizeof(*p_queue));
+
+    return p_queue;
+}
+
+/**
+ * @brief Gives a queue back to be taken again by #priority_queue_bitset_take.
+ *
+ * @param[in] p_queue The queue, NULL is ignored.
+ */
+static void priority_queue_bitset_give_back(PriorityQueueBitset* p_queue) {
+    if (p_queue) {
+        p_queue->top_order.next_order = m_priority_queue_bitset_free_queues;
+        m_priority_queue_bitset_free_queues = &p_queue->top_order;
+    }
+}
+
+/**
+ * @brief Checks if @p floor is in @p p_set.
+ *
+ * @param[in] p_set The set.
+ * @param[in] floor The floor.
+ *
+ * @return true if the floor is in the set.
+ */
+static bool priority_queue_bitset_contains(const FloorSet* p_set, const int floor) {
+    return (p_set->words[floor / 64] >> (floor % 64)) & 1;
+}
+
+/**
+ * @brief Gets the union of two sets of floors.
+ *
+ * @param[in] p_first The first set.
+ * @param[in] p_second The second set.
+ *
+ * @return The floors in either set.
+ */
+static FloorSet priority_queue_bitset_union(const FloorSet* p_first, const FloorSet* p_second) {
+    FloorSet set;
+    for (int word = 0; word < PRIORITY_QUEUE_BITSET_NUMBER_OF_WORDS; word++) {
+        set.words[word] = p_first->words[word] | p_second->words[word];
+    }
+
+    return set;
+}
+
+/**
+ * @brief Gets the floors with an order of any direction.
+ *
+ * @param[in] p_queue The queue.
+ *
+ * @return Set of floors.
+ */
+static FloorSet priority_queue_bitset_all_floors(const PriorityQueueBitset* p_queue) {
+    const FloorSet set = priority_queue_bitset_union(&p_queue->floors[HARDWARE_ORDER_UP],
+                                                     &p_queue->floors[HARDWARE_ORDER_INSIDE]);
+    return priority_queue_bitset_union(&set, &p_queue->floors[HARDWARE_ORDER_DOWN]);
+}
+
+/**
+ * @brief Gets the bits of @p word of a floor bitset for the floors from @p lowest_floor to @p highest_floor, both
+ *        included.
+ *
+ * @param[in] word The word.
+ * @param[in] lowest_floor The lowest floor in the range.
+ * @param[in] highest_floor The highest floor in the range.
+ *
+ * @return The bits, none if the range does not cover the word.
+ */
+static uint64_t priority_queue_bitset_range(const int word, const int lowest_floor, const int highest_floor) {
+    const int low = lowest_floor > word * 64 ? lowest_floor - word * 64 : 0;
+    const int high = highest_floor < word * 64 + 63 ? highest_floor - word * 64 : 63;
+
+    if (low > high) {
+        return 0;
+    }
+
+    const uint64_t up_to_high = high == 63 ? UINT64_MAX : (UINT64_C(1) << (high + 1)) - 1;
+
+    return up_to_high & ~((UINT64_C(1) << low) - 1);
+}
+
+/**
+ * @brief Finds the lowest floor of @p p_set from @p lowest_floor to @p highest_floor, both included.
+ *
+ * @param[in] p_set The set.
+ * @param[in] lowest_floor The lowest floor in the range.
+ * @param[in] highest_floor The highest floor in the range.
+ *
+ * @return The floor, -1 if there is none in the range.
+ */
+static int priority_queue_bitset_lowest(const FloorSet* p_set, int lowest_floor, int highest_floor) {
+    lowest_floor = lowest_floor < 0 ? 0 : lowest_floor;
+    if (highest_floor >= PRIORITY_QUEUE_NUMBER_OF_FLOORS) {
+        highest_floor = PRIORITY_QUEUE_NUMBER_OF_FLOORS - 1;
+    }
+
+    for (int word = lowest_floor / 64; lowest_floor <= highest_floor && word <= highest_floor / 64; word++) {
+        const uint64_t bits = p_set->words[word] & priority_queue_bitset_range(word, lowest_floor, highest_floor);
+        if (bits) {
+            return word * 64 + __builtin_ctzll(bits);
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Finds the highest floor of @p p_set from @p lowest_floor to @p highest_floor, both included.
+ *
+ * @param[in] p_set The set.
+ * @param[in] lowest_floor The lowest floor in the range.
+ * @param[in] highest_floor The highest floor in the range.
+ *
+ * @return The floor, -1 if there is none in the range.
+ */
+static int priority_queue_bitset_highest(const FloorSet* p_set, int lowest_floor, int highest_floor) {
+    lowest_floor = lowest_floor < 0 ? 0 : lowest_floor;
+    if (highest_floor >= PRIORITY_QUEUE_NUMBER_OF_FLOORS) {
+        highest_floor = PRIORITY_QUEUE_NUMBER_OF_FLOORS - 1;
+    }
+
+    for (int word = highest_floor / 64; lowest_floor <= highest_floor && word >= lowest_floor / 64; word--) {
+        const uint64_t bits = p_set->words[word] & priority_queue_bitset_range(word, lowest_floor, highest_floor);
+        if (bits) {
+            return word * 64 + 63 - __builtin_clzll(bits);
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Picks the direction to report for an order at @p floor, preferring inside orders and then the direction
+ *        the elevator is travelling in.
+ *
+ * @param[in] p_queue The queue.
+ * @param[in] floor The floor of the order.
+ * @param[in] travel_direction The direction the elevator is travelling in.
+ *
+ * @return The direction of the order.
+ */
+static HardwareOrder priority_queue_bitset_direction_at_floor(const PriorityQueueBitset* p_queue,
+                                                              const int floor,
+                                                              const HardwareOrder travel_direction) {
+    if (priority_queue_bitset_contains(&p_queue->floors[HARDWARE_ORDER_INSIDE], floor)) {
+        return HARDWARE_ORDER_INSIDE;
+    } else if (priority_queue_bitset_contains(&p_queue->floors[travel_direction], floor)) {
+        return travel_direction;
+    }
+
+    return travel_direction == HARDWARE_ORDER_UP ? HARDWARE_ORDER_DOWN : HARDWARE_ORDER_UP;
+}
+
+/**
+ * @brief Updates the top order of @p p_queue to the next stop: the first order on the way to the oldest order, or
+ *        the oldest order itself.
+ *
+ * @param[in, out] p_queue The queue to update.
+ */
+static void priority_queue_bitset_update_top_order(PriorityQueueBitset* p_queue) {
+    const Position position = p_queue->position;
+    const int target_floor = p_queue->oldest_floor;
+
+    int next_floor = target_floor;
+    HardwareOrder next_direction = p_queue->oldest_direction;
+
+    if (position.floor >= 0 && target_floor > position.floor) {
+        // Going up, orders between us and the target which are not going down
+        const int lowest_floor = position.offset == OFFSET_ABOVE ? position.floor + 1 : position.floor;
+        const FloorSet candidates = priority_queue_bitset_union(&p_queue->floors[HARDWARE_ORDER_UP],
+                                                                &p_queue->floors[HARDWARE_ORDER_INSIDE]);
+        const int floor = priority_queue_bitset_lowest(&candidates, lowest_floor, target_floor - 1);
+
+        if (floor >= 0) {
+            next_floor = floor;
+            next_direction = priority_queue_bitset_direction_at_floor(p_queue, next_floor, HARDWARE_ORDER_UP);
+        }
+    } else if (position.floor >= 0 && target_floor < position.floor) {
+        // Going down, orders between us and the target which are not going up
+        const int highest_floor = position.offset == OFFSET_BELOW ? position.floor - 1 : position.floor;
+        const FloorSet candidates = priority_queue_bitset_union(&p_queue->floors[HARDWARE_ORDER_DOWN],
+                                                                &p_queue->floors[HARDWARE_ORDER_INSIDE]);
+        const int floor = priority_queue_bitset_highest(&candidates, target_floor + 1, highest_floor);
+
+        if (floor >= 0) {
+            next_floor = floor;
+            next_direction = priority_queue_bitset_direction_at_floor(p_queue, next_floor, HARDWARE_ORDER_DOWN);
+        }
+    }
+
+    p_queue->top_order.next_order = NULL;
+    p_queue->top_order.floor = next_floor;
+    p_queue->top_order.direction = next_direction;
+    p_queue->top_order.is_oldest_order = next_floor == target_floor;
+}
+
+/**
+ * @brief Adds @p floor to @p p_set.
+ *
+ * @param[in, out] p_set The set.
+ * @param[in] floor The floor.
+ */
+static void priority_queue_bitset_add(FloorSet* p_set, const int floor) {
+    p_set->words[floor / 64] |= UINT64_C(1) << (floor % 64);
+}
+
+/**
+ * @brief Removes @p floor from @p p_set.
+ *
+ * @param[in, out] p_set The set.
+ * @param[in] floor The floor.
+ */
+static void priority_queue_bitset_remove(FloorSet* p_set, const int floor) {
+    p_set->words[floor / 64] &= ~(UINT64_C(1) << (floor % 64));
+}
+
+/**
+ * @brief Picks a new oldest order after the old one got served, the first order in the FIFO which is still in the
+ *        queue.
+ *
+ * @param[in, out] p_queue The queue, must have at least one order left.
+ */
+static void priority_queue_bitset_pick_oldest_order(PriorityQueueBitset* p_queue) {
+    const int fifo_size = sizeof(p_queue->fifo) / sizeof(p_queue->fifo[0]);
+
+    while (p_queue->fifo_length > 0) {
+        const int floor = p_queue->fifo[p_queue->fifo_head] / HARDWARE_NUMBER_OF_BUTTONS;
+        const HardwareOrder direction = (HardwareOrder)(p_queue->fifo[p_queue->fifo_head] % HARDWARE_NUMBER_OF_BUTTONS);
+
+        if (priority_queue_bitset_contains(&p_queue->floors[direction], floor)) {
+            p_queue->oldest_floor = floor;
+            p_queue->oldest_direction = direction;
+            return;
+        }
+
+        priority_queue_bitset_remove(&p_queue->in_fifo[direction], floor);
+        p_queue->fifo_head = (p_queue->fifo_head + 1) % fifo_size;
+        p_queue->fifo_length--;
+    }
+}
+
+Order* priority_queue_reorder_based_on_position(Order* p_old_priority_queue, const Position current_position) {
+    if (!p_old_priority_queue) {
+        return NULL;
+    }
+
+    PriorityQueueBitset* p_queue = priority_queue_bitset_get(p_old_priority_queue);
+
+    // The top order is kept up to date on every change, so only a new position can change it
+    if (p_queue->position.floor == current_position.floor && p_queue->position.offset == current_position.offset) {
+        return p_old_priority_queue;
+    }
+
+    p_queue->position = current_position;
+    priority_queue_bitset_update_top_order(p_queue);
+
+    return p_old_priority_queue;
+}
+
+Order* priority_queue_order_create(const int floor, const HardwareOrder direction) {
+    PriorityQueueBitset* p_queue = priority_queue_bitset_take();
+
+    p_queue->fifo[0] = HARDWARE_ORDER_INDEX(floor, direction);
+    p_queue->fifo_length = 1;
+    priority_queue_bitset_add(&p_queue->in_fifo[direction], floor);
+    priority_queue_bitset_add(&p_queue->floors[direction], floor);
+
+    p_queue->oldest_floor = floor;
+    p_queue->oldest_direction = direction;
+    p_queue->position = (Position){-1, OFFSET_UNDEFINED};
+    priority_queue_bitset_update_top_order(p_queue);
+
+    return &p_queue->top_order;
+}
+
+void priority_queue_order_destroy(Order* p_order) {
+    priority_queue_bitset_give_back(priority_queue_bitset_get(p_order));
+}
+
+Order* priority_queue_add_order(Order* p_new_order, Order* p_priority_queue, const Position current_position) {
+    if (!p_new_order) {
+        return p_priority_queue;
+    }
+
+    // The new order is a queue of its own, which becomes the queue or is merged into it
+    PriorityQueueBitset* p_queue = priority_queue_bitset_get(p_new_order);
+    if (!priority_queue_is_empty(p_priority_queue)) {
+        p_queue = priority_queue_bitset_get(p_priority_queue);
+
+        const int floor = p_new_order->floor;
+        const HardwareOrder direction = p_new_order->direction;
+        priority_queue_order_destroy(p_new_order);
+
+        if (!priority_queue_bitset_contains(&p_queue->in_fifo[direction], floor)) {
+            const int fifo_size = sizeof(p_queue->fifo) / sizeof(p_queue->fifo[0]);
+
+            p_queue->fifo[(p_queue->fifo_head + p_queue->fifo_length) % fifo_size] =
+                HARDWARE_ORDER_INDEX(floor, direction);
+            p_queue->fifo_length++;
+            priority_queue_bitset_add(&p_queue->in_fifo[direction], floor);
+        }
+
+        priority_queue_bitset_add(&p_queue->floors[direction], floor);
+    }
+
+    p_queue->position = current_position;
+    priority_queue_bitset_update_top_order(p_queue);
+
+    return &p_queue->top_order;
+}
+
+Order* priority_queue_pop(Order* p_priority_queue) {
+    if (!p_priority_queue) {
+        return NULL;
+    }
+
+    PriorityQueueBitset* p_queue = priority_queue_bitset_get(p_priority_queue);
+    const int served_floor = p_queue->top_order.floor;
+    for (unsigned int direction = 0; direction < HARDWARE_NUMBER_OF_BUTTONS; direction++) {
+        priority_queue_bitset_remove(&p_queue->floors[direction], served_floor);
+    }
+
+    const FloorSet floors = priority_queue_bitset_all_floors(p_queue);
+    if (priority_queue_bitset_lowest(&floors, 0, PRIORITY_QUEUE_NUMBER_OF_FLOORS - 1) < 0) {
+        priority_queue_bitset_give_back(p_queue);
+        return NULL;
+    }
+
+    if (served_floor == p_queue->oldest_floor) {
+        priority_queue_bitset_pick_oldest_order(p_queue);
+    }
+
+    priority_queue_bitset_update_top_order(p_queue);
+
+    return p_priority_queue;
+}
+
+Order* priority_queue_clear(Order* p_priority_queue) {
+    priority_queue_bitset_give_back(priority_queue_bitset_get(p_priority_queue));
+
+    return NULL;
+}
+
+bool priority_queue_is_empty(const Order* p_priority_queue) { return !p_priority_queue; }
+
+int priority_queue_length(const Order* p_priority_queue) {
+    if (!p_priority_queue) {
+        return 0;
+    }
+
+    const PriorityQueueBitset* p_queue = (const PriorityQueueBitset*)p_priority_queue;
+
+    int length = 0;
+    for (HardwareOrder order_type = HARDWARE_ORDER_UP; order_type <= HARDWARE_ORDER_DOWN; order_type++) {
+        for (int word = 0; word < PRIORITY_QUEUE_BITSET_NUMBER_OF_WORDS; word++) {
+            length += __builtin_popcountll(p_queue->floors[order_type].words[word]);
+        }
+    }
+
+    return length;
+}
+
+void priority_queue_print(Order* p_priority_queue) {
+    if (p_priority_queue) {
+        const PriorityQueueBitset* p_queue = priority_queue_bitset_get(p_priority_queue);
+
+        printf("Next stop: floor %i, direction %i\n", p_queue->top_order.floor, (int)p_queue->top_order.direction);
+        printf("Oldest order: floor %i, direction %i\n", p_queue->oldest_floor, (int)p_queue->oldest_direction);
+
+        const FloorSet floors = priority_queue_bitset_all_floors(p_queue);
+
+        for (int floor = priority_queue_bitset_lowest(&floors, 0, PRIORITY_QUEUE_NUMBER_OF_FLOORS - 1); floor >= 0;
+             floor = priority_queue_bitset_lowest(&floors, floor + 1, PRIORITY_QUEUE_NUMBER_OF_FLOORS - 1)) {
+            printf("\t Floor: %i", floor);
+            printf("\t Up: %i", priority_queue_bitset_contains(&p_queue->floors[HARDWARE_ORDER_UP], floor));
+            printf("\t Inside: %i", priority_queue_bitset_contains(&p_queue->floors[HARDWARE_ORDER_INSIDE], floor));
+            printf("\t Down: %i", priority_queue_bitset_contains(&p_queue->floors[HARDWARE_ORDER_DOWN], floor));
+            printf("\n");
+        }
+    }
+    printf("End of queue\n");
+    return;
+}
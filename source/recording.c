@@ -0,0 +1,376 @@
+/**
+ * @file
+ * @brief Implementation of the recordings.
+ */
+
+#include "recording.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+_Static_assert(sizeof(RecordingCommand) == 8, "Commands are written to files as they are");
+
+/**
+ * @brief Tags of the records of a recording.
+ */
+#define RECORDING_TAG_INPUTS 'I'
+#define RECORDING_TAG_STEP 'S'
+#define RECORDING_TAG_COMMAND 'C'
+#define RECORDING_TAG_DEINIT 'D'
+
+/**
+ * @brief Writes a record to the recording of @p p_writer.
+ *
+ * @param[in, out] p_writer The writer.
+ * @param[in] tag Tag of the record.
+ * @param[in] p_payload Payload of the record.
+ * @param[in] payload_size Size of the payload in bytes.
+ */
+static void recording_writer_write(RecordingWriter* p_writer,
+                                   const char tag,
+                                   const void* p_payload,
+                                   const size_t payload_size) {
+    fputc(tag, p_writer->p_file);
+    if (payload_size > 0) {
+        fwrite(p_payload, payload_size, 1, p_writer->p_file);
+    }
+}
+
+/**
+ * @brief Writes a command to the recording of @p p_writer.
+ *
+ * @param[in, out] p_writer The writer.
+ * @param[in] type The command.
+ * @param[in] floor The floor of the command, 0 if it has none.
+ * @param[in] order_type The order type of the command, 0 if it has none.
+ * @param[in] value The value of the command.
+ */
+static void recording_writer_write_command(RecordingWriter* p_writer,
+                                           const RecordingCommandType type,
+                                           const int floor,
+                                           const int order_type,
+                                           const int value) {
+    const RecordingCommand command = {
+        .type = (uint8_t)type,
+        .order_type = (uint8_t)order_type,
+        .value = (uint8_t)value,
+        .floor = floor,
+    };
+    recording_writer_write(p_writer, RECORDING_TAG_COMMAND, &command, sizeof(command));
+}
+
+static void recording_writer_command_movement(void* p_context, const HardwareMovement movement) {
+    RecordingWriter* p_writer = p_context;
+    recording_writer_write_command(p_writer, RECORDING_COMMAND_MOVEMENT, 0, 0, movement);
+    p_writer->hardware.p_operations->command_movement(p_writer->hardware.p_context, movement);
+}
+
+static void recording_writer_command_order_light(void* p_context,
+                                                 const int floor,
+                                                 const HardwareOrder order_type,
+                                                 const bool on) {
+    RecordingWriter* p_writer = p_context;
+    recording_writer_write_command(p_writer, RECORDING_COMMAND_ORDER_LIGHT, floor, order_type, on);
+    p_writer->hardware.p_operations->command_order_light(p_writer->hardware.p_context, floor, order_type, on);
+}
+
+static void recording_writer_command_floor_indicator_on(void* p_context, const int floor) {
+    RecordingWriter* p_writer = p_context;
+    recording_writer_write_command(p_writer, RECORDING_COMMAND_FLOOR_INDICATOR_ON, floor, 0, 0);
+    p_writer->hardware.p_operations->command_floor_indicator_on(p_writer->hardware.p_context, floor);
+}
+
+static void recording_writer_command_door_open(void* p_context, const bool door_open) {
+    RecordingWriter* p_writer = p_context;
+    recording_writer_write_command(p_writer, RECORDING_COMMAND_DOOR_OPEN, 0, 0, door_open);
+    p_writer->hardware.p_operations->command_door_open(p_writer->hardware.p_context, door_open);
+}
+
+static void recording_writer_command_stop_light(void* p_context, const bool on) {
+    RecordingWriter* p_writer = p_context;
+    recording_writer_write_command(p_writer, RECORDING_COMMAND_STOP_LIGHT, 0, 0, on);
+    p_writer->hardware.p_operations->command_stop_light(p_writer->hardware.p_context, on);
+}
+
+static void recording_writer_command_order_lights(void* p_context, const uint64_t* p_lights, const uint64_t* p_mask) {
+    RecordingWriter* p_writer = p_context;
+
+    // Recorded light by light, in the order hardware_backend_command_order_lights sets them on a backend without
+    // bulk writes, so that a replay compares them one by one
+    for (int floor = 0; floor < p_writer->hardware.number_of_floors; floor++) {
+        for (HardwareOrder order_type = HARDWARE_ORDER_UP; order_type <= HARDWARE_ORDER_DOWN; order_type++) {
+            const int word = HARDWARE_ORDER_WORD(floor, order_type);
+            const uint64_t bit = HARDWARE_ORDER_BIT(floor, order_type);
+
+            if (!p_mask || (p_mask[word] & bit)) {
+                recording_writer_write_command(p_writer,
+                                               RECORDING_COMMAND_ORDER_LIGHT,
+                                               floor,
+                                               order_type,
+                                               (p_lights[word] & bit) != 0);
+            }
+        }
+    }
+
+    hardware_backend_command_order_lights(&p_writer->hardware, p_lights, p_mask);
+}
+
+/**
+ * @brief The commands of the backend of a writer.
+ */
+static const HardwareBackendOperations m_recording_writer_operations = {
+    .command_movement = recording_writer_command_movement,
+    .command_order_light = recording_writer_command_order_light,
+    .command_floor_indicator_on = recording_writer_command_floor_indicator_on,
+    .command_door_open = recording_writer_command_door_open,
+    .command_stop_light = recording_writer_command_stop_light,
+    .command_order_lights = recording_writer_command_order_lights,
+};
+
+int recording_writer_open(RecordingWriter* p_writer, const char* path, const HardwareBackend* p_hardware) {
+    p_writer->p_file = fopen(path, "wb");
+    if (!p_writer->p_file) {
+        return 1;
+    }
+
+    p_writer->hardware = *p_hardware;
+    p_writer->has_inputs = false;
+
+    const uint32_t header[2] = {(uint32_t)p_hardware->number_of_floors, sizeof(HardwareSnapshot)};
+    fwrite(RECORDING_FILE_MAGIC, strlen(RECORDING_FILE_MAGIC), 1, p_writer->p_file);
+    fwrite(header, sizeof(header), 1, p_writer->p_file);
+
+    return 0;
+}
+
+HardwareBackend recording_writer_backend(RecordingWriter* p_writer) {
+    return (HardwareBackend){
+        .p_operations = &m_recording_writer_operations,
+        .p_context = p_writer,
+        .number_of_floors = p_writer->hardware.number_of_floors,
+    };
+}
+
+void recording_writer_step(RecordingWriter* p_writer, const HardwareSnapshot* p_inputs, const uint64_t now_ms) {
+    if (!p_writer->has_inputs || memcmp(&p_writer->last_inputs, p_inputs, sizeof(HardwareSnapshot)) != 0) {
+        recording_writer_write(p_writer, RECORDING_TAG_INPUTS, p_inputs, sizeof(HardwareSnapshot));
+        p_writer->last_inputs = *p_inputs;
+        p_writer->has_inputs = true;
+    }
+
+    recording_writer_write(p_writer, RECORDING_TAG_STEP, &now_ms, sizeof(now_ms));
+}
+
+void recording_writer_deinit(RecordingWriter* p_writer) {
+    recording_writer_write(p_writer, RECORDING_TAG_DEINIT, NULL, 0);
+}
+
+int recording_writer_close(RecordingWriter* p_writer) {
+    const int error = ferror(p_writer->p_file);
+
+    return fclose(p_writer->p_file) != 0 || error;
+}
+
+/**
+ * @brief Reads the whole file at @p path.
+ *
+ * @param[in] path Path of the file.
+ * @param[out] p_size Size of the file.
+ *
+ * @return The contents, to be freed, NULL if the file could not be read.
+ */
+static unsigned char* recording_read_file(const char* path, size_t* p_size) {
+    FILE* p_file = fopen(path, "rb");
+    if (!p_file) {
+        return NULL;
+    }
+
+    size_t capacity = 1 << 16;
+    size_t size = 0;
+    unsigned char* p_data = malloc(capacity);
+
+    size_t length;
+    while ((length = fread(p_data + size, 1, capacity - size, p_file)) > 0) {
+        size += length;
+        if (size == capacity) {
+            capacity *= 2;
+            p_data = realloc(p_data, capacity);
+        }
+    }
+
+    const bool failed = ferror(p_file);
+    fclose(p_file);
+
+    if (failed) {
+        free(p_data);
+        return NULL;
+    }
+
+    *p_size = size;
+    return p_data;
+}
+
+int recording_load(const char* path, Recording* p_recording) {
+    size_t size = 0;
+    unsigned char* p_data = recording_read_file(path, &size);
+    if (!p_data) {
+        fprintf(stderr, "Unable to read recording %s\n", path);
+        return 1;
+    }
+
+    const size_t magic_size = strlen(RECORDING_FILE_MAGIC);
+    uint32_t header[2];
+    if (size < magic_size + sizeof(header) || memcmp(p_data, RECORDING_FILE_MAGIC, magic_size) != 0) {
+        fprintf(stderr, "%s is not a recording\n", path);
+        free(p_data);
+        return 1;
+    }
+
+    memcpy(header, p_data + magic_size, sizeof(header));
+    if (header[0] < 2 || header[0] > HARDWARE_MAX_NUMBER_OF_FLOORS || header[1] != sizeof(HardwareSnapshot)) {
+        fprintf(stderr, "%s was recorded by an incompatible build\n", path);
+        free(p_data);
+        return 1;
+    }
+
+    p_recording->number_of_floors = (int)header[0];
+    p_recording->has_deinit = false;
+
+    size_t step_capacity = 1024;
+    size_t command_capacity = 1024;
+    p_recording->p_steps = malloc(step_capacity * sizeof(RecordingStep));
+    p_recording->p_commands = malloc(command_capacity * sizeof(RecordingCommand));
+    p_recording->number_of_steps = 0;
+    p_recording->number_of_commands = 0;
+
+    HardwareSnapshot inputs;
+    memset(&inputs, 0, sizeof(inputs));
+
+    // A record cut short at the end of the file, e.g. by a crash, ends the recording
+    size_t offset = magic_size + sizeof(header);
+    while (offset < size) {
+        const unsigned char tag = p_data[offset];
+
+        size_t payload_size = 0;
+        bool is_valid = true;
+        switch (tag) {
+            case RECORDING_TAG_INPUTS: {
+                payload_size = sizeof(HardwareSnapshot);
+            } break;
+
+            case RECORDING_TAG_STEP: {
+                payload_size = sizeof(uint64_t);
+                is_valid = !p_recording->has_deinit;
+            } break;
+
+            case RECORDING_TAG_COMMAND: {
+                payload_size = sizeof(RecordingCommand);
+            } break;
+
+            case RECORDING_TAG_DEINIT: {
+                is_valid = !p_recording->has_deinit;
+            } break;
+
+            default: {
+                is_valid = false;
+            } break;
+        }
+
+        if (!is_valid) {
+            fprintf(stderr, "%s: invalid record at byte %zu\n", path, offset);
+            free(p_data);
+            recording_free(p_recording);
+            return 1;
+        }
+
+        if (size - offset - 1 < payload_size) {
+            break;
+        }
+
+        const unsigned char* p_payload = p_data + offset + 1;
+        offset += 1 + payload_size;
+
+        if (tag == RECORDING_TAG_INPUTS) {
+            memcpy(&inputs, p_payload, sizeof(HardwareSnapshot));
+        } else if (tag == RECORDING_TAG_STEP) {
+            if (p_recording->number_of_steps == step_capacity) {
+                step_capacity *= 2;
+                p_recording->p_steps = realloc(p_recording->p_steps, step_capacity * sizeof(RecordingStep));
+            }
+
+            RecordingStep* p_step = &p_recording->p_steps[p_recording->number_of_steps++];
+            memcpy(&p_step->now_ms, p_payload, sizeof(uint64_t));
+            p_step->inputs = inputs;
+            p_step->first_command = p_recording->number_of_commands;
+        } else if (tag == RECORDING_TAG_COMMAND) {
+            if (p_recording->number_of_commands == command_capacity) {
+                command_capacity *= 2;
+                p_recording->p_commands = realloc(p_recording->p_commands, command_capacity * sizeof(RecordingCommand));
+            }
+
+            memcpy(&p_recording->p_commands[p_recording->number_of_commands++], p_payload, sizeof(RecordingCommand));
+        } else {
+            p_recording->has_deinit = true;
+            p_recording->first_deinit_command = p_recording->number_of_commands;
+        }
+    }
+
+    // The commands of the last step of a recording cut short may be cut short too, so it is left out
+    if (!p_recording->has_deinit && p_recording->number_of_steps > 0) {
+        p_recording->number_of_steps--;
+        p_recording->number_of_commands = p_recording->p_steps[p_recording->number_of_steps].first_command;
+    }
+
+    if (!p_recording->has_deinit) {
+        p_recording->first_deinit_command = p_recording->number_of_commands;
+    }
+
+    free(p_data);
+    return 0;
+}
+
+void recording_free(Recording* p_recording) {
+    free(p_recording->p_steps);
+    free(p_recording->p_commands);
+    p_recording->p_steps = NULL;
+    p_recording->p_commands = NULL;
+    p_recording->number_of_steps = 0;
+    p_recording->number_of_commands = 0;
+}
+
+void recording_print_command(const RecordingCommand* p_command, FILE* p_stream) {
+    static const char* movement_names[] = {"up", "stop", "down"};
+    static const char* order_type_names[] = {"up", "inside", "down"};
+
+    switch (p_command->type) {
+        case RECORDING_COMMAND_MOVEMENT: {
+            fprintf(p_stream,
+                    "movement %s",
+                    p_command->value <= HARDWARE_MOVEMENT_DOWN ? movement_names[p_command->value] : "?");
+        } break;
+
+        case RECORDING_COMMAND_ORDER_LIGHT: {
+            fprintf(p_stream,
+                    "order light %i %s %s",
+                    (int)p_command->floor,
+                    p_command->order_type <= HARDWARE_ORDER_DOWN ? order_type_names[p_command->order_type] : "?",
+                    p_command->value ? "on" : "off");
+        } break;
+
+        case RECORDING_COMMAND_FLOOR_INDICATOR_ON: {
+            fprintf(p_stream, "floor indicator %i", (int)p_command->floor);
+        } break;
+
+        case RECORDING_COMMAND_DOOR_OPEN: {
+            fprintf(p_stream, "door %s", p_command->value ? "open" : "closed");
+        } break;
+
+        case RECORDING_COMMAND_STOP_LIGHT: {
+            fprintf(p_stream, "stop light %s", p_command->value ? "on" : "off");
+        } break;
+
+        default: {
+            fprintf(p_stream, "unknown command %i", (int)p_command->type);
+        } break;
+    }
+}
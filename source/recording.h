@@ -0,0 +1,210 @@
+/**
+ * @file
+ * @brief Recordings of the inputs and the commands of an elevator, for replaying its FSM offline. The FSM only
+ *        depends on the inputs and the time it is stepped with, so stepping a fresh elevator with the recorded inputs
+ *        and times must give the recorded commands again.
+ *
+ * A recording is a binary file, in the byte order of the machine, starting with #RECORDING_FILE_MAGIC, the number of
+ * floors and the size of a #HardwareSnapshot as two 32 bit integers. Then follow records, each a tag byte and its
+ * payload:
+ *
+ * - @c I and a #HardwareSnapshot: the inputs of the following steps, written when they change.
+ * - @c S and the 64 bit time in milliseconds: one #fsm_step, with the last inputs.
+ * - @c C and a #RecordingCommand: a command issued during the last step. Order lights set at once are recorded one
+ *   by one.
+ * - @c D: the steps are over, the following commands were issued by #fsm_deinit.
+ */
+
+#ifndef RECORDING_H
+#define RECORDING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "hardware.h"
+#include "hardware_backend.h"
+
+/**
+ * @brief The first bytes of a recording.
+ */
+#define RECORDING_FILE_MAGIC "ELEVREC1"
+
+/**
+ * @brief The commands of a #HardwareBackend.
+ */
+typedef enum {
+    RECORDING_COMMAND_MOVEMENT,
+    RECORDING_COMMAND_ORDER_LIGHT,
+    RECORDING_COMMAND_FLOOR_INDICATOR_ON,
+    RECORDING_COMMAND_DOOR_OPEN,
+    RECORDING_COMMAND_STOP_LIGHT
+} RecordingCommandType;
+
+/**
+ * @brief One command, as written to a recording.
+ */
+typedef struct {
+    /**
+     * @brief The #RecordingCommandType of the command.
+     */
+    uint8_t type;
+
+    /**
+     * @brief The #HardwareOrder of an order light, 0 for the other commands.
+     */
+    uint8_t order_type;
+
+    /**
+     * @brief The #HardwareMovement of a movement, 1 for on or open and 0 for off or closed, 0 for the floor indicator.
+     */
+    uint8_t value;
+
+    uint8_t reserved;
+
+    /**
+     * @brief The floor of an order light or the floor indicator, 0 for the other commands.
+     */
+    int32_t floor;
+} RecordingCommand;
+
+/**
+ * @brief Records the steps and the commands of an elevator to a file.
+ */
+typedef struct {
+    FILE* p_file;
+
+    /**
+     * @brief The hardware the recorded commands are forwarded to.
+     */
+    HardwareBackend hardware;
+
+    /**
+     * @brief The inputs last written to the file.
+     */
+    HardwareSnapshot last_inputs;
+
+    /**
+     * @brief Whether any inputs have been written to the file.
+     */
+    bool has_inputs;
+} RecordingWriter;
+
+/**
+ * @brief One step of a loaded recording.
+ */
+typedef struct {
+    /**
+     * @brief The time the FSM was stepped with.
+     */
+    uint64_t now_ms;
+
+    /**
+     * @brief The inputs the FSM was stepped with.
+     */
+    HardwareSnapshot inputs;
+
+    /**
+     * @brief Index of the first command issued during the step, the commands of a step end where the commands of the
+     *        next step start.
+     */
+    size_t first_command;
+} RecordingStep;
+
+/**
+ * @brief A loaded recording.
+ */
+typedef struct {
+    int number_of_floors;
+
+    RecordingStep* p_steps;
+    size_t number_of_steps;
+
+    RecordingCommand* p_commands;
+    size_t number_of_commands;
+
+    /**
+     * @brief Whether the recording was closed after #fsm_deinit. A recording cut short, e.g. by a crash, still holds
+     *        the steps written until then, except the last one whose commands may be incomplete.
+     */
+    bool has_deinit;
+
+    /**
+     * @brief Index of the first command issued by #fsm_deinit, the number of commands if there are none.
+     */
+    size_t first_deinit_command;
+} Recording;
+
+/**
+ * @brief Creates the recording at @p path, replacing any file there.
+ *
+ * @param[out] p_writer The writer.
+ * @param[in] path Path of the recording.
+ * @param[in] p_hardware The hardware of the recorded elevator, the commands are forwarded to it.
+ *
+ * @return 0 on success, non-zero if the file could not be created.
+ */
+int recording_writer_open(RecordingWriter* p_writer, const char* path, const HardwareBackend* p_hardware);
+
+/**
+ * @brief Gets a backend which records every command and forwards it to the hardware of @p p_writer. The recorded
+ *        elevator must be commanded through it.
+ *
+ * @param[in] p_writer The writer, must outlive the backend.
+ *
+ * @return The backend.
+ */
+HardwareBackend recording_writer_backend(RecordingWriter* p_writer);
+
+/**
+ * @brief Records a step of the elevator. Must be called right before the step, with its arguments.
+ *
+ * @param[in, out] p_writer The writer.
+ * @param[in] p_inputs The inputs of the step.
+ * @param[in] now_ms The time of the step.
+ */
+void recording_writer_step(RecordingWriter* p_writer, const HardwareSnapshot* p_inputs, const uint64_t now_ms);
+
+/**
+ * @brief Records that the steps are over. Must be called right before #fsm_deinit.
+ *
+ * @param[in, out] p_writer The writer.
+ */
+void recording_writer_deinit(RecordingWriter* p_writer);
+
+/**
+ * @brief Writes what is left of the recording and closes its file.
+ *
+ * @param[in, out] p_writer The writer.
+ *
+ * @return 0 on success, non-zero if the recording could not be written.
+ */
+int recording_writer_close(RecordingWriter* p_writer);
+
+/**
+ * @brief Loads the recording at @p path.
+ *
+ * @param[in] path Path of the recording.
+ * @param[out] p_recording The loaded recording, must be freed with #recording_free.
+ *
+ * @return 0 on success, non-zero if the file could not be read or is not a recording, which is reported on stderr.
+ */
+int recording_load(const char* path, Recording* p_recording);
+
+/**
+ * @brief Frees the steps and the commands of @p p_recording.
+ *
+ * @param[in, out] p_recording The recording.
+ */
+void recording_free(Recording* p_recording);
+
+/**
+ * @brief Prints @p p_command in a readable form, without a newline.
+ *
+ * @param[in] p_command The command.
+ * @param[in] p_stream Where to print.
+ */
+void recording_print_command(const RecordingCommand* p_command, FILE* p_stream);
+
+#endif
@@ -0,0 +1,193 @@
+/**
+ * @file
+ * @brief Implementation of the scheduler.
+ */
+
+#include "scheduler.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "clock.h"
+
+/**
+ * @brief The mode the scheduler was set up with.
+ */
+static SchedulerMode m_scheduler_mode = SCHEDULER_MODE_SPIN;
+
+/**
+ * @brief The timer producing the ticks in #SCHEDULER_MODE_EVENT.
+ */
+static int m_scheduler_timer_fd = -1;
+
+/**
+ * @brief The epoll instance waiting on the timer and the event file descriptor.
+ */
+static int m_scheduler_epoll_fd = -1;
+
+/**
+ * @brief Wall time when the scheduler was set up.
+ */
+static struct timespec m_scheduler_start_wall_time;
+
+/**
+ * @brief CPU time used by the process when the scheduler was set up.
+ */
+static struct timespec m_scheduler_start_cpu_time;
+
+/**
+ * @brief Number of iterations the loop has been released for.
+ */
+static uint64_t m_scheduler_number_of_iterations = 0;
+
+/**
+ * @brief Number of timer ticks that expired while the loop was still busy with an iteration.
+ */
+static uint64_t m_scheduler_number_of_missed_ticks = 0;
+
+/**
+ * @brief Gets the seconds elapsed from @p start to @p end.
+ *
+ * @param[in] start The start time.
+ * @param[in] end The end time.
+ *
+ * @return Elapsed seconds.
+ */
+static double scheduler_seconds_between(const struct timespec start, const struct timespec end) {
+    return (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+int scheduler_init(const SchedulerMode mode, const unsigned int tick_period_ms, const int event_fd) {
+    m_scheduler_mode = mode;
+    m_scheduler_number_of_iterations = 0;
+    m_scheduler_number_of_missed_ticks = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &m_scheduler_start_wall_time);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &m_scheduler_start_cpu_time);
+
+    if (mode == SCHEDULER_MODE_SPIN) {
+        return 0;
+    }
+
+    if (tick_period_ms == 0) {
+        return 1;
+    }
+
+    m_scheduler_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (m_scheduler_timer_fd == -1) {
+        return 1;
+    }
+
+    const struct timespec period = {tick_period_ms / 1000, (tick_period_ms % 1000) * 1000000L};
+    const struct itimerspec timer_spec = {period, period};
+    if (timerfd_settime(m_scheduler_timer_fd, 0, &timer_spec, NULL) == -1) {
+        scheduler_deinit();
+        return 1;
+    }
+
+    m_scheduler_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_scheduler_epoll_fd == -1) {
+        scheduler_deinit();
+        return 1;
+    }
+
+    struct epoll_event timer_event = {.events = EPOLLIN, .data.fd = m_scheduler_timer_fd};
+    if (epoll_ctl(m_scheduler_epoll_fd, EPOLL_CTL_ADD, m_scheduler_timer_fd, &timer_event) == -1) {
+        scheduler_deinit();
+        return 1;
+    }
+
+    // Edge triggered, as the FSM only reads the hardware at the start of an iteration. Level triggering would
+    // turn unsolicited data on the descriptor into a spinning loop.
+    if (event_fd != -1) {
+        struct epoll_event hardware_event = {.events = EPOLLIN | EPOLLET, .data.fd = event_fd};
+        if (epoll_ctl(m_scheduler_epoll_fd, EPOLL_CTL_ADD, event_fd, &hardware_event) == -1) {
+            scheduler_deinit();
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Gets how long epoll may sleep before @p deadline_ms is reached.
+ *
+ * @param[in] deadline_ms The deadline on #clock_now_ms, UINT64_MAX if there is none.
+ *
+ * @return Timeout in milliseconds for epoll_wait, -1 to wait for the next tick or event.
+ */
+static int scheduler_timeout_until(const uint64_t deadline_ms) {
+    // A virtual clock does not move while we sleep, so its deadlines can not be waited for
+    if (deadline_ms == UINT64_MAX || clock_get_source() != CLOCK_SOURCE_REAL) {
+        return -1;
+    }
+
+    const uint64_t now_ms = clock_now_ms();
+    if (deadline_ms <= now_ms) {
+        return 0;
+    }
+
+    return deadline_ms - now_ms > INT_MAX ? INT_MAX : (int)(deadline_ms - now_ms);
+}
+
+void scheduler_wait(const uint64_t next_deadline_ms) {
+    m_scheduler_number_of_iterations++;
+
+    if (m_scheduler_mode == SCHEDULER_MODE_SPIN) {
+        return;
+    }
+
+    struct epoll_event events[2];
+    const int number_of_events = epoll_wait(m_scheduler_epoll_fd,
+                                            events,
+                                            sizeof(events) / sizeof(events[0]),
+                                            scheduler_timeout_until(next_deadline_ms));
+
+    for (int i = 0; i < number_of_events; i++) {
+        if (events[i].data.fd == m_scheduler_timer_fd) {
+            uint64_t expirations = 0;
+            if (read(m_scheduler_timer_fd, &expirations, sizeof(expirations)) == sizeof(expirations) && expirations > 1) {
+                m_scheduler_number_of_missed_ticks += expirations - 1;
+            }
+        }
+    }
+}
+
+void scheduler_report() {
+    struct timespec wall_time;
+    struct timespec cpu_time;
+    clock_gettime(CLOCK_MONOTONIC, &wall_time);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_time);
+
+    const double wall_seconds = scheduler_seconds_between(m_scheduler_start_wall_time, wall_time);
+    const double cpu_seconds = scheduler_seconds_between(m_scheduler_start_cpu_time, cpu_time);
+    const double saved_seconds = wall_seconds > cpu_seconds ? wall_seconds - cpu_seconds : 0.0;
+    const double load = wall_seconds > 0.0 ? 100.0 * cpu_seconds / wall_seconds : 0.0;
+
+    printf("Scheduler: %llu iterations, %llu missed ticks\n",
+           (unsigned long long)m_scheduler_number_of_iterations,
+           (unsigned long long)m_scheduler_number_of_missed_ticks);
+    printf("Scheduler: %.3f s CPU over %.3f s wall (%.1f %% of a core), saved %.3f s CPU compared with spinning\n",
+           cpu_seconds,
+           wall_seconds,
+           load,
+           saved_seconds);
+}
+
+void scheduler_deinit() {
+    if (m_scheduler_epoll_fd != -1) {
+        close(m_scheduler_epoll_fd);
+        m_scheduler_epoll_fd = -1;
+    }
+
+    if (m_scheduler_timer_fd != -1) {
+        close(m_scheduler_timer_fd);
+        m_scheduler_timer_fd = -1;
+    }
+}
@@ -0,0 +1,61 @@
+/**
+ * @file
+ * @brief Paces the FSM loop. The loop can either spin as fast as possible, or sleep until the next tick of a
+ *        timer or until the hardware has something for us.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+
+/**
+ * @brief How the FSM loop is paced.
+ */
+typedef enum {
+    /**
+     * @brief Run the next iteration immediately, keeps one core busy.
+     */
+    SCHEDULER_MODE_SPIN,
+
+    /**
+     * @brief Sleep in epoll until a timerfd tick, the next timer deadline, or until the hardware file descriptor
+     *        becomes readable.
+     */
+    SCHEDULER_MODE_EVENT
+} SchedulerMode;
+
+/**
+ * @brief Sets up the scheduler. Must be called once before #scheduler_wait.
+ *
+ * @param[in] mode How the loop should be paced.
+ * @param[in] tick_period_ms Period of the timer tick in milliseconds, only used with #SCHEDULER_MODE_EVENT.
+ * @param[in] event_fd File descriptor which wakes the loop when readable, -1 if there is none. Only used with
+ *                     #SCHEDULER_MODE_EVENT.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+int scheduler_init(const SchedulerMode mode, const unsigned int tick_period_ms, const int event_fd);
+
+/**
+ * @brief Blocks until the next iteration of the loop should run.
+ *
+ * @param[in] next_deadline_ms Wake up no later than this time on #clock_now_ms, e.g. from #timer_next_deadline_ms.
+ *                             UINT64_MAX if there is no deadline.
+ *
+ * @note Returns early if interrupted by a signal, so the caller can check whether it should stop.
+ */
+void scheduler_wait(const uint64_t next_deadline_ms);
+
+/**
+ * @brief Prints how much CPU time the loop used since #scheduler_init, and how much it saved compared with
+ *        spinning on one core for the same wall time.
+ */
+void scheduler_report();
+
+/**
+ * @brief Releases the timer and epoll file descriptors.
+ */
+void scheduler_deinit();
+
+#endif
@@ -0,0 +1,214 @@
+/**
+ * @file
+ * @brief Implementation of the simulated elevator.
+ */
+
+#include "sim_elevator.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Checks if the order button of @p order_type exists at @p floor. There is no down button at the bottom
+ *        floor and no up button at the top floor.
+ *
+ * @param[in] p_elevator The elevator.
+ * @param[in] floor Floor of the button.
+ * @param[in] order_type Type of the button.
+ *
+ * @return true if the button exists.
+ */
+static bool sim_elevator_button_exists(const SimElevator* p_elevator, const int floor, const HardwareOrder order_type) {
+    if (floor < 0 || floor >= p_elevator->number_of_floors) {
+        return false;
+    }
+
+    if (floor == 0 && order_type == HARDWARE_ORDER_DOWN) {
+        return false;
+    }
+
+    if (floor == p_elevator->number_of_floors - 1 && order_type == HARDWARE_ORDER_UP) {
+        return false;
+    }
+
+    return true;
+}
+
+void sim_elevator_init(SimElevator* p_elevator, const int number_of_floors, const double position) {
+    *p_elevator = (SimElevator){0};
+
+    p_elevator->number_of_floors = number_of_floors;
+    p_elevator->travel_time = SIM_ELEVATOR_DEFAULT_TRAVEL_TIME;
+    p_elevator->sensor_window = SIM_ELEVATOR_DEFAULT_SENSOR_WINDOW;
+    p_elevator->position = position;
+    p_elevator->movement = HARDWARE_MOVEMENT_STOP;
+}
+
+void sim_elevator_step(SimElevator* p_elevator, const double seconds) {
+    for (int word = 0; word < HARDWARE_NUMBER_OF_ORDER_WORDS; word++) {
+        for (uint64_t buttons = p_elevator->pressed_buttons[word]; buttons; buttons &= buttons - 1) {
+            const int bit = __builtin_ctzll(buttons);
+            const int index = word * 64 + bit;
+            double* p_hold_time =
+                &p_elevator->button_hold_time[index / HARDWARE_NUMBER_OF_BUTTONS][index % HARDWARE_NUMBER_OF_BUTTONS];
+
+            *p_hold_time = *p_hold_time > seconds ? *p_hold_time - seconds : 0.0;
+            if (*p_hold_time == 0.0) {
+                p_elevator->pressed_buttons[word] &= ~(UINT64_C(1) << bit);
+            }
+        }
+    }
+
+    double distance = seconds / p_elevator->travel_time;
+    if (p_elevator->movement == HARDWARE_MOVEMENT_UP) {
+        p_elevator->position += distance;
+    } else if (p_elevator->movement == HARDWARE_MOVEMENT_DOWN) {
+        p_elevator->position -= distance;
+    }
+
+    const double top_position = p_elevator->number_of_floors - 1;
+
+    if (p_elevator->position < 0.0) {
+        p_elevator->position = 0.0;
+        p_elevator->is_out_of_bounds = true;
+    } else if (p_elevator->position > top_position) {
+        p_elevator->position = top_position;
+        p_elevator->is_out_of_bounds = true;
+    }
+}
+
+bool sim_elevator_press_button(SimElevator* p_elevator, const int floor, const HardwareOrder order_type) {
+    if (!sim_elevator_button_exists(p_elevator, floor, order_type)) {
+        return false;
+    }
+
+    p_elevator->button_hold_time[floor][order_type] = SIM_ELEVATOR_BUTTON_PRESS_TIME;
+    p_elevator->pressed_buttons[HARDWARE_ORDER_WORD(floor, order_type)] |= HARDWARE_ORDER_BIT(floor, order_type);
+    return true;
+}
+
+bool sim_elevator_button_is_pressed(const SimElevator* p_elevator, const int floor, const HardwareOrder order_type) {
+    return sim_elevator_button_exists(p_elevator, floor, order_type) &&
+           p_elevator->button_hold_time[floor][order_type] > 0.0;
+}
+
+int sim_elevator_floor_sensor(const SimElevator* p_elevator) {
+    const double nearest_floor = round(p_elevator->position);
+
+    if (fabs(p_elevator->position - nearest_floor) <= p_elevator->sensor_window) {
+        return (int)nearest_floor;
+    }
+
+    return -1;
+}
+
+void sim_elevator_read_snapshot(const SimElevator* p_elevator, HardwareSnapshot* p_snapshot) {
+    memcpy(p_snapshot->orders, p_elevator->pressed_buttons, sizeof(p_snapshot->orders));
+    p_snapshot->floor = sim_elevator_floor_sensor(p_elevator);
+    p_snapshot->stop_signal = p_elevator->stop_button;
+    p_snapshot->obstruction_signal = p_elevator->obstruction;
+}
+
+/**
+ * @brief Sets the commanded movement of the elevator at @p p_context.
+ *
+ * @param[in, out] p_context The elevator.
+ * @param[in] movement Commanded movement.
+ */
+static void sim_elevator_command_movement(void* p_context, const HardwareMovement movement) {
+    SimElevator* p_elevator = p_context;
+    p_elevator->movement = movement;
+}
+
+/**
+ * @brief Sets an order light of the elevator at @p p_context.
+ *
+ * @param[in, out] p_context The elevator.
+ * @param[in] floor The floor of the order light.
+ * @param[in] order_type The type of order.
+ * @param[in] on Whether the light is on.
+ */
+static void sim_elevator_command_order_light(void* p_context,
+                                             const int floor,
+                                             const HardwareOrder order_type,
+                                             const bool on) {
+    SimElevator* p_elevator = p_context;
+    assert(floor >= 0 && floor < p_elevator->number_of_floors);
+    p_elevator->order_lights[floor][order_type] = on;
+}
+
+/**
+ * @brief Sets the floor indicator of the elevator at @p p_context.
+ *
+ * @param[in, out] p_context The elevator.
+ * @param[in] floor The floor to show.
+ */
+static void sim_elevator_command_floor_indicator_on(void* p_context, const int floor) {
+    SimElevator* p_elevator = p_context;
+    assert(floor >= 0 && floor < p_elevator->number_of_floors);
+    p_elevator->floor_indicator = floor;
+}
+
+/**
+ * @brief Opens or closes the door of the elevator at @p p_context.
+ *
+ * @param[in, out] p_context The elevator.
+ * @param[in] door_open Whether the door is open.
+ */
+static void sim_elevator_command_door_open(void* p_context, const bool door_open) {
+    SimElevator* p_elevator = p_context;
+    p_elevator->door_open = door_open;
+}
+
+/**
+ * @brief Sets the stop light of the elevator at @p p_context.
+ *
+ * @param[in, out] p_context The elevator.
+ * @param[in] on Whether the light is on.
+ */
+static void sim_elevator_command_stop_light(void* p_context, const bool on) {
+    SimElevator* p_elevator = p_context;
+    p_elevator->stop_light = on;
+}
+
+/**
+ * @brief The commands of the backend given by #sim_elevator_backend.
+ */
+static const HardwareBackendOperations m_sim_elevator_backend_operations = {
+    .command_movement = sim_elevator_command_movement,
+    .command_order_light = sim_elevator_command_order_light,
+    .command_floor_indicator_on = sim_elevator_command_floor_indicator_on,
+    .command_door_open = sim_elevator_command_door_open,
+    .command_stop_light = sim_elevator_command_stop_light,
+};
+
+HardwareBackend sim_elevator_backend(SimElevator* p_elevator) {
+    return (HardwareBackend){&m_sim_elevator_backend_operations, p_elevator, p_elevator->number_of_floors, NULL};
+}
+
+void sim_elevator_print(const SimElevator* p_elevator) {
+    static const char* movement_names[] = {"up", "stop", "down"};
+
+    printf("position %.2f, sensor %i, motor %s, door %s, indicator %i, stop light %s, stop %s, obstruction %s%s\n",
+           p_elevator->position,
+           sim_elevator_floor_sensor(p_elevator),
+           movement_names[p_elevator->movement],
+           p_elevator->door_open ? "open" : "closed",
+           p_elevator->floor_indicator,
+           p_elevator->stop_light ? "on" : "off",
+           p_elevator->stop_button ? "on" : "off",
+           p_elevator->obstruction ? "on" : "off",
+           p_elevator->is_out_of_bounds ? ", OUT OF BOUNDS" : "");
+
+    printf("lights:");
+    for (int floor = 0; floor < p_elevator->number_of_floors; floor++) {
+        printf(" %i[%c%c%c]",
+               floor,
+               p_elevator->order_lights[floor][HARDWARE_ORDER_UP] ? 'u' : '-',
+               p_elevator->order_lights[floor][HARDWARE_ORDER_INSIDE] ? 'c' : '-',
+               p_elevator->order_lights[floor][HARDWARE_ORDER_DOWN] ? 'd' : '-');
+    }
+    printf("\n");
+}
@@ -0,0 +1,180 @@
+/**
+ * @file
+ * @brief Physical model of an elevator car and its panel, used by the simulator server. It keeps the inputs the
+ *        controller reads (buttons, floor sensors, stop and obstruction) and the outputs it writes (motor, lights
+ *        and door), and moves the car when it is stepped forward in time.
+ */
+
+#ifndef SIM_ELEVATOR_H
+#define SIM_ELEVATOR_H
+
+#include <stdbool.h>
+
+#include "hardware.h"
+#include "hardware_backend.h"
+
+/**
+ * @brief Seconds the car takes to travel from one floor to the next.
+ */
+#define SIM_ELEVATOR_DEFAULT_TRAVEL_TIME 2.0
+
+/**
+ * @brief Distance from a floor, in floors, within which the floor sensor of that floor is active.
+ */
+#define SIM_ELEVATOR_DEFAULT_SENSOR_WINDOW 0.05
+
+/**
+ * @brief Seconds an order button is held down when pressed.
+ */
+#define SIM_ELEVATOR_BUTTON_PRESS_TIME 0.2
+
+/**
+ * @brief The simulated elevator.
+ */
+typedef struct {
+    /**
+     * @brief Number of floors served by the car.
+     */
+    int number_of_floors;
+
+    /**
+     * @brief Seconds the car takes to travel from one floor to the next.
+     */
+    double travel_time;
+
+    /**
+     * @brief Distance from a floor, in floors, within which its floor sensor is active.
+     */
+    double sensor_window;
+
+    /**
+     * @brief Position of the car in floors, 0.0 being the bottom floor.
+     */
+    double position;
+
+    /**
+     * @brief The movement commanded by the controller.
+     */
+    HardwareMovement movement;
+
+    /**
+     * @brief Set if the car has been driven past the top or bottom floor.
+     */
+    bool is_out_of_bounds;
+
+    /**
+     * @brief Seconds each order button stays pressed, 0 if it is released.
+     */
+    double button_hold_time[HARDWARE_MAX_NUMBER_OF_FLOORS][HARDWARE_NUMBER_OF_BUTTONS];
+
+    /**
+     * @brief The order buttons which are pressed, laid out like @c HardwareSnapshot::orders, so they can be read and
+     *        released without visiting every floor.
+     */
+    uint64_t pressed_buttons[HARDWARE_NUMBER_OF_ORDER_WORDS];
+
+    /**
+     * @brief The order lights, indexed by floor and #HardwareOrder.
+     */
+    bool order_lights[HARDWARE_MAX_NUMBER_OF_FLOORS][HARDWARE_NUMBER_OF_BUTTONS];
+
+    /**
+     * @brief The floor shown by the floor indicator.
+     */
+    int floor_indicator;
+
+    /**
+     * @brief Whether the door is open.
+     */
+    bool door_open;
+
+    /**
+     * @brief Whether the light in the stop button is on.
+     */
+    bool stop_light;
+
+    /**
+     * @brief Whether the stop button is pressed.
+     */
+    bool stop_button;
+
+    /**
+     * @brief Whether the door is obstructed.
+     */
+    bool obstruction;
+} SimElevator;
+
+/**
+ * @brief Sets up the elevator standing still with all lights off.
+ *
+ * @param[out] p_elevator The elevator to set up.
+ * @param[in] number_of_floors Number of floors, at most #HARDWARE_MAX_NUMBER_OF_FLOORS.
+ * @param[in] position Start position of the car in floors.
+ */
+void sim_elevator_init(SimElevator* p_elevator, const int number_of_floors, const double position);
+
+/**
+ * @brief Moves the car and releases buttons according to @p seconds passing.
+ *
+ * @param[in, out] p_elevator The elevator.
+ * @param[in] seconds Time to step forward.
+ */
+void sim_elevator_step(SimElevator* p_elevator, const double seconds);
+
+/**
+ * @brief Presses an order button, which is held down for #SIM_ELEVATOR_BUTTON_PRESS_TIME.
+ *
+ * @param[in, out] p_elevator The elevator.
+ * @param[in] floor Floor of the button.
+ * @param[in] order_type Type of the button.
+ *
+ * @return true if the button exists.
+ */
+bool sim_elevator_press_button(SimElevator* p_elevator, const int floor, const HardwareOrder order_type);
+
+/**
+ * @brief Checks if an order button is pressed.
+ *
+ * @param[in] p_elevator The elevator.
+ * @param[in] floor Floor of the button.
+ * @param[in] order_type Type of the button.
+ *
+ * @return true if the button is pressed.
+ */
+bool sim_elevator_button_is_pressed(const SimElevator* p_elevator, const int floor, const HardwareOrder order_type);
+
+/**
+ * @brief Gets the floor whose floor sensor is active.
+ *
+ * @param[in] p_elevator The elevator.
+ *
+ * @return The floor, or -1 if the car is between the sensors.
+ */
+int sim_elevator_floor_sensor(const SimElevator* p_elevator);
+
+/**
+ * @brief Reads every input of the elevator, like #hardware_read_snapshot does for the hardware.
+ *
+ * @param[in] p_elevator The elevator.
+ * @param[out] p_snapshot Snapshot to fill.
+ */
+void sim_elevator_read_snapshot(const SimElevator* p_elevator, HardwareSnapshot* p_snapshot);
+
+/**
+ * @brief Gets a hardware backend whose commands drive the outputs of @p p_elevator, so that an FSM can control it
+ *        in the same process.
+ *
+ * @param[in] p_elevator The elevator, must outlive the backend.
+ *
+ * @return The backend.
+ */
+HardwareBackend sim_elevator_backend(SimElevator* p_elevator);
+
+/**
+ * @brief Prints the state of the elevator on one line.
+ *
+ * @param[in] p_elevator The elevator.
+ */
+void sim_elevator_print(const SimElevator* p_elevator);
+
+#endif
@@ -0,0 +1,494 @@
+/**
+ * @file
+ * @brief Simulator server for the elevator. Serves the 4 byte protocol used by driver/hardware_sim.c on a TCP port,
+ *        models the car with #SimElevator, and takes commands for the buttons and switches on standard input:
+ *
+ *        @c up|down|cab @c <floor> presses an order button, @c stop and @c obstruction toggle the switches,
+ *        @c status prints the state of the elevator and @c quit stops the server.
+ */
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sim_elevator.h"
+
+/**
+ * @brief Port the server listens on unless told otherwise, the same as the stock simulator.
+ */
+#define SIM_SERVER_DEFAULT_PORT 15657
+
+/**
+ * @brief Longest time between steps of the model when nothing happens, in milliseconds.
+ */
+#define SIM_SERVER_STEP_INTERVAL_MS 5
+
+/**
+ * @brief Number of bytes read from the client at a time.
+ */
+#define SIM_SERVER_RECEIVE_BUFFER_SIZE 4096
+
+/**
+ * @brief Longest reply to a single message, the bulk state reply.
+ */
+#define SIM_SERVER_MAX_REPLY_SIZE (4 + HARDWARE_MAX_NUMBER_OF_FLOORS)
+
+/**
+ * @brief Opcodes of the protocol.
+ */
+typedef enum {
+    SIM_SERVER_OPCODE_RELOAD,
+    SIM_SERVER_OPCODE_MOTOR,
+    SIM_SERVER_OPCODE_ORDER_LIGHT,
+    SIM_SERVER_OPCODE_FLOOR_INDICATOR,
+    SIM_SERVER_OPCODE_DOOR,
+    SIM_SERVER_OPCODE_STOP_LIGHT,
+    SIM_SERVER_OPCODE_ORDER_BUTTON,
+    SIM_SERVER_OPCODE_FLOOR_SENSOR,
+    SIM_SERVER_OPCODE_STOP_BUTTON,
+    SIM_SERVER_OPCODE_OBSTRUCTION,
+    SIM_SERVER_OPCODE_SNAPSHOT
+} SimServerOpcode;
+
+/**
+ * @brief The simulated elevator.
+ */
+static SimElevator m_sim_server_elevator;
+
+/**
+ * @brief When the model was last stepped.
+ */
+static struct timespec m_sim_server_last_step_time;
+
+/**
+ * @brief Whether to print the changes of the elevator as they happen.
+ */
+static bool m_sim_server_is_verbose = true;
+
+/**
+ * @brief Set when the server should stop.
+ */
+static bool m_sim_server_should_quit = false;
+
+/**
+ * @brief Converts an order type of the protocol to a #HardwareOrder.
+ *
+ * @param[in] legacy_order_type Order type of the protocol: 0 for up, 1 for down and 2 for cab.
+ * @param[out] p_order_type The order type.
+ *
+ * @return false if @p legacy_order_type is not valid.
+ */
+static bool sim_server_order_from_legacy(const int legacy_order_type, HardwareOrder* p_order_type) {
+    switch (legacy_order_type) {
+        case 0:
+            *p_order_type = HARDWARE_ORDER_UP;
+            return true;
+        case 1:
+            *p_order_type = HARDWARE_ORDER_DOWN;
+            return true;
+        case 2:
+            *p_order_type = HARDWARE_ORDER_INSIDE;
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Converts a motor direction of the protocol to a #HardwareMovement.
+ *
+ * @param[in] legacy_direction Direction of the protocol: 1 for up, -1 for down and 0 for stop.
+ *
+ * @return The movement.
+ */
+static HardwareMovement sim_server_movement_from_legacy(const signed char legacy_direction) {
+    if (legacy_direction > 0) {
+        return HARDWARE_MOVEMENT_UP;
+    } else if (legacy_direction < 0) {
+        return HARDWARE_MOVEMENT_DOWN;
+    }
+
+    return HARDWARE_MOVEMENT_STOP;
+}
+
+/**
+ * @brief Checks if @p floor is served by the elevator.
+ *
+ * @param[in] floor The floor to check.
+ *
+ * @return true if @p floor is valid.
+ */
+static bool sim_server_floor_is_valid(const int floor) {
+    return floor >= 0 && floor < m_sim_server_elevator.number_of_floors;
+}
+
+/**
+ * @brief Steps the model forward to the current time, and prints what changed if verbose.
+ */
+static void sim_server_step_to_now() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    const double seconds = (double)(now.tv_sec - m_sim_server_last_step_time.tv_sec) +
+                           (double)(now.tv_nsec - m_sim_server_last_step_time.tv_nsec) / 1e9;
+    m_sim_server_last_step_time = now;
+
+    const int previous_floor = sim_elevator_floor_sensor(&m_sim_server_elevator);
+    const bool was_out_of_bounds = m_sim_server_elevator.is_out_of_bounds;
+
+    sim_elevator_step(&m_sim_server_elevator, seconds);
+
+    const int floor = sim_elevator_floor_sensor(&m_sim_server_elevator);
+
+    if (m_sim_server_is_verbose && floor != previous_floor && floor != -1) {
+        printf("Arrived at floor %i\n", floor);
+    }
+
+    if (m_sim_server_elevator.is_out_of_bounds && !was_out_of_bounds) {
+        printf("Elevator was driven out of bounds at position %.2f\n", m_sim_server_elevator.position);
+    }
+}
+
+/**
+ * @brief Handles one message from the client.
+ *
+ * @param[in] message The 4 byte message.
+ * @param[out] p_reply Buffer for the reply, must have room for #SIM_SERVER_MAX_REPLY_SIZE bytes.
+ *
+ * @return Number of bytes written to @p p_reply, 0 if the message has no reply.
+ */
+static size_t sim_server_handle_message(const unsigned char message[4], unsigned char* p_reply) {
+    SimElevator* p_elevator = &m_sim_server_elevator;
+    HardwareOrder order_type;
+
+    switch ((SimServerOpcode)message[0]) {
+        case SIM_SERVER_OPCODE_RELOAD:
+            break;
+
+        case SIM_SERVER_OPCODE_MOTOR: {
+            const HardwareMovement movement = sim_server_movement_from_legacy((signed char)message[1]);
+            if (m_sim_server_is_verbose && movement != p_elevator->movement) {
+                static const char* movement_names[] = {"up", "stop", "down"};
+                printf("Motor %s at position %.2f\n", movement_names[movement], p_elevator->position);
+            }
+            p_elevator->movement = movement;
+        } break;
+
+        case SIM_SERVER_OPCODE_ORDER_LIGHT:
+            if (sim_server_order_from_legacy(message[1], &order_type) && sim_server_floor_is_valid(message[2])) {
+                p_elevator->order_lights[message[2]][order_type] = message[3] != 0;
+            }
+            break;
+
+        case SIM_SERVER_OPCODE_FLOOR_INDICATOR:
+            if (sim_server_floor_is_valid(message[1])) {
+                p_elevator->floor_indicator = message[1];
+            }
+            break;
+
+        case SIM_SERVER_OPCODE_DOOR:
+            if (m_sim_server_is_verbose && p_elevator->door_open != (message[1] != 0)) {
+                printf("Door %s\n", message[1] ? "open" : "closed");
+            }
+            p_elevator->door_open = message[1] != 0;
+            break;
+
+        case SIM_SERVER_OPCODE_STOP_LIGHT:
+            p_elevator->stop_light = message[1] != 0;
+            break;
+
+        case SIM_SERVER_OPCODE_ORDER_BUTTON: {
+            const bool is_pressed = sim_server_order_from_legacy(message[1], &order_type) &&
+                                    sim_elevator_button_is_pressed(p_elevator, message[2], order_type);
+            memcpy(p_reply, (unsigned char[4]){message[0], is_pressed}, 4);
+        }
+            return 4;
+
+        case SIM_SERVER_OPCODE_FLOOR_SENSOR: {
+            const int floor = sim_elevator_floor_sensor(p_elevator);
+            memcpy(p_reply, (unsigned char[4]){message[0], floor != -1, floor != -1 ? floor : 0}, 4);
+        }
+            return 4;
+
+        case SIM_SERVER_OPCODE_STOP_BUTTON:
+            memcpy(p_reply, (unsigned char[4]){message[0], p_elevator->stop_button}, 4);
+            return 4;
+
+        case SIM_SERVER_OPCODE_OBSTRUCTION:
+            memcpy(p_reply, (unsigned char[4]){message[0], p_elevator->obstruction}, 4);
+            return 4;
+
+        case SIM_SERVER_OPCODE_SNAPSHOT: {
+            const int floor = sim_elevator_floor_sensor(p_elevator);
+            p_reply[0] = message[0];
+            p_reply[1] = floor != -1;
+            p_reply[2] = floor != -1 ? floor : 0;
+            p_reply[3] = p_elevator->stop_button | (p_elevator->obstruction << 1);
+
+            for (int i = 0; i < p_elevator->number_of_floors; i++) {
+                p_reply[4 + i] = sim_elevator_button_is_pressed(p_elevator, i, HARDWARE_ORDER_UP) << 0 |
+                                 sim_elevator_button_is_pressed(p_elevator, i, HARDWARE_ORDER_DOWN) << 1 |
+                                 sim_elevator_button_is_pressed(p_elevator, i, HARDWARE_ORDER_INSIDE) << 2;
+            }
+        }
+            return 4 + p_elevator->number_of_floors;
+
+        default:
+            fprintf(stderr, "Unknown opcode %i\n", message[0]);
+            break;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Writes all of @p length bytes of @p p_data to @p fd.
+ *
+ * @param[in] fd File descriptor to write to.
+ * @param[in] p_data Data to write.
+ * @param[in] length Number of bytes to write.
+ *
+ * @return false if the write failed.
+ */
+static bool sim_server_write_all(const int fd, const unsigned char* p_data, size_t length) {
+    while (length > 0) {
+        const ssize_t written = send(fd, p_data, length, MSG_NOSIGNAL);
+        if (written <= 0) {
+            return false;
+        }
+        p_data += written;
+        length -= written;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Reads what the client has sent, handles every complete message and sends all the replies at once.
+ *
+ * @param[in] client_fd The client socket.
+ * @param[in, out] p_pending Bytes of an incomplete message from the previous read.
+ * @param[in, out] p_number_of_pending Number of bytes in @p p_pending.
+ *
+ * @return false if the client disconnected.
+ */
+static bool sim_server_handle_client(const int client_fd, unsigned char* p_pending, size_t* p_number_of_pending) {
+    static unsigned char receive_buffer[4 + SIM_SERVER_RECEIVE_BUFFER_SIZE];
+    static unsigned char reply_buffer[(SIM_SERVER_RECEIVE_BUFFER_SIZE / 4 + 1) * SIM_SERVER_MAX_REPLY_SIZE];
+
+    memcpy(receive_buffer, p_pending, *p_number_of_pending);
+    const ssize_t received = recv(client_fd, receive_buffer + *p_number_of_pending, SIM_SERVER_RECEIVE_BUFFER_SIZE, 0);
+    if (received <= 0) {
+        return false;
+    }
+
+    const size_t length = *p_number_of_pending + received;
+    size_t reply_length = 0;
+    size_t offset = 0;
+
+    sim_server_step_to_now();
+
+    for (; offset + 4 <= length; offset += 4) {
+        reply_length += sim_server_handle_message(receive_buffer + offset, reply_buffer + reply_length);
+    }
+
+    *p_number_of_pending = length - offset;
+    memcpy(p_pending, receive_buffer + offset, *p_number_of_pending);
+
+    return sim_server_write_all(client_fd, reply_buffer, reply_length);
+}
+
+/**
+ * @brief Handles one line of commands from standard input.
+ *
+ * @param[in] line The line.
+ */
+static void sim_server_handle_command(const char* line) {
+    char command[32];
+    int floor = -1;
+
+    const int number_of_fields = sscanf(line, "%31s %i", command, &floor);
+    if (number_of_fields < 1) {
+        return;
+    }
+
+    HardwareOrder order_type;
+    bool is_order = true;
+
+    if (strcmp(command, "up") == 0) {
+        order_type = HARDWARE_ORDER_UP;
+    } else if (strcmp(command, "down") == 0) {
+        order_type = HARDWARE_ORDER_DOWN;
+    } else if (strcmp(command, "cab") == 0) {
+        order_type = HARDWARE_ORDER_INSIDE;
+    } else {
+        is_order = false;
+    }
+
+    if (is_order) {
+        if (number_of_fields < 2 || !sim_elevator_press_button(&m_sim_server_elevator, floor, order_type)) {
+            fprintf(stderr, "No such button: %s", line);
+        }
+    } else if (strcmp(command, "stop") == 0) {
+        m_sim_server_elevator.stop_button = !m_sim_server_elevator.stop_button;
+        printf("Stop %s\n", m_sim_server_elevator.stop_button ? "on" : "off");
+    } else if (strcmp(command, "obstruction") == 0) {
+        m_sim_server_elevator.obstruction = !m_sim_server_elevator.obstruction;
+        printf("Obstruction %s\n", m_sim_server_elevator.obstruction ? "on" : "off");
+    } else if (strcmp(command, "status") == 0) {
+        sim_elevator_print(&m_sim_server_elevator);
+    } else if (strcmp(command, "quit") == 0) {
+        m_sim_server_should_quit = true;
+    } else {
+        fprintf(stderr, "Unknown command: %s", line);
+    }
+}
+
+/**
+ * @brief Sets up a socket listening on @p port.
+ *
+ * @param[in] port The port.
+ *
+ * @return The socket, -1 on failure.
+ */
+static int sim_server_listen(const int port) {
+    const int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd == -1) {
+        return -1;
+    }
+
+    const int reuse_address = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse_address, sizeof(reuse_address));
+
+    struct sockaddr_in address = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+
+    if (bind(listen_fd, (struct sockaddr*)&address, sizeof(address)) == -1 || listen(listen_fd, 1) == -1) {
+        close(listen_fd);
+        return -1;
+    }
+
+    return listen_fd;
+}
+
+/**
+ * @brief Entry point of the simulator server.
+ *
+ * @param argc Argument count passed to the binary.
+ * @param argv Argument values passed to the binary.
+ *
+ * @return Exit status.
+ */
+int main(const int argc, const char** argv) {
+    int port = SIM_SERVER_DEFAULT_PORT;
+    int number_of_floors = HARDWARE_DEFAULT_NUMBER_OF_FLOORS;
+    double position = 0.0;
+    double travel_time = SIM_ELEVATOR_DEFAULT_TRAVEL_TIME;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--floors") == 0 && i + 1 < argc) {
+            number_of_floors = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--position") == 0 && i + 1 < argc) {
+            position = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--travel-time") == 0 && i + 1 < argc) {
+            travel_time = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            m_sim_server_is_verbose = false;
+        } else {
+            fprintf(stderr,
+                    "Usage: %s [--port <port>] [--floors <floors>] [--position <floor>] [--travel-time <seconds>] [--quiet]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    if (number_of_floors < 2 || number_of_floors > HARDWARE_MAX_NUMBER_OF_FLOORS) {
+        fprintf(stderr, "Number of floors must be between 2 and %i\n", HARDWARE_MAX_NUMBER_OF_FLOORS);
+        return 1;
+    }
+
+    sim_elevator_init(&m_sim_server_elevator, number_of_floors, position);
+    m_sim_server_elevator.travel_time = travel_time;
+    clock_gettime(CLOCK_MONOTONIC, &m_sim_server_last_step_time);
+
+    const int listen_fd = sim_server_listen(port);
+    if (listen_fd == -1) {
+        fprintf(stderr, "Unable to listen on port %i: %s\n", port, strerror(errno));
+        return 1;
+    }
+
+    printf("Simulator listening on port %i\n", port);
+    fflush(stdout);
+
+    int client_fd = -1;
+    bool stdin_is_open = true;
+    unsigned char pending[4];
+    size_t number_of_pending = 0;
+
+    while (!m_sim_server_should_quit) {
+        struct pollfd fds[] = {
+            {.fd = listen_fd, .events = POLLIN},
+            {.fd = client_fd, .events = POLLIN},
+            {.fd = stdin_is_open ? STDIN_FILENO : -1, .events = POLLIN},
+        };
+
+        if (poll(fds, sizeof(fds) / sizeof(fds[0]), SIM_SERVER_STEP_INTERVAL_MS) == -1 && errno != EINTR) {
+            break;
+        }
+
+        sim_server_step_to_now();
+
+        if (fds[0].revents & POLLIN) {
+            const int new_client_fd = accept(listen_fd, NULL, NULL);
+            if (new_client_fd != -1 && client_fd != -1) {
+                // Only one controller at a time
+                close(new_client_fd);
+            } else if (new_client_fd != -1) {
+                const int nodelay = 1;
+                setsockopt(new_client_fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+                client_fd = new_client_fd;
+                number_of_pending = 0;
+                printf("Controller connected\n");
+            }
+        }
+
+        if (fds[1].revents & (POLLIN | POLLHUP | POLLERR)) {
+            if (!sim_server_handle_client(client_fd, pending, &number_of_pending)) {
+                close(client_fd);
+                client_fd = -1;
+                printf("Controller disconnected\n");
+            }
+        }
+
+        if (fds[2].revents & (POLLIN | POLLHUP)) {
+            char line[128];
+            if (fgets(line, sizeof(line), stdin)) {
+                sim_server_handle_command(line);
+            } else {
+                stdin_is_open = false;
+            }
+        }
+
+        fflush(stdout);
+    }
+
+    if (client_fd != -1) {
+        close(client_fd);
+    }
+    close(listen_fd);
+
+    return 0;
+}
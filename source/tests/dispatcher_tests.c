@@ -0,0 +1,202 @@
+/**
+ * @file 
+ * 
+ * @brief Implementation of the dispatcher tests module.
+ */
+
+#include "dispatcher_tests.h"
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "dispatcher.h"
+
+/**
+ * @brief Floors of the building in the tests.
+ */
+#define DISPATCHER_TESTS_NUMBER_OF_FLOORS 4
+
+/**
+ * @brief Seconds between two floors in the tests.
+ */
+#define DISPATCHER_TESTS_TRAVEL_TIME 2.0
+
+/**
+ * @brief Seconds per stop in the tests.
+ */
+#define DISPATCHER_TESTS_STOP_TIME 5.0
+
+/**
+ * @brief Checks that a call goes to the nearest idle car, and to no car before any car knows where it is. Such a call
+ *        is kept, and assigned once the cars know where they are.
+ *
+ * @note Test TDISPATCH-1
+ *
+ * @return true if the nearest car got the call.
+ */
+bool dispatcher_tests_check_nearest_idle_car() {
+    Dispatcher dispatcher;
+    dispatcher_init(&dispatcher,
+                    DISPATCHER_TESTS_NUMBER_OF_FLOORS,
+                    2,
+                    DISPATCHER_TESTS_TRAVEL_TIME,
+                    DISPATCHER_TESTS_STOP_TIME);
+
+    if (dispatcher_assign_hall_call(&dispatcher, 2, HARDWARE_ORDER_UP) != DISPATCHER_NO_CAR) {
+        return false;
+    }
+
+    dispatcher_update_car(&dispatcher, 0, (Position){.floor = 0, .offset = OFFSET_AT_FLOOR}, HARDWARE_MOVEMENT_STOP);
+    dispatcher_update_car(&dispatcher, 1, (Position){.floor = 3, .offset = OFFSET_AT_FLOOR}, HARDWARE_MOVEMENT_STOP);
+
+    if (!dispatcher_hall_light_is_on(&dispatcher, 2, HARDWARE_ORDER_UP) ||
+        dispatcher_get_hall_call_car(&dispatcher, 2, HARDWARE_ORDER_UP) != DISPATCHER_NO_CAR) {
+        return false;
+    }
+    dispatcher_assign_unassigned_hall_calls(&dispatcher);
+
+    return dispatcher_get_hall_call_car(&dispatcher, 2, HARDWARE_ORDER_UP) == 1 &&
+           dispatcher_assign_hall_call(&dispatcher, 1, HARDWARE_ORDER_UP) == 0 &&
+           dispatcher_assign_hall_call(&dispatcher, 2, HARDWARE_ORDER_DOWN) == 1;
+}
+
+/**
+ * @brief Checks that a car passing a call in its direction is preferred over a nearer car going away from it.
+ *
+ * @note Test TDISPATCH-2
+ *
+ * @return true if the car on the way got the call.
+ */
+bool dispatcher_tests_check_car_on_the_way() {
+    Dispatcher dispatcher;
+    dispatcher_init(&dispatcher,
+                    DISPATCHER_TESTS_NUMBER_OF_FLOORS,
+                    2,
+                    DISPATCHER_TESTS_TRAVEL_TIME,
+                    DISPATCHER_TESTS_STOP_TIME);
+
+    // Car 0 is leaving floor 0 for floor 3, car 1 is nearer floor 2 but on its way down to floor 0
+    dispatcher_update_car(&dispatcher, 0, (Position){.floor = 0, .offset = OFFSET_ABOVE}, HARDWARE_MOVEMENT_UP);
+    dispatcher_add_cab_call(&dispatcher, 0, 3);
+    dispatcher_update_car(&dispatcher, 1, (Position){.floor = 2, .offset = OFFSET_BELOW}, HARDWARE_MOVEMENT_DOWN);
+    dispatcher_add_cab_call(&dispatcher, 1, 0);
+
+    const bool up_call_ok = dispatcher_assign_hall_call(&dispatcher, 2, HARDWARE_ORDER_UP) == 0;
+    const bool down_call_ok = dispatcher_assign_hall_call(&dispatcher, 1, HARDWARE_ORDER_DOWN) == 1;
+
+    return up_call_ok && down_call_ok;
+}
+
+/**
+ * @brief Checks that cab calls stay with their car, and that the hall lights are shared by the cars and go off when
+ *        the car with the call serves it.
+ *
+ * @note Test TDISPATCH-3
+ *
+ * @return true if the calls and the lights are right.
+ */
+bool dispatcher_tests_check_calls_and_lights() {
+    Dispatcher dispatcher;
+    dispatcher_init(&dispatcher,
+                    DISPATCHER_TESTS_NUMBER_OF_FLOORS,
+                    2,
+                    DISPATCHER_TESTS_TRAVEL_TIME,
+                    DISPATCHER_TESTS_STOP_TIME);
+
+    dispatcher_update_car(&dispatcher, 0, (Position){.floor = 0, .offset = OFFSET_AT_FLOOR}, HARDWARE_MOVEMENT_STOP);
+    dispatcher_update_car(&dispatcher, 1, (Position){.floor = 3, .offset = OFFSET_AT_FLOOR}, HARDWARE_MOVEMENT_STOP);
+
+    const int car = dispatcher_assign_hall_call(&dispatcher, 2, HARDWARE_ORDER_DOWN);
+    if (car != 1 || dispatcher_assign_hall_call(&dispatcher, 2, HARDWARE_ORDER_DOWN) != car ||
+        !dispatcher_hall_light_is_on(&dispatcher, 2, HARDWARE_ORDER_DOWN) ||
+        dispatcher_hall_light_is_on(&dispatcher, 2, HARDWARE_ORDER_UP)) {
+        return false;
+    }
+
+    dispatcher_add_cab_call(&dispatcher, 1, 0);
+    if (dispatcher.cars[0].cab_calls[0] || !dispatcher.cars[1].cab_calls[0]) {
+        return false;
+    }
+
+    // The other car stopping at the floor does not serve the call
+    dispatcher_car_served_floor(&dispatcher, 0, 2);
+    if (!dispatcher_hall_light_is_on(&dispatcher, 2, HARDWARE_ORDER_DOWN)) {
+        return false;
+    }
+
+    dispatcher_car_served_floor(&dispatcher, car, 2);
+    dispatcher_car_served_floor(&dispatcher, car, 0);
+
+    return !dispatcher_hall_light_is_on(&dispatcher, 2, HARDWARE_ORDER_DOWN) &&
+           dispatcher_get_hall_call_car(&dispatcher, 2, HARDWARE_ORDER_DOWN) == DISPATCHER_NO_CAR &&
+           !dispatcher.cars[1].cab_calls[0];
+}
+
+/**
+ * @brief Checks that a car out of service gets no calls, even when it is the nearest, and that taking a car out of
+ *        service hands its hall calls to another car and drops its cab calls.
+ *
+ * @note Test TDISPATCH-4
+ *
+ * @return true if only the car in service got the calls.
+ */
+bool dispatcher_tests_check_car_out_of_service() {
+    Dispatcher dispatcher;
+    dispatcher_init(&dispatcher,
+                    DISPATCHER_TESTS_NUMBER_OF_FLOORS,
+                    2,
+                    DISPATCHER_TESTS_TRAVEL_TIME,
+                    DISPATCHER_TESTS_STOP_TIME);
+
+    dispatcher_update_car(&dispatcher, 0, (Position){.floor = 1, .offset = OFFSET_AT_FLOOR}, HARDWARE_MOVEMENT_STOP);
+    dispatcher_update_car(&dispatcher, 1, (Position){.floor = 3, .offset = OFFSET_AT_FLOOR}, HARDWARE_MOVEMENT_STOP);
+    dispatcher_set_car_in_service(&dispatcher, 0, false);
+
+    if (dispatcher_assign_hall_call(&dispatcher, 1, HARDWARE_ORDER_UP) != 1) {
+        return false;
+    }
+
+    dispatcher_set_car_in_service(&dispatcher, 0, true);
+    dispatcher_add_cab_call(&dispatcher, 0, 3);
+    if (dispatcher_assign_hall_call(&dispatcher, 0, HARDWARE_ORDER_UP) != 0) {
+        return false;
+    }
+
+    dispatcher_set_car_in_service(&dispatcher, 0, false);
+    if (!dispatcher_hall_light_is_on(&dispatcher, 0, HARDWARE_ORDER_UP) ||
+        dispatcher_get_hall_call_car(&dispatcher, 0, HARDWARE_ORDER_UP) != DISPATCHER_NO_CAR ||
+        dispatcher.cars[0].cab_calls[3]) {
+        return false;
+    }
+    dispatcher_assign_unassigned_hall_calls(&dispatcher);
+
+    return dispatcher_get_hall_call_car(&dispatcher, 0, HARDWARE_ORDER_UP) == 1 &&
+           dispatcher_get_hall_call_car(&dispatcher, 1, HARDWARE_ORDER_UP) == 1;
+}
+
+void dispatcher_tests_validate() {
+    printf("=========== Starting Dispatcher tests ===========\n\n");
+    printf("1. Test that a call goes to the nearest idle car\n");
+    assert(dispatcher_tests_check_nearest_idle_car());
+    printf("1. Passed\n");
+    printf("\n");
+
+    printf("2. Test that a car on the way is preferred over a car going away\n");
+    assert(dispatcher_tests_check_car_on_the_way());
+    printf("2. Passed\n");
+    printf("\n");
+
+    printf("3. Test that cab calls stay with their car and hall lights are shared\n");
+    assert(dispatcher_tests_check_calls_and_lights());
+    printf("3. Passed\n");
+    printf("\n");
+
+    printf("4. Test that a car out of service gets no calls and hands its hall calls over\n");
+    assert(dispatcher_tests_check_car_out_of_service());
+    printf("4. Passed\n");
+    printf("\n");
+
+    printf("================== Dispatcher test complete =================\n");
+
+    return;
+}
@@ -0,0 +1,15 @@
+/**
+ * @file 
+ * 
+ * @brief Tests for the group dispatcher. 
+ */
+
+#ifndef DISPATCHER_TESTS_H
+#define DISPATCHER_TESTS_H
+
+/**
+ * @brief Validates the result of all the tests of Dispatcher 
+ */
+void dispatcher_tests_validate();
+
+#endif
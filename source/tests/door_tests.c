@@ -10,9 +10,38 @@
 #include <time.h>
 #include <unistd.h>
 
+#include "clock.h"
 #include "door.h"
 #include "hardware.h"
+#include "hardware_backend.h"
 #include "test_util.h"
+#include "timer.h"
+
+/**
+ * @brief The hardware the door under test is commanded through, the linked driver.
+ */
+static HardwareBackend m_door_tests_hardware;
+
+/**
+ * @brief The timers closing the door under test.
+ */
+static TimerService m_door_tests_timers;
+
+/**
+ * @brief The door under test.
+ */
+static Door m_door_tests_door;
+
+/**
+ * @brief Updates the door under test with the obstruction signal of the hardware and expires its timers, at the
+ *        current time of the clock.
+ */
+static void door_tests_update() {
+    const uint64_t now_ms = clock_now_ms();
+
+    door_update(&m_door_tests_door, hardware_read_obstruction_signal(), now_ms);
+    timer_expire(&m_door_tests_timers, now_ms);
+}
 
 /**
  * @brief Will check if the door does not close when there is an obstruction. 
@@ -27,15 +56,15 @@ static bool door_tests_check_keeps_open_while_obstruction() {
 
     printf("Enable obstruction now please. Will open door and try to close for %f seconds. Press enter to continue...\n", duration_to_check);
     test_util_wait_until_enter_key_is_pressed();
-    door_request_open_and_autoclose();
+    door_request_open_and_autoclose(&m_door_tests_door, clock_now_ms());
 
     const time_t start_time = time(NULL);
     bool door_open = false;
 
     while (time(NULL) - start_time <= duration_to_check) {
-        door_update();
+        door_tests_update();
 
-        door_open = door_is_open();
+        door_open = door_is_open(&m_door_tests_door);
 
         if (!door_open) {
             break;
@@ -64,16 +93,16 @@ static bool door_tests_check_closes_when_no_obstruction() {
     printf("Disable obstruction now please. Will open door and try to autoclose. Press enter to continue...\n");
     test_util_wait_until_enter_key_is_pressed();
 
-    door_request_open_and_autoclose();
+    door_request_open_and_autoclose(&m_door_tests_door, clock_now_ms());
 
     const time_t start_time = time(NULL);
 
     while (time(NULL) - start_time <= duration_to_check) {
-        door_update();
+        door_tests_update();
         sleep(1);
     }
 
-    return !door_is_open();
+    return !door_is_open(&m_door_tests_door);
 }
 
 /**
@@ -87,10 +116,10 @@ static void door_tests_check_timer_reset() {
 
     printf("Enable obstruction now please. Will open door and try to autoclose. Disable obstruction signal when ready and count the seconds it takes for the door to close. Press enter to continue...\n");
     test_util_wait_until_enter_key_is_pressed();
-    door_request_open_and_autoclose();
+    door_request_open_and_autoclose(&m_door_tests_door, clock_now_ms());
 
-    while (door_is_open()) {
-        door_update();
+    while (door_is_open(&m_door_tests_door)) {
+        door_tests_update();
         sleep(1);
     }
 }
@@ -108,30 +137,110 @@ static bool door_tests_check_door_is_open_function() {
     printf("Disable obstruction please. Will open door and try to autoclose. Press enter to continue...\n");
     test_util_wait_until_enter_key_is_pressed();
 
-    door_request_open_and_autoclose();
-    const bool door_opened = door_is_open();
+    door_request_open_and_autoclose(&m_door_tests_door, clock_now_ms());
+    const bool door_opened = door_is_open(&m_door_tests_door);
 
     const time_t start_time = time(NULL);
 
     while (time(NULL) - start_time <= duration_to_check) {
-        door_update();
+        door_tests_update();
         sleep(1);
     }
 
-    const bool door_closed = !door_is_open();
+    const bool door_closed = !door_is_open(&m_door_tests_door);
 
     return door_opened && door_closed;
 }
 
+/**
+ * @brief Checks if the door closes after exactly #DOOR_OPEN_TIME_INTERVAL on the virtual clock, without waiting for it
+ *        in real time.
+ *
+ * @note Test TDOOR-8
+ *
+ * @return True if the door stayed open until the interval had passed and closed after it, false if not.
+ */
+static bool door_tests_check_closes_on_virtual_clock() {
+    const uint64_t interval_ms = DOOR_OPEN_TIME_INTERVAL * 1000;
+
+    printf("Disable obstruction please. Will open door and close it on the virtual clock. Press enter to continue...\n");
+    test_util_wait_until_enter_key_is_pressed();
+
+    clock_set_source(CLOCK_SOURCE_VIRTUAL);
+    door_request_open_and_autoclose(&m_door_tests_door, clock_now_ms());
+
+    clock_advance_ms(interval_ms - 1);
+    door_tests_update();
+    const bool door_open_before_interval = door_is_open(&m_door_tests_door);
+
+    clock_advance_ms(1);
+    door_tests_update();
+    const bool door_closed_after_interval = !door_is_open(&m_door_tests_door);
+
+    clock_set_source(CLOCK_SOURCE_REAL);
+
+    return door_open_before_interval && door_closed_after_interval;
+}
+
+/**
+ * @brief Opens the door at @p p_context, used as the backend of the doors in
+ *        #door_tests_check_doors_are_independent.
+ *
+ * @param[in, out] p_context Whether the door is open, a bool.
+ * @param[in] door_open Whether to open the door.
+ */
+static void door_tests_command_door_open(void* p_context, const bool door_open) {
+    *(bool*)p_context = door_open;
+}
+
+/**
+ * @brief Checks if two doors, each with their own timers and hardware, open and close independently of each other.
+ *
+ * @note Test TDOOR-9
+ *
+ * @return True if each door closed #DOOR_OPEN_TIME_INTERVAL after it was opened, false if not.
+ */
+static bool door_tests_check_doors_are_independent() {
+    const uint64_t interval_ms = DOOR_OPEN_TIME_INTERVAL * 1000;
+    const HardwareBackendOperations operations = {.command_door_open = door_tests_command_door_open};
+
+    bool hardware_door_open[2] = {false, false};
+    HardwareBackend hardware[2];
+    TimerService timers[2];
+    Door doors[2];
+
+    for (int i = 0; i < 2; i++) {
+        hardware[i] = (HardwareBackend){&operations, &hardware_door_open[i], HARDWARE_DEFAULT_NUMBER_OF_FLOORS, NULL};
+        timer_service_init(&timers[i]);
+        door_init(&doors[i], &hardware[i], &timers[i]);
+    }
+
+    // The second door lives on a time base one interval ahead of the first, and is opened half an interval later
+    door_request_open_and_autoclose(&doors[0], 0);
+    door_request_open_and_autoclose(&doors[1], interval_ms + interval_ms / 2);
+
+    timer_expire(&timers[0], interval_ms);
+    timer_expire(&timers[1], 2 * interval_ms);
+    const bool first_closed_alone = !door_is_open(&doors[0]) && !hardware_door_open[0] && door_is_open(&doors[1]) &&
+                                    hardware_door_open[1];
+
+    timer_expire(&timers[1], 2 * interval_ms + interval_ms / 2);
+    const bool second_closed = !door_is_open(&doors[1]) && !hardware_door_open[1];
+
+    return first_closed_alone && second_closed;
+}
+
 void door_tests_validate() {
     printf("=========== Starting door tests ===========\n\n");
+
+    m_door_tests_hardware = hardware_backend_driver();
+    timer_service_init(&m_door_tests_timers);
+    door_init(&m_door_tests_door, &m_door_tests_hardware, &m_door_tests_timers);
+
     printf("Moving elevator to floor...\n\n");
 
     while (1) {
-        if (hardware_read_floor_sensor(0) ||
-            hardware_read_floor_sensor(1) ||
-            hardware_read_floor_sensor(2) ||
-            hardware_read_floor_sensor(3)) {
+        if (hardware_read_current_floor() != -1) {
             hardware_command_movement(HARDWARE_MOVEMENT_STOP);
             break;
         } else {
@@ -154,5 +263,13 @@ void door_tests_validate() {
     printf("4. Will check if the function for whether the door is open returns the right value for one call to open and close door (TDOOR-7).\n");
     assert(door_tests_check_door_is_open_function());
     printf("4. Passed\n\n");
+
+    printf("5. Check if the door closes after the time interval on the virtual clock (TDOOR-8)\n");
+    assert(door_tests_check_closes_on_virtual_clock());
+    printf("5. Passed\n\n");
+
+    printf("6. Check if two doors open and close independently (TDOOR-9)\n");
+    assert(door_tests_check_doors_are_independent());
+    printf("6. Passed\n\n");
     printf("=========== Door tests passed ===========\n\n");
 }
@@ -0,0 +1,142 @@
+/**
+ * @file 
+ * 
+ * @brief Implementation of the event log tests module.
+ */
+
+#include "event_log_tests.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "event_log.h"
+
+/**
+ * @brief File the log under test is written to.
+ */
+#define EVENT_LOG_TESTS_PATH "/tmp/elevator_event_log_tests.bin"
+
+/**
+ * @brief The log under test, too large for the stack of a test.
+ */
+static EventLog m_event_log_tests_log;
+
+/**
+ * @brief Records read back from the file of the log under test.
+ */
+static EventRecord m_event_log_tests_records[EVENT_LOG_CAPACITY];
+
+/**
+ * @brief Writes the log under test to #EVENT_LOG_TESTS_PATH and reads it back.
+ *
+ * @param[out] p_header The header of the file.
+ *
+ * @return true if the file was written and has a valid header, with the records in #m_event_log_tests_records.
+ */
+static bool event_log_tests_flush_and_read(EventLogFileHeader* p_header) {
+    if (event_log_flush(&m_event_log_tests_log, EVENT_LOG_TESTS_PATH) != 0) {
+        return false;
+    }
+
+    FILE* p_file = fopen(EVENT_LOG_TESTS_PATH, "rb");
+    if (!p_file) {
+        return false;
+    }
+
+    const bool is_valid = fread(p_header, sizeof(*p_header), 1, p_file) == 1 &&
+                          memcmp(p_header->magic, EVENT_LOG_FILE_MAGIC, sizeof(p_header->magic)) == 0 &&
+                          p_header->record_size == sizeof(EventRecord) &&
+                          p_header->number_of_records <= EVENT_LOG_CAPACITY &&
+                          fread(m_event_log_tests_records, sizeof(EventRecord), p_header->number_of_records, p_file) ==
+                              p_header->number_of_records &&
+                          fgetc(p_file) == EOF;
+
+    fclose(p_file);
+    unlink(EVENT_LOG_TESTS_PATH);
+
+    return is_valid;
+}
+
+/**
+ * @brief Checks that records come back from the file in order, and that an output commanded to the same value again
+ *        is only recorded once.
+ *
+ * @note Test TEVENTLOG-1
+ *
+ * @return true if the file holds the records.
+ */
+bool event_log_tests_check_flush() {
+    event_log_init(&m_event_log_tests_log);
+
+    event_log_record(&m_event_log_tests_log, EVENT_TYPE_ORDER_ADD, 2, 1);
+    event_log_record_if_changed(&m_event_log_tests_log, EVENT_TYPE_DOOR, 1);
+    event_log_record_if_changed(&m_event_log_tests_log, EVENT_TYPE_DOOR, 1);
+    event_log_record_if_changed(&m_event_log_tests_log, EVENT_TYPE_DOOR, 0);
+    event_log_record(NULL, EVENT_TYPE_ORDER_POP, 2, 1);
+
+    EventLogFileHeader header;
+    if (!event_log_tests_flush_and_read(&header) || header.number_of_records != 3 ||
+        header.number_of_lost_records != 0) {
+        return false;
+    }
+
+    const EventRecord* p_records = m_event_log_tests_records;
+    return p_records[0].type == EVENT_TYPE_ORDER_ADD && p_records[0].arguments[0] == 2 &&
+           p_records[0].arguments[1] == 1 && p_records[1].type == EVENT_TYPE_DOOR && p_records[1].arguments[0] == 1 &&
+           p_records[2].type == EVENT_TYPE_DOOR && p_records[2].arguments[0] == 0 &&
+           p_records[0].timestamp_ns <= p_records[1].timestamp_ns &&
+           p_records[1].timestamp_ns <= p_records[2].timestamp_ns;
+}
+
+/**
+ * @brief Checks that a full log keeps the most recent records, oldest first, and counts the ones it overwrote.
+ *
+ * @note Test TEVENTLOG-2
+ *
+ * @return true if the file holds the most recent records.
+ */
+bool event_log_tests_check_overwrite() {
+    event_log_init(&m_event_log_tests_log);
+
+    const int number_of_records = EVENT_LOG_CAPACITY + EVENT_LOG_CAPACITY / 2;
+    for (int i = 0; i < number_of_records; i++) {
+        event_log_record(&m_event_log_tests_log, EVENT_TYPE_ORDER_ADD, i % 1000, i / 1000);
+    }
+
+    EventLogFileHeader header;
+    if (!event_log_tests_flush_and_read(&header) ||
+        header.number_of_records + header.number_of_lost_records != (uint64_t)number_of_records ||
+        header.number_of_records < EVENT_LOG_CAPACITY - 1) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < header.number_of_records; i++) {
+        const int expected = (int)(header.number_of_lost_records + i);
+        const EventRecord* p_record = &m_event_log_tests_records[i];
+        if (p_record->arguments[0] != expected % 1000 || p_record->arguments[1] != expected / 1000) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void event_log_tests_validate() {
+    printf("=========== Starting Event log tests ===========\n\n");
+    printf("1. Test that records are written to the file in order\n");
+    assert(event_log_tests_check_flush());
+    printf("1. Passed\n");
+    printf("\n");
+
+    printf("2. Test that a full log keeps the most recent records\n");
+    assert(event_log_tests_check_overwrite());
+    printf("2. Passed\n");
+    printf("\n");
+
+    printf("================== Event log test complete =================\n");
+
+    return;
+}
@@ -0,0 +1,15 @@
+/**
+ * @file
+ * 
+ * @brief Tests for the event log.
+ */
+
+#ifndef EVENT_LOG_TESTS_H
+#define EVENT_LOG_TESTS_H
+
+/**
+ * @brief Validates the result of all the tests of EventLog
+ */
+void event_log_tests_validate();
+
+#endif
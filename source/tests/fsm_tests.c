@@ -0,0 +1,288 @@
+/**
+ * @file 
+ * 
+ * @brief Implementation of the FSM tests module.
+ */
+
+#include "fsm_tests.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "fsm.h"
+#include "hardware_backend.h"
+
+/**
+ * @brief Floors of the building in the tests.
+ */
+#define FSM_TESTS_NUMBER_OF_FLOORS 6
+
+/**
+ * @brief Milliseconds between two steps of the elevator under test.
+ */
+#define FSM_TESTS_STEP_PERIOD_MS 10
+
+/**
+ * @brief The outputs of the hardware of the elevator under test.
+ */
+typedef struct {
+    /**
+     * @brief The last movement commanded.
+     */
+    HardwareMovement movement;
+
+    /**
+     * @brief Whether the door is open.
+     */
+    bool door_open;
+
+    /**
+     * @brief Whether the elevator has been commanded upwards since this was last cleared.
+     */
+    bool has_moved_up;
+} FsmTestsHardware;
+
+/**
+ * @brief Records the movement commanded at @p p_context.
+ *
+ * @param[in, out] p_context The #FsmTestsHardware.
+ * @param[in] movement The movement.
+ */
+static void fsm_tests_command_movement(void* p_context, const HardwareMovement movement) {
+    FsmTestsHardware* p_hardware = p_context;
+
+    p_hardware->movement = movement;
+    p_hardware->has_moved_up = p_hardware->has_moved_up || movement == HARDWARE_MOVEMENT_UP;
+}
+
+/**
+ * @brief Ignores an order light.
+ */
+static void fsm_tests_command_order_light(void* p_context,
+                                          const int floor,
+                                          const HardwareOrder order_type,
+                                          const bool on) {
+    (void)(p_context);
+    (void)(floor);
+    (void)(order_type);
+    (void)(on);
+}
+
+/**
+ * @brief Ignores the floor indicator.
+ */
+static void fsm_tests_command_floor_indicator_on(void* p_context, const int floor) {
+    (void)(p_context);
+    (void)(floor);
+}
+
+/**
+ * @brief Records the door commanded at @p p_context.
+ *
+ * @param[in, out] p_context The #FsmTestsHardware.
+ * @param[in] door_open Whether to open the door.
+ */
+static void fsm_tests_command_door_open(void* p_context, const bool door_open) {
+    ((FsmTestsHardware*)p_context)->door_open = door_open;
+}
+
+/**
+ * @brief Ignores the stop light.
+ */
+static void fsm_tests_command_stop_light(void* p_context, const bool on) {
+    (void)(p_context);
+    (void)(on);
+}
+
+/**
+ * @brief The operations of the hardware of the elevator under test.
+ */
+static const HardwareBackendOperations m_fsm_tests_operations = {
+    .command_movement = fsm_tests_command_movement,
+    .command_order_light = fsm_tests_command_order_light,
+    .command_floor_indicator_on = fsm_tests_command_floor_indicator_on,
+    .command_door_open = fsm_tests_command_door_open,
+    .command_stop_light = fsm_tests_command_stop_light,
+};
+
+/**
+ * @brief Steps @p p_elevator once with the elevator at @p floor, only the cab button of @p cab_call_floor pressed,
+ *        and the stop button as given, one step period after the previous step.
+ *
+ * @param[in, out] p_elevator The elevator.
+ * @param[in] floor The floor the elevator is at, -1 if it is between floors.
+ * @param[in] cab_call_floor The floor of the pressed cab button, -1 for none.
+ * @param[in] stop_signal Whether the stop button is pressed.
+ * @param[in, out] p_now_ms The time of the previous step, advanced to the time of this step.
+ */
+static void fsm_tests_step_with_stop(Elevator* p_elevator,
+                                     const int floor,
+                                     const int cab_call_floor,
+                                     const bool stop_signal,
+                                     uint64_t* p_now_ms) {
+    HardwareSnapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.floor = floor;
+    snapshot.stop_signal = stop_signal;
+
+    if (cab_call_floor >= 0) {
+        snapshot.orders[HARDWARE_ORDER_WORD(cab_call_floor, HARDWARE_ORDER_INSIDE)] |=
+            HARDWARE_ORDER_BIT(cab_call_floor, HARDWARE_ORDER_INSIDE);
+    }
+
+    *p_now_ms += FSM_TESTS_STEP_PERIOD_MS;
+    fsm_step(p_elevator, &snapshot, *p_now_ms);
+}
+
+/**
+ * @brief Steps @p p_elevator once with the elevator at @p floor and only the cab button of @p cab_call_floor
+ *        pressed, one step period after the previous step.
+ *
+ * @param[in, out] p_elevator The elevator.
+ * @param[in] floor The floor the elevator is at, -1 if it is between floors.
+ * @param[in] cab_call_floor The floor of the pressed cab button, -1 for none.
+ * @param[in, out] p_now_ms The time of the previous step, advanced to the time of this step.
+ */
+static void fsm_tests_step(Elevator* p_elevator, const int floor, const int cab_call_floor, uint64_t* p_now_ms) {
+    fsm_tests_step_with_stop(p_elevator, floor, cab_call_floor, false, p_now_ms);
+}
+
+/**
+ * @brief Sets up @p p_elevator on the hardware at @p p_hardware, and steps it until it is idle at @p floor.
+ *
+ * @param[out] p_elevator The elevator.
+ * @param[out] p_hardware The hardware of the elevator.
+ * @param[in] floor The floor.
+ * @param[in, out] p_now_ms The time of the previous step, advanced to the time of the last step.
+ */
+static void fsm_tests_start_idle(Elevator* p_elevator,
+                                 FsmTestsHardware* p_hardware,
+                                 const int floor,
+                                 uint64_t* p_now_ms) {
+    *p_hardware = (FsmTestsHardware){HARDWARE_MOVEMENT_STOP, false, false};
+
+    const HardwareBackend backend = {&m_fsm_tests_operations, p_hardware, FSM_TESTS_NUMBER_OF_FLOORS, NULL};
+    fsm_init(p_elevator, &backend);
+
+    while (p_elevator->current_state != STATE_IDLE) {
+        fsm_tests_step(p_elevator, floor, -1, p_now_ms);
+    }
+}
+
+/**
+ * @brief Checks that an order at the floor of an idle elevator opens the door, without the elevator moving.
+ *
+ * @note Test TFSM-1
+ *
+ * @return true if the door opened and the elevator stayed put.
+ */
+bool fsm_tests_check_order_at_idle_floor_opens_door() {
+    const int floor = 2;
+    Elevator elevator;
+    FsmTestsHardware hardware;
+    uint64_t now_ms = 0;
+
+    fsm_tests_start_idle(&elevator, &hardware, floor, &now_ms);
+
+    fsm_tests_step(&elevator, floor, floor, &now_ms);
+    fsm_tests_step(&elevator, floor, floor, &now_ms);
+
+    const bool result = elevator.current_state == STATE_DOOR_OPEN && hardware.door_open && !hardware.has_moved_up &&
+                        hardware.movement == HARDWARE_MOVEMENT_STOP &&
+                        priority_queue_is_empty(elevator.p_priority_queue);
+
+    fsm_deinit(&elevator);
+    return result;
+}
+
+/**
+ * @brief Checks that a moving elevator turns around for a new top order behind it. The elevator is on its way up from
+ *        the first floor to the fifth, and the cab button of the third floor is pressed just as it passes the third
+ *        floor. The order takes the top spot, and is behind the elevator once it has left the floor.
+ *
+ * @note Test TFSM-2
+ *
+ * @return true if the elevator went back down to the order and opened the door there.
+ */
+bool fsm_tests_check_top_order_behind_reverses() {
+    Elevator elevator;
+    FsmTestsHardware hardware;
+    uint64_t now_ms = 0;
+
+    fsm_tests_start_idle(&elevator, &hardware, 1, &now_ms);
+
+    fsm_tests_step(&elevator, 1, 5, &now_ms);
+    fsm_tests_step(&elevator, 1, 5, &now_ms);
+    bool result = elevator.current_state == STATE_MOVE && hardware.movement == HARDWARE_MOVEMENT_UP;
+
+    fsm_tests_step(&elevator, -1, -1, &now_ms);
+    fsm_tests_step(&elevator, 2, -1, &now_ms);
+    fsm_tests_step(&elevator, -1, -1, &now_ms);
+    fsm_tests_step(&elevator, 3, 3, &now_ms);
+    result = result && elevator.current_state == STATE_MOVE && elevator.p_priority_queue->floor == 3;
+
+    fsm_tests_step(&elevator, -1, -1, &now_ms);
+    result = result && elevator.current_state == STATE_MOVE && hardware.movement == HARDWARE_MOVEMENT_DOWN;
+
+    fsm_tests_step(&elevator, 3, -1, &now_ms);
+    fsm_tests_step(&elevator, 3, -1, &now_ms);
+    result = result && elevator.current_state == STATE_DOOR_OPEN && hardware.door_open &&
+             hardware.movement == HARDWARE_MOVEMENT_STOP;
+
+    fsm_deinit(&elevator);
+    return result;
+}
+
+/**
+ * @brief Checks that a cab button held down through a stop is taken as a new order once the stop is over. The order
+ *        of the button is dropped by the stop, like every other order.
+ *
+ * @note Test TFSM-3
+ *
+ * @return true if the order was taken again after the stop.
+ */
+bool fsm_tests_check_button_held_through_stop_is_new_order() {
+    Elevator elevator;
+    FsmTestsHardware hardware;
+    uint64_t now_ms = 0;
+
+    fsm_tests_start_idle(&elevator, &hardware, 1, &now_ms);
+
+    fsm_tests_step(&elevator, 1, 4, &now_ms);
+    bool result = !priority_queue_is_empty(elevator.p_priority_queue);
+
+    fsm_tests_step_with_stop(&elevator, 1, 4, true, &now_ms);
+    fsm_tests_step_with_stop(&elevator, 1, 4, true, &now_ms);
+    result = result && elevator.current_state == STATE_STOP && priority_queue_is_empty(elevator.p_priority_queue);
+
+    fsm_tests_step(&elevator, 1, 4, &now_ms);
+    fsm_tests_step(&elevator, 1, 4, &now_ms);
+    result = result && elevator.current_state != STATE_STOP && !priority_queue_is_empty(elevator.p_priority_queue) &&
+             elevator.p_priority_queue->floor == 4;
+
+    fsm_deinit(&elevator);
+    return result;
+}
+
+void fsm_tests_validate() {
+    printf("=========== Starting FSM tests ===========\n\n");
+    printf("1. Test that an order at the floor of an idle elevator opens the door\n");
+    assert(fsm_tests_check_order_at_idle_floor_opens_door());
+    printf("1. Passed\n");
+    printf("\n");
+
+    printf("2. Test that a moving elevator turns around for a new top order behind it\n");
+    assert(fsm_tests_check_top_order_behind_reverses());
+    printf("2. Passed\n");
+    printf("\n");
+
+    printf("3. Test that a cab button held down through a stop is a new order after the stop\n");
+    assert(fsm_tests_check_button_held_through_stop_is_new_order());
+    printf("3. Passed\n");
+    printf("\n");
+
+    printf("================== FSM test complete =================\n");
+
+    return;
+}
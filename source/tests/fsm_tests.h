@@ -0,0 +1,15 @@
+/**
+ * @file 
+ * 
+ * @brief Tests for the finite state machine. 
+ */
+
+#ifndef FSM_TESTS_H
+#define FSM_TESTS_H
+
+/**
+ * @brief Validates the result of all the tests of the FSM 
+ */
+void fsm_tests_validate();
+
+#endif
@@ -0,0 +1,506 @@
+/**
+ * @file 
+ * 
+ * @brief Implementation of the group tests module.
+ */
+
+#include "group_tests.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "group.h"
+
+/**
+ * @brief Floors of the building in the tests.
+ */
+#define GROUP_TESTS_NUMBER_OF_FLOORS 6
+
+/**
+ * @brief Cars in the group in the tests.
+ */
+#define GROUP_TESTS_NUMBER_OF_CARS 3
+
+/**
+ * @brief Steps a car takes to travel from one floor to the next.
+ */
+#define GROUP_TESTS_STEPS_PER_FLOOR 4
+
+/**
+ * @brief Milliseconds between two steps.
+ */
+#define GROUP_TESTS_STEP_PERIOD_MS 100
+
+/**
+ * @brief Most steps a test runs for, long enough for every car to serve its calls and close its door.
+ */
+#define GROUP_TESTS_MAX_NUMBER_OF_STEPS 1000
+
+/**
+ * @brief A simulated car, moving one step of #GROUP_TESTS_STEPS_PER_FLOOR per step.
+ */
+typedef struct {
+    /**
+     * @brief Position of the car in steps from the bottom floor.
+     */
+    int height;
+
+    HardwareMovement movement;
+    bool door_open;
+
+    /**
+     * @brief Whether the car has moved since it was set up.
+     */
+    bool has_moved;
+
+    /**
+     * @brief Whether the door has opened at each floor since the car was set up.
+     */
+    bool has_opened_door_at[GROUP_TESTS_NUMBER_OF_FLOORS];
+
+    /**
+     * @brief The order lights of the car, laid out like @c HardwareSnapshot::orders.
+     */
+    uint64_t lights[HARDWARE_NUMBER_OF_ORDER_WORDS];
+
+    /**
+     * @brief The buttons pressed on the panels of the car, released after every step.
+     */
+    uint64_t pressed_buttons[HARDWARE_NUMBER_OF_ORDER_WORDS];
+
+    /**
+     * @brief Whether the stop button of the car is pressed, released after every step.
+     */
+    bool stop_button;
+} GroupTestsCar;
+
+/**
+ * @brief The cars under test.
+ */
+static GroupTestsCar m_group_tests_cars[GROUP_TESTS_NUMBER_OF_CARS];
+
+/**
+ * @brief The group under test.
+ */
+static Group m_group_tests_group;
+
+/**
+ * @brief Time of the last step.
+ */
+static uint64_t m_group_tests_now_ms;
+
+/**
+ * @brief Gets the floor sensor of @p p_car.
+ *
+ * @param[in] p_car The car.
+ *
+ * @return The floor the car is at, -1 if it is between floors.
+ */
+static int group_tests_floor(const GroupTestsCar* p_car) {
+    return p_car->height % GROUP_TESTS_STEPS_PER_FLOOR == 0 ? p_car->height / GROUP_TESTS_STEPS_PER_FLOOR : -1;
+}
+
+/**
+ * @brief Checks if a light of @p p_car is on.
+ *
+ * @param[in] p_car The car.
+ * @param[in] floor Floor of the light.
+ * @param[in] order_type Type of the light.
+ *
+ * @return true if the light is on.
+ */
+static bool group_tests_light_is_on(const GroupTestsCar* p_car, const int floor, const HardwareOrder order_type) {
+    return (p_car->lights[HARDWARE_ORDER_WORD(floor, order_type)] & HARDWARE_ORDER_BIT(floor, order_type)) != 0;
+}
+
+/**
+ * @brief Records the movement commanded at @p p_context.
+ *
+ * @param[in, out] p_context The #GroupTestsCar.
+ * @param[in] movement The movement.
+ */
+static void group_tests_command_movement(void* p_context, const HardwareMovement movement) {
+    ((GroupTestsCar*)p_context)->movement = movement;
+}
+
+/**
+ * @brief Records the order light commanded at @p p_context.
+ *
+ * @param[in, out] p_context The #GroupTestsCar.
+ * @param[in] floor Floor of the light.
+ * @param[in] order_type Type of the light.
+ * @param[in] on Whether to turn the light on.
+ */
+static void group_tests_command_order_light(void* p_context,
+                                            const int floor,
+                                            const HardwareOrder order_type,
+                                            const bool on) {
+    GroupTestsCar* p_car = p_context;
+    const int word = HARDWARE_ORDER_WORD(floor, order_type);
+    const uint64_t bit = HARDWARE_ORDER_BIT(floor, order_type);
+
+    p_car->lights[word] = on ? p_car->lights[word] | bit : p_car->lights[word] & ~bit;
+}
+
+/**
+ * @brief Ignores the floor indicator.
+ */
+static void group_tests_command_floor_indicator_on(void* p_context, const int floor) {
+    (void)(p_context);
+    (void)(floor);
+}
+
+/**
+ * @brief Records the door commanded at @p p_context, and the floor it opened at.
+ *
+ * @param[in, out] p_context The #GroupTestsCar.
+ * @param[in] door_open Whether to open the door.
+ */
+static void group_tests_command_door_open(void* p_context, const bool door_open) {
+    GroupTestsCar* p_car = p_context;
+    const int floor = group_tests_floor(p_car);
+
+    p_car->door_open = door_open;
+    if (door_open && floor >= 0) {
+        p_car->has_opened_door_at[floor] = true;
+    }
+}
+
+/**
+ * @brief Ignores the stop light.
+ */
+static void group_tests_command_stop_light(void* p_context, const bool on) {
+    (void)(p_context);
+    (void)(on);
+}
+
+/**
+ * @brief The operations of the hardware of the cars under test.
+ */
+static const HardwareBackendOperations m_group_tests_operations = {
+    .command_movement = group_tests_command_movement,
+    .command_order_light = group_tests_command_order_light,
+    .command_floor_indicator_on = group_tests_command_floor_indicator_on,
+    .command_door_open = group_tests_command_door_open,
+    .command_stop_light = group_tests_command_stop_light,
+};
+
+/**
+ * @brief Sets up the group under test with its cars idle at @p p_floors, one floor per car.
+ *
+ * @param[in] p_floors The floor of each car.
+ */
+static void group_tests_start(const int* p_floors) {
+    HardwareBackend hardware[GROUP_TESTS_NUMBER_OF_CARS];
+
+    for (int car = 0; car < GROUP_TESTS_NUMBER_OF_CARS; car++) {
+        memset(&m_group_tests_cars[car], 0, sizeof(m_group_tests_cars[car]));
+        m_group_tests_cars[car].height = p_floors[car] * GROUP_TESTS_STEPS_PER_FLOOR;
+        m_group_tests_cars[car].movement = HARDWARE_MOVEMENT_STOP;
+
+        hardware[car] = (HardwareBackend){
+            &m_group_tests_operations, &m_group_tests_cars[car], GROUP_TESTS_NUMBER_OF_FLOORS, NULL};
+    }
+
+    group_init(&m_group_tests_group, hardware, GROUP_TESTS_NUMBER_OF_CARS, 1.0, 3.0);
+    m_group_tests_now_ms = 0;
+}
+
+/**
+ * @brief Presses a button on the panels of @p car, for the next step.
+ *
+ * @param[in] car The car.
+ * @param[in] floor Floor of the button.
+ * @param[in] order_type Type of the button.
+ */
+static void group_tests_press(const int car, const int floor, const HardwareOrder order_type) {
+    m_group_tests_cars[car].pressed_buttons[HARDWARE_ORDER_WORD(floor, order_type)] |=
+        HARDWARE_ORDER_BIT(floor, order_type);
+}
+
+/**
+ * @brief Steps the group under test once, and then moves every car by its movement.
+ *
+ * @return true if the hall lights of every car match the hall calls of the dispatcher, and no car has left the
+ *         building.
+ */
+static bool group_tests_step() {
+    HardwareSnapshot inputs[GROUP_TESTS_NUMBER_OF_CARS];
+
+    for (int car = 0; car < GROUP_TESTS_NUMBER_OF_CARS; car++) {
+        GroupTestsCar* p_car = &m_group_tests_cars[car];
+
+        memset(&inputs[car], 0, sizeof(inputs[car]));
+        memcpy(inputs[car].orders, p_car->pressed_buttons, sizeof(inputs[car].orders));
+        memset(p_car->pressed_buttons, 0, sizeof(p_car->pressed_buttons));
+        inputs[car].floor = group_tests_floor(p_car);
+        inputs[car].stop_signal = p_car->stop_button;
+        p_car->stop_button = false;
+    }
+
+    m_group_tests_now_ms += GROUP_TESTS_STEP_PERIOD_MS;
+    group_step(&m_group_tests_group, inputs, m_group_tests_now_ms);
+
+    const Dispatcher* p_dispatcher = &m_group_tests_group.dispatcher;
+    bool result = true;
+    for (int car = 0; car < GROUP_TESTS_NUMBER_OF_CARS; car++) {
+        GroupTestsCar* p_car = &m_group_tests_cars[car];
+
+        for (int floor = 0; floor < GROUP_TESTS_NUMBER_OF_FLOORS; floor++) {
+            result = result && group_tests_light_is_on(p_car, floor, HARDWARE_ORDER_UP) ==
+                                   dispatcher_hall_light_is_on(p_dispatcher, floor, HARDWARE_ORDER_UP);
+            result = result && group_tests_light_is_on(p_car, floor, HARDWARE_ORDER_DOWN) ==
+                                   dispatcher_hall_light_is_on(p_dispatcher, floor, HARDWARE_ORDER_DOWN);
+        }
+
+        if (p_car->movement != HARDWARE_MOVEMENT_STOP) {
+            p_car->has_moved = true;
+            p_car->height += p_car->movement == HARDWARE_MOVEMENT_UP ? 1 : -1;
+        }
+        result = result && p_car->height >= 0 &&
+                 p_car->height <= (GROUP_TESTS_NUMBER_OF_FLOORS - 1) * GROUP_TESTS_STEPS_PER_FLOOR;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Steps the group under test until every car is idle with its door closed and no hall call is left.
+ *
+ * @return true if the group got there, and every step was right, see #group_tests_step.
+ */
+static bool group_tests_run_until_idle() {
+    const Dispatcher* p_dispatcher = &m_group_tests_group.dispatcher;
+    bool result = true;
+
+    for (int step = 0; step < GROUP_TESTS_MAX_NUMBER_OF_STEPS; step++) {
+        result = result && group_tests_step();
+
+        bool is_idle = true;
+        for (int car = 0; car < GROUP_TESTS_NUMBER_OF_CARS; car++) {
+            is_idle = is_idle && m_group_tests_group.cars[car].elevator.current_state == STATE_IDLE &&
+                      !m_group_tests_cars[car].door_open;
+        }
+        for (int floor = 0; floor < GROUP_TESTS_NUMBER_OF_FLOORS; floor++) {
+            is_idle = is_idle && !dispatcher_hall_light_is_on(p_dispatcher, floor, HARDWARE_ORDER_UP) &&
+                      !dispatcher_hall_light_is_on(p_dispatcher, floor, HARDWARE_ORDER_DOWN);
+        }
+
+        if (is_idle) {
+            return result;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Checks that a hall call goes to the nearest car, which serves it, while a cab call is served by the car it
+ *        was made in. The hall call is made on the panel of another car, and its light is lit on every car until
+ *        served. The third car is never asked to move.
+ *
+ * @note Test TGROUP-1
+ *
+ * @return true if every call was served by the expected car.
+ */
+bool group_tests_check_hall_call_goes_to_nearest_car() {
+    group_tests_start((const int[]) {0, 2, 5});
+    bool result = group_tests_run_until_idle();
+
+    group_tests_press(0, 4, HARDWARE_ORDER_DOWN);
+    group_tests_press(0, 1, HARDWARE_ORDER_INSIDE);
+    result = result && group_tests_step();
+
+    result = result && dispatcher_get_hall_call_car(&m_group_tests_group.dispatcher, 4, HARDWARE_ORDER_DOWN) == 2;
+    for (int car = 0; car < GROUP_TESTS_NUMBER_OF_CARS; car++) {
+        result = result && group_tests_light_is_on(&m_group_tests_cars[car], 4, HARDWARE_ORDER_DOWN) &&
+                 group_tests_light_is_on(&m_group_tests_cars[car], 1, HARDWARE_ORDER_INSIDE) == (car == 0);
+    }
+
+    result = result && group_tests_run_until_idle();
+
+    result = result && m_group_tests_cars[2].has_opened_door_at[4] && group_tests_floor(&m_group_tests_cars[2]) == 4;
+    result = result && m_group_tests_cars[0].has_opened_door_at[1] && group_tests_floor(&m_group_tests_cars[0]) == 1;
+    result = result && !m_group_tests_cars[1].has_moved && !m_group_tests_cars[0].has_opened_door_at[4];
+    for (int car = 0; car < GROUP_TESTS_NUMBER_OF_CARS; car++) {
+        result = result && !group_tests_light_is_on(&m_group_tests_cars[car], 4, HARDWARE_ORDER_DOWN) &&
+                 !group_tests_light_is_on(&m_group_tests_cars[car], 1, HARDWARE_ORDER_INSIDE);
+    }
+
+    group_deinit(&m_group_tests_group);
+    return result;
+}
+
+/**
+ * @brief Checks that calls at both ends of the building are shared between the cars, each served by the car nearest
+ *        to it, while the car in the middle stays put.
+ *
+ * @note Test TGROUP-2
+ *
+ * @return true if each call was served by the car nearest to it.
+ */
+bool group_tests_check_calls_are_shared() {
+    group_tests_start((const int[]) {1, 3, 4});
+    bool result = group_tests_run_until_idle();
+
+    group_tests_press(1, 0, HARDWARE_ORDER_UP);
+    group_tests_press(2, 5, HARDWARE_ORDER_DOWN);
+    result = result && group_tests_run_until_idle();
+
+    result = result && m_group_tests_cars[0].has_opened_door_at[0] && !m_group_tests_cars[0].has_opened_door_at[5];
+    result = result && m_group_tests_cars[2].has_opened_door_at[5] && !m_group_tests_cars[2].has_opened_door_at[0];
+    result = result && !m_group_tests_cars[1].has_moved;
+
+    group_deinit(&m_group_tests_group);
+    return result;
+}
+
+/**
+ * @brief Checks that stopping a car hands its hall calls to another car, which serves them, and drops its cab calls,
+ *        while the hall call of another car is kept. The lights of the hall calls stay lit until they are served.
+ *
+ * @note Test TGROUP-3
+ *
+ * @return true if the hall calls of the stopped car were served by another car.
+ */
+bool group_tests_check_stop_hands_calls_over() {
+    const Dispatcher* p_dispatcher = &m_group_tests_group.dispatcher;
+
+    group_tests_start((const int[]) {0, 3, 5});
+    bool result = group_tests_run_until_idle();
+
+    group_tests_press(0, 1, HARDWARE_ORDER_UP);
+    group_tests_press(0, 4, HARDWARE_ORDER_DOWN);
+    result = result && group_tests_step();
+
+    const int kept_car = dispatcher_get_hall_call_car(p_dispatcher, 1, HARDWARE_ORDER_UP);
+    const int stopped_car = dispatcher_get_hall_call_car(p_dispatcher, 4, HARDWARE_ORDER_DOWN);
+    result = result && kept_car == 0 && stopped_car != DISPATCHER_NO_CAR && stopped_car != kept_car;
+
+    group_tests_press(stopped_car, 0, HARDWARE_ORDER_INSIDE);
+    result = result && group_tests_step();
+    result = result && p_dispatcher->cars[stopped_car].cab_calls[0];
+
+    m_group_tests_cars[stopped_car].stop_button = true;
+    result = result && group_tests_step();
+    result = result && !p_dispatcher->cars[stopped_car].cab_calls[0];
+
+    result = result && group_tests_step();
+    const int new_car = dispatcher_get_hall_call_car(p_dispatcher, 4, HARDWARE_ORDER_DOWN);
+    result = result && new_car != DISPATCHER_NO_CAR && new_car != stopped_car;
+
+    for (int car = 0; car < GROUP_TESTS_NUMBER_OF_CARS; car++) {
+        result = result && group_tests_light_is_on(&m_group_tests_cars[car], 4, HARDWARE_ORDER_DOWN) &&
+                 group_tests_light_is_on(&m_group_tests_cars[car], 1, HARDWARE_ORDER_UP);
+    }
+
+    result = result && group_tests_run_until_idle();
+    result = result && m_group_tests_cars[kept_car].has_opened_door_at[1];
+    result = result && m_group_tests_cars[new_car].has_opened_door_at[4];
+    result = result && !m_group_tests_cars[stopped_car].has_opened_door_at[4];
+    result = result && !m_group_tests_cars[stopped_car].has_opened_door_at[0];
+
+    group_deinit(&m_group_tests_group);
+    return result;
+}
+
+/**
+ * @brief Checks that a hall call at the floor of a stopped car goes to an idle car further away, which serves it,
+ *        and that a cab call made in the stopped car is not counted by the dispatcher.
+ *
+ * @note Test TGROUP-4
+ *
+ * @return true if the idle car served the call, and the stopped car never moved.
+ */
+bool group_tests_check_stopped_car_gets_no_calls() {
+    const Dispatcher* p_dispatcher = &m_group_tests_group.dispatcher;
+
+    group_tests_start((const int[]) {2, 5, 4});
+    bool result = group_tests_run_until_idle();
+
+    m_group_tests_cars[0].stop_button = true;
+    result = result && group_tests_step();
+
+    m_group_tests_cars[0].stop_button = true;
+    group_tests_press(1, 2, HARDWARE_ORDER_UP);
+    group_tests_press(0, 4, HARDWARE_ORDER_INSIDE);
+    result = result && group_tests_step();
+
+    result = result && dispatcher_get_hall_call_car(p_dispatcher, 2, HARDWARE_ORDER_UP) == 2;
+    result = result && !p_dispatcher->cars[0].cab_calls[4];
+
+    for (int step = 0; step < GROUP_TESTS_MAX_NUMBER_OF_STEPS && !m_group_tests_cars[2].has_opened_door_at[2];
+         step++) {
+        m_group_tests_cars[0].stop_button = true;
+        result = result && group_tests_step();
+    }
+
+    result = result && group_tests_run_until_idle();
+    result = result && m_group_tests_cars[2].has_opened_door_at[2];
+    result = result && !m_group_tests_cars[0].has_moved && !m_group_tests_cars[1].has_moved;
+
+    group_deinit(&m_group_tests_group);
+    return result;
+}
+
+/**
+ * @brief Checks that a hall call made while every car is still starting up, between floors, is kept lit and served
+ *        once a car has found its floor.
+ *
+ * @note Test TGROUP-5
+ *
+ * @return true if the call was served.
+ */
+bool group_tests_check_call_before_cars_know_floor() {
+    group_tests_start((const int[]) {1, 3, 4});
+    for (int car = 0; car < GROUP_TESTS_NUMBER_OF_CARS; car++) {
+        m_group_tests_cars[car].height += GROUP_TESTS_STEPS_PER_FLOOR / 2;
+    }
+
+    group_tests_press(0, 3, HARDWARE_ORDER_DOWN);
+    bool result = group_tests_step();
+    result = result && dispatcher_hall_light_is_on(&m_group_tests_group.dispatcher, 3, HARDWARE_ORDER_DOWN);
+
+    result = result && group_tests_run_until_idle();
+
+    bool is_served = false;
+    for (int car = 0; car < GROUP_TESTS_NUMBER_OF_CARS; car++) {
+        is_served = is_served || m_group_tests_cars[car].has_opened_door_at[3];
+    }
+
+    group_deinit(&m_group_tests_group);
+    return result && is_served;
+}
+
+void group_tests_validate() {
+    printf("=========== Starting Group tests ===========\n\n");
+    printf("1. Test that a hall call goes to the nearest car, and a cab call stays with its car\n");
+    assert(group_tests_check_hall_call_goes_to_nearest_car());
+    printf("1. Passed\n");
+    printf("\n");
+
+    printf("2. Test that calls at both ends of the building are shared between the cars\n");
+    assert(group_tests_check_calls_are_shared());
+    printf("2. Passed\n");
+    printf("\n");
+
+    printf("3. Test that stopping a car hands its hall calls to another car\n");
+    assert(group_tests_check_stop_hands_calls_over());
+    printf("3. Passed\n");
+    printf("\n");
+
+    printf("4. Test that a stopped car gets no hall calls, even at its own floor\n");
+    assert(group_tests_check_stopped_car_gets_no_calls());
+    printf("4. Passed\n");
+    printf("\n");
+
+    printf("5. Test that a hall call made before any car knows its floor is served\n");
+    assert(group_tests_check_call_before_cars_know_floor());
+    printf("5. Passed\n");
+    printf("\n");
+
+    printf("================== Group test complete =================\n");
+
+    return;
+}
@@ -0,0 +1,15 @@
+/**
+ * @file 
+ * 
+ * @brief Tests for the group of cars. 
+ */
+
+#ifndef GROUP_TESTS_H
+#define GROUP_TESTS_H
+
+/**
+ * @brief Validates the result of all the tests of Group 
+ */
+void group_tests_validate();
+
+#endif
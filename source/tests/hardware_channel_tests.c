@@ -0,0 +1,253 @@
+/**
+ * @file
+ *
+ * @brief Implementation of the hardware channel tests module.
+ */
+
+#include "hardware_channel_tests.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "hardware_channel.h"
+
+/**
+ * @brief Number of commands or snapshots passed between the threads of a test.
+ */
+#define HARDWARE_CHANNEL_TESTS_NUMBER_OF_TRANSFERS 200000
+
+/**
+ * @brief The ring under test, shared with the producer thread.
+ */
+static HardwareCommandRing m_hardware_channel_tests_ring;
+
+/**
+ * @brief The seqlock under test, shared with the writer thread.
+ */
+static HardwareSnapshotSeqlock m_hardware_channel_tests_seqlock;
+
+/**
+ * @brief Set by the writer thread once it has written its last snapshot.
+ */
+static atomic_bool m_hardware_channel_tests_is_writer_done;
+
+/**
+ * @brief Gets the command numbered @p number, with every field derived from the number.
+ *
+ * @param[in] number The number.
+ *
+ * @return The command.
+ */
+static HardwareCommand hardware_channel_tests_command(const int number) {
+    return (HardwareCommand) {
+        .type = (uint8_t)(number % (HARDWARE_COMMAND_STOP_LIGHT + 1)),
+        .order_type = (uint8_t)(number % HARDWARE_NUMBER_OF_BUTTONS),
+        .value = (uint8_t)(number & 1),
+        .floor = number,
+    };
+}
+
+/**
+ * @brief Checks that @p p_command is the command numbered @p number.
+ *
+ * @param[in] p_command The command.
+ * @param[in] number The number.
+ *
+ * @return true if it is.
+ */
+static bool hardware_channel_tests_is_command(const HardwareCommand* p_command, const int number) {
+    const HardwareCommand expected = hardware_channel_tests_command(number);
+
+    return p_command->type == expected.type && p_command->order_type == expected.order_type &&
+           p_command->value == expected.value && p_command->floor == expected.floor;
+}
+
+/**
+ * @brief Pushes the numbered commands to the ring under test, publishing them in batches of varying size.
+ *
+ * @param[in] p_argument Unused.
+ *
+ * @return NULL.
+ */
+static void* hardware_channel_tests_produce(void* p_argument) {
+    (void)p_argument;
+
+    for (int number = 0; number < HARDWARE_CHANNEL_TESTS_NUMBER_OF_TRANSFERS; number++) {
+        const HardwareCommand command = hardware_channel_tests_command(number);
+        while (!hardware_command_ring_push(&m_hardware_channel_tests_ring, &command)) {
+            hardware_command_ring_publish(&m_hardware_channel_tests_ring);
+        }
+
+        if (number % 7 == 0) {
+            hardware_command_ring_publish(&m_hardware_channel_tests_ring);
+        }
+    }
+    hardware_command_ring_publish(&m_hardware_channel_tests_ring);
+
+    return NULL;
+}
+
+/**
+ * @brief Writes snapshots to the seqlock under test, with every input of snapshot @c n set from @c n.
+ *
+ * @param[in] p_argument Unused.
+ *
+ * @return NULL.
+ */
+static void* hardware_channel_tests_write_snapshots(void* p_argument) {
+    (void)p_argument;
+
+    HardwareSnapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    for (int number = 1; number <= HARDWARE_CHANNEL_TESTS_NUMBER_OF_TRANSFERS; number++) {
+        for (int word = 0; word < HARDWARE_NUMBER_OF_ORDER_WORDS; word++) {
+            snapshot.orders[word] = (uint64_t)number;
+        }
+        snapshot.floor = number;
+        snapshot.stop_signal = number;
+        snapshot.obstruction_signal = number;
+
+        hardware_snapshot_seqlock_write(&m_hardware_channel_tests_seqlock, &snapshot);
+    }
+
+    atomic_store(&m_hardware_channel_tests_is_writer_done, true);
+
+    return NULL;
+}
+
+/**
+ * @brief Checks that commands are only seen once published, come out in order, and that a full ring refuses more.
+ *
+ * @note Test TCHANNEL-1
+ *
+ * @return true if the ring behaves as expected.
+ */
+bool hardware_channel_tests_check_ring() {
+    hardware_command_ring_init(&m_hardware_channel_tests_ring);
+    HardwareCommand command;
+
+    if (hardware_command_ring_publish(&m_hardware_channel_tests_ring) ||
+        hardware_command_ring_pop(&m_hardware_channel_tests_ring, &command)) {
+        return false;
+    }
+
+    for (int number = 0; number < HARDWARE_COMMAND_RING_CAPACITY; number++) {
+        const HardwareCommand pushed = hardware_channel_tests_command(number);
+        if (!hardware_command_ring_push(&m_hardware_channel_tests_ring, &pushed)) {
+            return false;
+        }
+    }
+
+    const HardwareCommand extra = hardware_channel_tests_command(HARDWARE_COMMAND_RING_CAPACITY);
+    if (hardware_command_ring_push(&m_hardware_channel_tests_ring, &extra) ||
+        hardware_command_ring_pop(&m_hardware_channel_tests_ring, &command) ||
+        !hardware_command_ring_publish(&m_hardware_channel_tests_ring)) {
+        return false;
+    }
+
+    for (int number = 0; number < HARDWARE_COMMAND_RING_CAPACITY; number++) {
+        if (!hardware_command_ring_pop(&m_hardware_channel_tests_ring, &command) ||
+            !hardware_channel_tests_is_command(&command, number)) {
+            return false;
+        }
+    }
+
+    return !hardware_command_ring_pop(&m_hardware_channel_tests_ring, &command) &&
+           hardware_command_ring_push(&m_hardware_channel_tests_ring, &extra);
+}
+
+/**
+ * @brief Checks that commands pushed on one thread are popped on another, all of them and in order.
+ *
+ * @note Test TCHANNEL-2
+ *
+ * @return true if every command arrived in order.
+ */
+bool hardware_channel_tests_check_ring_threads() {
+    hardware_command_ring_init(&m_hardware_channel_tests_ring);
+
+    pthread_t producer;
+    if (pthread_create(&producer, NULL, hardware_channel_tests_produce, NULL) != 0) {
+        return false;
+    }
+
+    bool is_in_order = true;
+    for (int number = 0; number < HARDWARE_CHANNEL_TESTS_NUMBER_OF_TRANSFERS; number++) {
+        HardwareCommand command;
+        while (!hardware_command_ring_pop(&m_hardware_channel_tests_ring, &command)) {
+        }
+        is_in_order = is_in_order && hardware_channel_tests_is_command(&command, number);
+    }
+
+    pthread_join(producer, NULL);
+
+    return is_in_order;
+}
+
+/**
+ * @brief Checks that a reader racing a writer only ever gets whole snapshots, never older than the previous one.
+ *
+ * @note Test TCHANNEL-3
+ *
+ * @return true if no snapshot was torn.
+ */
+bool hardware_channel_tests_check_seqlock() {
+    HardwareSnapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    hardware_snapshot_seqlock_init(&m_hardware_channel_tests_seqlock, &snapshot);
+    atomic_store(&m_hardware_channel_tests_is_writer_done, false);
+
+    pthread_t writer;
+    if (pthread_create(&writer, NULL, hardware_channel_tests_write_snapshots, NULL) != 0) {
+        return false;
+    }
+
+    bool is_whole = true;
+    int last_number = 0;
+    uint64_t last_version = 0;
+    bool is_writer_done = false;
+    while (!is_writer_done) {
+        is_writer_done = atomic_load(&m_hardware_channel_tests_is_writer_done);
+        const uint64_t version = hardware_snapshot_seqlock_read(&m_hardware_channel_tests_seqlock, &snapshot);
+
+        const int number = snapshot.floor;
+        for (int word = 0; word < HARDWARE_NUMBER_OF_ORDER_WORDS; word++) {
+            is_whole = is_whole && snapshot.orders[word] == (uint64_t)number;
+        }
+        is_whole = is_whole && snapshot.stop_signal == number && snapshot.obstruction_signal == number &&
+                   version == (uint64_t)number && number >= last_number && version >= last_version;
+
+        last_number = number;
+        last_version = version;
+    }
+
+    pthread_join(writer, NULL);
+
+    return is_whole && last_number == HARDWARE_CHANNEL_TESTS_NUMBER_OF_TRANSFERS;
+}
+
+void hardware_channel_tests_validate() {
+    printf("=========== Starting Hardware channel tests ===========\n\n");
+    printf("1. Test that the command ring publishes its commands in order\n");
+    assert(hardware_channel_tests_check_ring());
+    printf("1. Passed\n");
+    printf("\n");
+
+    printf("2. Test that commands pass between two threads in order\n");
+    assert(hardware_channel_tests_check_ring_threads());
+    printf("2. Passed\n");
+    printf("\n");
+
+    printf("3. Test that a reader racing the writer only gets whole snapshots\n");
+    assert(hardware_channel_tests_check_seqlock());
+    printf("3. Passed\n");
+    printf("\n");
+
+    printf("================== Hardware channel test complete =================\n");
+
+    return;
+}
@@ -0,0 +1,15 @@
+/**
+ * @file
+ * 
+ * @brief Tests for the hardware channels.
+ */
+
+#ifndef HARDWARE_CHANNEL_TESTS_H
+#define HARDWARE_CHANNEL_TESTS_H
+
+/**
+ * @brief Validates the result of all the tests of the hardware channels
+ */
+void hardware_channel_tests_validate();
+
+#endif
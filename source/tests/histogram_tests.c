@@ -0,0 +1,136 @@
+/**
+ * @file 
+ * 
+ * @brief Implementation of the histogram tests module.
+ */
+
+#include "histogram_tests.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "histogram.h"
+
+/**
+ * @brief The histogram under test, too large for the stack of a test.
+ */
+static Histogram m_histogram_tests_histogram;
+
+/**
+ * @brief Checks that @p reported is @p value, reported to within the precision of a histogram.
+ *
+ * @param[in] reported The value reported by the histogram.
+ * @param[in] value The value recorded.
+ *
+ * @return true if @p reported is no lower than @p value and at most one sub-bucket higher.
+ */
+static bool histogram_tests_is_within_precision(const uint64_t reported, const uint64_t value) {
+    return reported >= value && reported - value <= value / HISTOGRAM_SUB_BUCKET_COUNT;
+}
+
+/**
+ * @brief Checks that small values are kept exactly, and that larger values are reported no lower than recorded and at
+ *        most one sub-bucket higher, all the way up to the largest 64 bit value.
+ *
+ * @note Test THISTOGRAM-1
+ *
+ * @return true if every value is within the precision of the histogram.
+ */
+bool histogram_tests_check_precision() {
+    for (uint64_t value = 0; value < 1000; value++) {
+        histogram_reset(&m_histogram_tests_histogram);
+        histogram_record(&m_histogram_tests_histogram, value);
+        histogram_record(&m_histogram_tests_histogram, UINT64_MAX);
+
+        const uint64_t reported = histogram_value_at_percentile(&m_histogram_tests_histogram, 50.0);
+        if (value < HISTOGRAM_SUB_BUCKET_COUNT ? reported != value
+                                               : !histogram_tests_is_within_precision(reported, value)) {
+            return false;
+        }
+    }
+
+    for (int bit = 0; bit < 64; bit++) {
+        const uint64_t value = (UINT64_C(1) << bit) + (UINT64_C(1) << bit) / 3;
+
+        histogram_reset(&m_histogram_tests_histogram);
+        histogram_record(&m_histogram_tests_histogram, value);
+        histogram_record(&m_histogram_tests_histogram, UINT64_MAX);
+
+        const uint64_t reported = histogram_value_at_percentile(&m_histogram_tests_histogram, 50.0);
+        if (!histogram_tests_is_within_precision(reported, value)) {
+            return false;
+        }
+    }
+
+    histogram_reset(&m_histogram_tests_histogram);
+    histogram_record(&m_histogram_tests_histogram, UINT64_MAX);
+
+    return histogram_value_at_percentile(&m_histogram_tests_histogram, 100.0) == UINT64_MAX;
+}
+
+/**
+ * @brief Checks the percentiles, the mean and the extremes of the values 1 to 1000.
+ *
+ * @note Test THISTOGRAM-2
+ *
+ * @return true if the percentiles are within the precision of the histogram, and the rest is exact.
+ */
+bool histogram_tests_check_percentiles() {
+    histogram_reset(&m_histogram_tests_histogram);
+    for (uint64_t value = 1; value <= 1000; value++) {
+        histogram_record(&m_histogram_tests_histogram, value);
+    }
+
+    const double percentiles[] = {0.0, 10.0, 50.0, 90.0, 99.0, 99.9, 100.0};
+    const uint64_t expected_values[] = {1, 100, 500, 900, 990, 999, 1000};
+
+    for (size_t i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); i++) {
+        const uint64_t value = histogram_value_at_percentile(&m_histogram_tests_histogram, percentiles[i]);
+        if (!histogram_tests_is_within_precision(value, expected_values[i])) {
+            return false;
+        }
+    }
+
+    return m_histogram_tests_histogram.total_count == 1000 && m_histogram_tests_histogram.min == 1 &&
+           m_histogram_tests_histogram.max == 1000 && histogram_mean(&m_histogram_tests_histogram) == 500.5;
+}
+
+/**
+ * @brief Checks that a histogram without values reports 0, also after values have been recorded and removed.
+ *
+ * @note Test THISTOGRAM-3
+ *
+ * @return true if the empty histogram reports 0.
+ */
+bool histogram_tests_check_reset() {
+    histogram_reset(&m_histogram_tests_histogram);
+    histogram_record(&m_histogram_tests_histogram, 42);
+    histogram_reset(&m_histogram_tests_histogram);
+
+    return m_histogram_tests_histogram.total_count == 0 &&
+           histogram_value_at_percentile(&m_histogram_tests_histogram, 50.0) == 0 &&
+           histogram_mean(&m_histogram_tests_histogram) == 0.0;
+}
+
+void histogram_tests_validate() {
+    printf("=========== Starting Histogram tests ===========\n\n");
+    printf("1. Test that values are kept within the precision of the histogram\n");
+    assert(histogram_tests_check_precision());
+    printf("1. Passed\n");
+    printf("\n");
+
+    printf("2. Test the percentiles, the mean and the extremes\n");
+    assert(histogram_tests_check_percentiles());
+    printf("2. Passed\n");
+    printf("\n");
+
+    printf("3. Test that an empty histogram reports 0\n");
+    assert(histogram_tests_check_reset());
+    printf("3. Passed\n");
+    printf("\n");
+
+    printf("================== Histogram test complete =================\n");
+
+    return;
+}
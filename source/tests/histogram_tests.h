@@ -0,0 +1,15 @@
+/**
+ * @file
+ * 
+ * @brief Tests for the histograms of the metrics.
+ */
+
+#ifndef HISTOGRAM_TESTS_H
+#define HISTOGRAM_TESTS_H
+
+/**
+ * @brief Validates the result of all the tests of Histogram
+ */
+void histogram_tests_validate();
+
+#endif
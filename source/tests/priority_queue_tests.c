@@ -12,6 +12,11 @@
 
 #include "priority_queue.h"
 
+/**
+ * @brief Number of queues held at the same time by #priority_queue_tests_check_many_queues.
+ */
+#define PRIORITY_QUEUE_TESTS_NUMBER_OF_QUEUES 100
+
 /**
  * @brief Checks that order creation is set up correctly. 
  * 
@@ -166,6 +171,190 @@ void priority_queue_tests_check_queue_help_functions() {
     return;
 }
 
+/**
+ * @brief Checks that orders on the way to the oldest order are served first, and that the oldest order is served
+ *        after them.
+ *
+ * @note TEST TQUEUE-3
+ *
+ * @return true if the orders were served in the expected sequence.
+ */
+bool priority_queue_tests_check_serving_sequence() {
+    const Position current_position = {0, OFFSET_AT_FLOOR};
+    bool result = true;
+
+    Order* p_queue = priority_queue_add_order(priority_queue_order_create(3, HARDWARE_ORDER_INSIDE), NULL, current_position);
+    p_queue = priority_queue_add_order(priority_queue_order_create(2, HARDWARE_ORDER_DOWN), p_queue, current_position);
+    p_queue = priority_queue_add_order(priority_queue_order_create(1, HARDWARE_ORDER_UP), p_queue, current_position);
+    result = result && p_queue->floor == 1;
+
+    p_queue = priority_queue_pop(p_queue);
+    p_queue = priority_queue_reorder_based_on_position(p_queue, (Position){1, OFFSET_AT_FLOOR});
+    result = result && p_queue->floor == 3;
+
+    p_queue = priority_queue_pop(p_queue);
+    p_queue = priority_queue_reorder_based_on_position(p_queue, (Position){3, OFFSET_AT_FLOOR});
+    result = result && p_queue->floor == 2;
+
+    p_queue = priority_queue_pop(p_queue);
+    result = result && priority_queue_is_empty(p_queue);
+
+    priority_queue_clear(p_queue);
+    return result;
+}
+
+/**
+ * @brief Checks that an old order far away is served while new orders keep arriving close to the elevator. The
+ *        elevator first serves an older order next to it, and then new orders arrive behind it and in front of it
+ *        going the other way at every stop. None of them are on the way, so the far order must be the next stop.
+ *
+ * @note TEST TQUEUE-4
+ *
+ * @return true if the far order was served right after the first order.
+ */
+bool priority_queue_tests_check_far_order_is_served() {
+    const int far_floor = 9;
+    Position current_position = {2, OFFSET_AT_FLOOR};
+
+    Order* p_queue = priority_queue_add_order(priority_queue_order_create(1, HARDWARE_ORDER_INSIDE), NULL,
+                                              current_position);
+    p_queue = priority_queue_add_order(priority_queue_order_create(far_floor, HARDWARE_ORDER_INSIDE), p_queue,
+                                       current_position);
+
+    int number_of_stops = 0;
+    bool is_far_order_served = false;
+    while (number_of_stops < 2 * far_floor && !is_far_order_served) {
+        p_queue = priority_queue_reorder_based_on_position(p_queue, current_position);
+        current_position = (Position){p_queue->floor, OFFSET_AT_FLOOR};
+        is_far_order_served = p_queue->floor == far_floor;
+        number_of_stops++;
+
+        // Orders made while the elevator stops, behind it and in front of it going the other way
+        const int floor = current_position.floor;
+        if (floor > 0) {
+            p_queue = priority_queue_add_order(priority_queue_order_create(floor - 1, HARDWARE_ORDER_INSIDE), p_queue,
+                                               current_position);
+        }
+        if (floor + 2 < far_floor) {
+            p_queue = priority_queue_add_order(priority_queue_order_create(floor + 2, HARDWARE_ORDER_DOWN), p_queue,
+                                               current_position);
+        }
+
+        p_queue = priority_queue_pop(p_queue);
+    }
+
+    priority_queue_clear(p_queue);
+    return is_far_order_served && number_of_stops == 2;
+}
+
+/**
+ * @brief Makes the queue used by the reorder tests, made at the third floor with the oldest order going to the
+ *        ground floor: inside order to 2, inside order to 0, down from 4 and up from 1.
+ *
+ * @return The queue.
+ */
+static Order* priority_queue_tests_make_reorder_queue() {
+    const Position current_position = {3, OFFSET_AT_FLOOR};
+
+    Order* p_queue = priority_queue_add_order(priority_queue_order_create(0, HARDWARE_ORDER_INSIDE), NULL, current_position);
+    p_queue = priority_queue_add_order(priority_queue_order_create(4, HARDWARE_ORDER_DOWN), p_queue, current_position);
+    p_queue = priority_queue_add_order(priority_queue_order_create(1, HARDWARE_ORDER_UP), p_queue, current_position);
+    p_queue = priority_queue_add_order(priority_queue_order_create(2, HARDWARE_ORDER_INSIDE), p_queue, current_position);
+
+    return p_queue;
+}
+
+/**
+ * @brief Checks that the orders of @p p_queue are on @p p_expected_floors, in that order. The bitset backend only
+ *        links the next stop, so there only the first floor is compared.
+ *
+ * @param[in] p_queue The queue.
+ * @param[in] p_expected_floors The expected floors, one per order.
+ * @param[in] number_of_orders Number of expected floors.
+ *
+ * @return true if the orders are in the expected order.
+ */
+static bool priority_queue_tests_has_floors(const Order* p_queue,
+                                            const int* p_expected_floors,
+                                            const int number_of_orders) {
+    int index = 0;
+    for (const Order* p_order = p_queue; p_order; p_order = p_order->next_order, index++) {
+        if (index >= number_of_orders || p_order->floor != p_expected_floors[index]) {
+            return false;
+        }
+    }
+
+    return priority_queue_length(p_queue) == number_of_orders && (index == number_of_orders || index == 1);
+}
+
+/**
+ * @brief Checks the order of a queue reordered at and between floors, and that a second reorder at the same position
+ *        is skipped. The queue is made at the third floor on the way down, and the down order from 4 is not on the
+ *        way from there. Reordered above the fourth floor or at the fifth it is, and moves to the front.
+ *
+ * @note TEST TQUEUE-5
+ *
+ * @return true if every reorder gave the expected order.
+ */
+bool priority_queue_tests_check_reorder() {
+    bool result = true;
+
+    Order* p_queue = priority_queue_tests_make_reorder_queue();
+    result = result && priority_queue_tests_has_floors(p_queue, (const int[]) {2, 0, 4, 1}, 4);
+    p_queue = priority_queue_clear(p_queue);
+
+    p_queue = priority_queue_reorder_based_on_position(priority_queue_tests_make_reorder_queue(),
+                                                       (Position){5, OFFSET_AT_FLOOR});
+    result = result && priority_queue_tests_has_floors(p_queue, (const int[]) {4, 2, 0, 1}, 4);
+    p_queue = priority_queue_clear(p_queue);
+
+    p_queue = priority_queue_reorder_based_on_position(priority_queue_tests_make_reorder_queue(),
+                                                       (Position){4, OFFSET_BELOW});
+    result = result && priority_queue_tests_has_floors(p_queue, (const int[]) {2, 0, 4, 1}, 4);
+    p_queue = priority_queue_clear(p_queue);
+
+    const Position between_floors = {4, OFFSET_ABOVE};
+    p_queue = priority_queue_reorder_based_on_position(priority_queue_tests_make_reorder_queue(), between_floors);
+    result = result && priority_queue_tests_has_floors(p_queue, (const int[]) {4, 2, 0, 1}, 4);
+
+    // A reorder which is skipped leaves the queue untouched, so a mark left on the top order survives it
+    const bool is_oldest_order = p_queue->is_oldest_order;
+    p_queue->is_oldest_order = !is_oldest_order;
+    Order* p_skipped_queue = priority_queue_reorder_based_on_position(p_queue, between_floors);
+    result = result && p_skipped_queue == p_queue && p_queue->is_oldest_order == !is_oldest_order;
+    p_queue->is_oldest_order = is_oldest_order;
+
+    priority_queue_clear(p_queue);
+    return result;
+}
+
+/**
+ * @brief Checks that many queues hold their orders at the same time, as when one thread steps many elevators.
+ *
+ * @note TEST TQUEUE-6
+ *
+ * @return true if every queue kept all of its orders.
+ */
+bool priority_queue_tests_check_many_queues() {
+    const Position current_position = {0, OFFSET_AT_FLOOR};
+    Order* queues[PRIORITY_QUEUE_TESTS_NUMBER_OF_QUEUES];
+    bool result = true;
+
+    for (int i = 0; i < PRIORITY_QUEUE_TESTS_NUMBER_OF_QUEUES; i++) {
+        queues[i] = priority_queue_add_order(priority_queue_order_create(i % 8 + 1, HARDWARE_ORDER_INSIDE), NULL,
+                                             current_position);
+        queues[i] = priority_queue_add_order(priority_queue_order_create(i % 8 + 2, HARDWARE_ORDER_DOWN), queues[i],
+                                             current_position);
+    }
+
+    for (int i = 0; i < PRIORITY_QUEUE_TESTS_NUMBER_OF_QUEUES; i++) {
+        result = result && priority_queue_length(queues[i]) == 2 && queues[i]->floor == i % 8 + 1;
+        queues[i] = priority_queue_clear(queues[i]);
+    }
+
+    return result;
+}
+
 void priority_queue_tests_validate() {
     printf("=========== Starting Queue tests ===========\n\n");
     printf("1. Test that makeorder() works\n");
@@ -191,6 +380,26 @@ void priority_queue_tests_validate() {
     priority_queue_tests_check_queue_help_functions();
     printf("5. End\n");
 
+    printf("6. Test that orders on the way are served before the oldest order\n");
+    assert(priority_queue_tests_check_serving_sequence());
+    printf("6. Passed\n");
+    printf("\n");
+
+    printf("7. Test that an old order far away is served while new orders keep arriving nearby\n");
+    assert(priority_queue_tests_check_far_order_is_served());
+    printf("7. Passed\n");
+    printf("\n");
+
+    printf("8. Test that a reorder moves the orders on the way, and is skipped at the same position\n");
+    assert(priority_queue_tests_check_reorder());
+    printf("8. Passed\n");
+    printf("\n");
+
+    printf("9. Test that many queues hold their orders at the same time\n");
+    assert(priority_queue_tests_check_many_queues());
+    printf("9. Passed\n");
+    printf("\n");
+
     printf("================== Queue test complete =================\n");
 
     return;
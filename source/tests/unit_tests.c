@@ -10,8 +10,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "dispatcher_tests.h"
 #include "door_tests.h"
+#include "event_log_tests.h"
+#include "fsm_tests.h"
+#include "group_tests.h"
 #include "hardware.h"
+#include "hardware_channel_tests.h"
+#include "histogram_tests.h"
 #include "priority_queue_tests.h"
 
 /**
@@ -37,4 +43,10 @@ void unit_tests_check() {
 
     door_tests_validate();
     priority_queue_tests_validate();
+    fsm_tests_validate();
+    dispatcher_tests_validate();
+    group_tests_validate();
+    histogram_tests_validate();
+    event_log_tests_validate();
+    hardware_channel_tests_validate();
 }
\ No newline at end of file
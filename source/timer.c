@@ -0,0 +1,220 @@
+/**
+ * @file
+ * @brief Implementation of the timer service.
+ *
+ * The running timers are kept in a binary min-heap on their deadline, so the next deadline is the root and starting,
+ * restarting and cancelling a timer is O(log n). A timer id holds the slot of the timer together with a generation
+ * count, so that an id kept after its timer expired does not refer to a later timer reusing the slot.
+ */
+
+#include "timer.h"
+
+#include <limits.h>
+#include <stddef.h>
+
+/**
+ * @brief Gets the slot of the running timer identified by @p timer_id.
+ *
+ * @param[in] p_service The service.
+ * @param[in] timer_id The timer.
+ *
+ * @return The slot, -1 if the timer is not running.
+ */
+static int timer_get_running_slot(const TimerService* p_service, const TimerId timer_id) {
+    if (timer_id < 0) {
+        return -1;
+    }
+
+    const int slot = timer_id % TIMER_MAX_NUMBER_OF_TIMERS;
+    const Timer* p_timer = &p_service->slots[slot];
+    if (p_timer->heap_index == -1 || p_timer->generation != timer_id / TIMER_MAX_NUMBER_OF_TIMERS) {
+        return -1;
+    }
+
+    return slot;
+}
+
+/**
+ * @brief Gets the running timer identified by @p timer_id.
+ *
+ * @param[in] p_service The service.
+ * @param[in] timer_id The timer.
+ *
+ * @return The timer, NULL if it is not running.
+ */
+static Timer* timer_get_running(TimerService* p_service, const TimerId timer_id) {
+    const int slot = timer_get_running_slot(p_service, timer_id);
+    return slot == -1 ? NULL : &p_service->slots[slot];
+}
+
+/**
+ * @brief Checks if the timer in @p first_slot expires before the one in @p second_slot.
+ *
+ * @param[in] p_service The service.
+ * @param[in] first_slot Slot of the first timer.
+ * @param[in] second_slot Slot of the second timer.
+ *
+ * @return true if the first timer expires first.
+ */
+static bool timer_expires_before(const TimerService* p_service, const int first_slot, const int second_slot) {
+    const Timer* p_first = &p_service->slots[first_slot];
+    const Timer* p_second = &p_service->slots[second_slot];
+
+    if (p_first->deadline_ms != p_second->deadline_ms) {
+        return p_first->deadline_ms < p_second->deadline_ms;
+    }
+
+    return p_first->sequence < p_second->sequence;
+}
+
+/**
+ * @brief Places @p slot at @p heap_index in the heap.
+ *
+ * @param[in, out] p_service The service.
+ * @param[in] heap_index Position in the heap.
+ * @param[in] slot The slot to place.
+ */
+static void timer_heap_place(TimerService* p_service, const int heap_index, const int slot) {
+    p_service->heap[heap_index] = slot;
+    p_service->slots[slot].heap_index = heap_index;
+}
+
+/**
+ * @brief Restores the heap order around @p heap_index after the deadline of the timer there changed, by moving it
+ *        up or down.
+ *
+ * @param[in, out] p_service The service.
+ * @param[in] heap_index Position of the changed timer in the heap.
+ */
+static void timer_heap_fix(TimerService* p_service, int heap_index) {
+    const int slot = p_service->heap[heap_index];
+
+    while (heap_index > 0) {
+        const int parent_index = (heap_index - 1) / 2;
+        if (!timer_expires_before(p_service, slot, p_service->heap[parent_index])) {
+            break;
+        }
+        timer_heap_place(p_service, heap_index, p_service->heap[parent_index]);
+        heap_index = parent_index;
+    }
+
+    while (true) {
+        int child_index = 2 * heap_index + 1;
+        if (child_index >= p_service->number_of_running) {
+            break;
+        }
+        if (child_index + 1 < p_service->number_of_running &&
+            timer_expires_before(p_service, p_service->heap[child_index + 1], p_service->heap[child_index])) {
+            child_index++;
+        }
+        if (!timer_expires_before(p_service, p_service->heap[child_index], slot)) {
+            break;
+        }
+        timer_heap_place(p_service, heap_index, p_service->heap[child_index]);
+        heap_index = child_index;
+    }
+
+    timer_heap_place(p_service, heap_index, slot);
+}
+
+/**
+ * @brief Takes @p p_timer out of the heap and frees its slot.
+ *
+ * @param[in, out] p_service The service.
+ * @param[in, out] p_timer The timer, must be running.
+ */
+static void timer_remove(TimerService* p_service, Timer* p_timer) {
+    const int heap_index = p_timer->heap_index;
+    p_timer->heap_index = -1;
+
+    p_service->number_of_running--;
+    if (heap_index < p_service->number_of_running) {
+        timer_heap_place(p_service, heap_index, p_service->heap[p_service->number_of_running]);
+        timer_heap_fix(p_service, heap_index);
+    }
+}
+
+void timer_service_init(TimerService* p_service) {
+    for (int slot = 0; slot < TIMER_MAX_NUMBER_OF_TIMERS; slot++) {
+        p_service->slots[slot].heap_index = -1;
+        p_service->slots[slot].generation = 0;
+    }
+
+    p_service->number_of_running = 0;
+    p_service->next_sequence = 0;
+}
+
+TimerId timer_start(TimerService* p_service,
+                    const uint64_t now_ms,
+                    const uint64_t timeout_ms,
+                    const TimerCallback callback,
+                    void* p_context) {
+    int slot = 0;
+    while (slot < TIMER_MAX_NUMBER_OF_TIMERS && p_service->slots[slot].heap_index != -1) {
+        slot++;
+    }
+
+    if (slot == TIMER_MAX_NUMBER_OF_TIMERS) {
+        return TIMER_ID_INVALID;
+    }
+
+    Timer* p_timer = &p_service->slots[slot];
+    p_timer->deadline_ms = now_ms + timeout_ms;
+    p_timer->sequence = p_service->next_sequence++;
+    p_timer->callback = callback;
+    p_timer->p_context = p_context;
+    p_timer->generation = (p_timer->generation + 1) % (INT_MAX / TIMER_MAX_NUMBER_OF_TIMERS);
+
+    timer_heap_place(p_service, p_service->number_of_running++, slot);
+    timer_heap_fix(p_service, p_timer->heap_index);
+
+    return p_timer->generation * TIMER_MAX_NUMBER_OF_TIMERS + slot;
+}
+
+bool timer_restart(TimerService* p_service, const TimerId timer_id, const uint64_t now_ms, const uint64_t timeout_ms) {
+    Timer* p_timer = timer_get_running(p_service, timer_id);
+    if (!p_timer) {
+        return false;
+    }
+
+    p_timer->deadline_ms = now_ms + timeout_ms;
+    p_timer->sequence = p_service->next_sequence++;
+    timer_heap_fix(p_service, p_timer->heap_index);
+
+    return true;
+}
+
+void timer_cancel(TimerService* p_service, const TimerId timer_id) {
+    Timer* p_timer = timer_get_running(p_service, timer_id);
+    if (p_timer) {
+        timer_remove(p_service, p_timer);
+    }
+}
+
+bool timer_is_running(const TimerService* p_service, const TimerId timer_id) {
+    return timer_get_running_slot(p_service, timer_id) != -1;
+}
+
+uint64_t timer_next_deadline_ms(const TimerService* p_service) {
+    if (p_service->number_of_running == 0) {
+        return TIMER_NO_DEADLINE;
+    }
+
+    return p_service->slots[p_service->heap[0]].deadline_ms;
+}
+
+void timer_expire(TimerService* p_service, const uint64_t now_ms) {
+    while (p_service->number_of_running > 0) {
+        Timer* p_timer = &p_service->slots[p_service->heap[0]];
+        if (p_timer->deadline_ms > now_ms) {
+            break;
+        }
+
+        // Removed before the callback, which may start a new timer in the same slot
+        const TimerCallback callback = p_timer->callback;
+        void* p_context = p_timer->p_context;
+        timer_remove(p_service, p_timer);
+
+        callback(p_context);
+    }
+}
@@ -0,0 +1,168 @@
+/**
+ * @file
+ * @brief Timer service with millisecond resolution. Timers call a callback when they expire, and the loop can ask for
+ *        the next deadline instead of polling every timeout itself. Every elevator has its own service, and the time is
+ *        passed in by the caller, so services on different clocks can live in the same process.
+ */
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Maximum number of timers running at the same time.
+ */
+#define TIMER_MAX_NUMBER_OF_TIMERS 16
+
+/**
+ * @brief Returned by #timer_start when there is no room for another timer.
+ */
+#define TIMER_ID_INVALID -1
+
+/**
+ * @brief Returned by #timer_next_deadline_ms when no timer is running.
+ */
+#define TIMER_NO_DEADLINE UINT64_MAX
+
+/**
+ * @brief Identifies a running timer.
+ */
+typedef int TimerId;
+
+/**
+ * @brief Called when a timer expires.
+ *
+ * @param[in] p_context The context given to #timer_start.
+ */
+typedef void (*TimerCallback)(void* p_context);
+
+/**
+ * @brief A timer slot.
+ */
+typedef struct {
+    /**
+     * @brief When the timer expires, on the time base of the service.
+     */
+    uint64_t deadline_ms;
+
+    /**
+     * @brief Tie breaker for equal deadlines, so that timers with the same deadline expire in the order they were
+     *        set.
+     */
+    uint64_t sequence;
+
+    TimerCallback callback;
+    void* p_context;
+
+    /**
+     * @brief Position of the timer in the heap, -1 if the slot is free.
+     */
+    int heap_index;
+
+    /**
+     * @brief Bumped every time the slot is used, makes up the id together with the slot.
+     */
+    int generation;
+} Timer;
+
+/**
+ * @brief A set of timers sharing one time base.
+ */
+typedef struct {
+    /**
+     * @brief Timer slots.
+     */
+    Timer slots[TIMER_MAX_NUMBER_OF_TIMERS];
+
+    /**
+     * @brief Heap of the slots of the running timers, earliest deadline at the root.
+     */
+    int heap[TIMER_MAX_NUMBER_OF_TIMERS];
+
+    /**
+     * @brief Number of running timers.
+     */
+    int number_of_running;
+
+    /**
+     * @brief Next sequence number given to a timer when set.
+     */
+    uint64_t next_sequence;
+} TimerService;
+
+/**
+ * @brief Sets up @p p_service with no timers running.
+ *
+ * @param[out] p_service The service.
+ */
+void timer_service_init(TimerService* p_service);
+
+/**
+ * @brief Starts a timer which calls @p callback from #timer_expire once @p timeout_ms has passed.
+ *
+ * @param[in, out] p_service The service.
+ * @param[in] now_ms The current time.
+ * @param[in] timeout_ms Milliseconds until the timer expires.
+ * @param[in] callback Called when the timer expires.
+ * @param[in] p_context Passed to @p callback.
+ *
+ * @return Id of the timer, #TIMER_ID_INVALID if #TIMER_MAX_NUMBER_OF_TIMERS timers are already running.
+ */
+TimerId timer_start(TimerService* p_service,
+                    const uint64_t now_ms,
+                    const uint64_t timeout_ms,
+                    const TimerCallback callback,
+                    void* p_context);
+
+/**
+ * @brief Moves the deadline of a running timer to @p timeout_ms from now.
+ *
+ * @param[in, out] p_service The service.
+ * @param[in] timer_id The timer.
+ * @param[in] now_ms The current time.
+ * @param[in] timeout_ms Milliseconds until the timer expires.
+ *
+ * @return false if the timer is not running, e.g. because it already expired.
+ */
+bool timer_restart(TimerService* p_service, const TimerId timer_id, const uint64_t now_ms, const uint64_t timeout_ms);
+
+/**
+ * @brief Stops a timer without calling its callback. Does nothing if the timer is not running.
+ *
+ * @param[in, out] p_service The service.
+ * @param[in] timer_id The timer.
+ */
+void timer_cancel(TimerService* p_service, const TimerId timer_id);
+
+/**
+ * @brief Checks if a timer is running.
+ *
+ * @param[in] p_service The service.
+ * @param[in] timer_id The timer.
+ *
+ * @return true if the timer has been started and has neither expired nor been cancelled.
+ */
+bool timer_is_running(const TimerService* p_service, const TimerId timer_id);
+
+/**
+ * @brief Gets the earliest deadline of the running timers.
+ *
+ * @param[in] p_service The service.
+ *
+ * @return The deadline, #TIMER_NO_DEADLINE if no timer is running.
+ */
+uint64_t timer_next_deadline_ms(const TimerService* p_service);
+
+/**
+ * @brief Calls the callbacks of the timers which have expired by @p now_ms, earliest deadline first.
+ *
+ * @param[in, out] p_service The service.
+ * @param[in] now_ms The current time.
+ *
+ * @note Callbacks may start, restart and cancel timers.
+ */
+void timer_expire(TimerService* p_service, const uint64_t now_ms);
+
+#endif